@@ -0,0 +1,173 @@
+//
+// Private attribute definitions for the Printer Application Framework
+//
+// Copyright © 2021 by Michael R Sweet.
+//
+// Licensed under Apache License v2.0.  See the file "LICENSE" for more
+// information.
+//
+
+#ifndef _PAPPL_ATTRS_PRIVATE_H_
+#  define _PAPPL_ATTRS_PRIVATE_H_
+
+
+//
+// Include necessary headers...
+//
+
+#  include "base.h"
+#  include <pthread.h>
+
+
+//
+// Macros...
+//
+
+#  define _PAPPL_REQUESTED(ra,id) (!(ra) || ((ra)->bits[(id) / 32] & (1U << ((id) & 31))))
+					// Was the attribute requested?
+
+
+//
+// Types and structures...
+//
+
+typedef enum _pappl_attr_id_e		// Attribute IDs for requested-attributes
+{
+  _PAPPL_ATTR_COPIES_SUPPORTED,
+  _PAPPL_ATTR_DATE_TIME_AT_COMPLETED,
+  _PAPPL_ATTR_DATE_TIME_AT_CREATION,
+  _PAPPL_ATTR_DATE_TIME_AT_PROCESSING,
+  _PAPPL_ATTR_IDENTIFY_ACTIONS_DEFAULT,
+  _PAPPL_ATTR_JOB_IMPRESSIONS,
+  _PAPPL_ATTR_JOB_IMPRESSIONS_COMPLETED,
+  _PAPPL_ATTR_JOB_PRINTER_UP_TIME,
+  _PAPPL_ATTR_JOB_STATE,
+  _PAPPL_ATTR_JOB_STATE_MESSAGE,
+  _PAPPL_ATTR_JOB_STATE_REASONS,
+  _PAPPL_ATTR_LABEL_MODE_CONFIGURED,
+  _PAPPL_ATTR_LABEL_TEAR_OFFSET_CONFIGURED,
+  _PAPPL_ATTR_MARKER_COLORS,
+  _PAPPL_ATTR_MARKER_HIGH_LEVELS,
+  _PAPPL_ATTR_MARKER_LEVELS,
+  _PAPPL_ATTR_MARKER_LOW_LEVELS,
+  _PAPPL_ATTR_MARKER_NAMES,
+  _PAPPL_ATTR_MARKER_TYPES,
+  _PAPPL_ATTR_MEDIA_COL_DEFAULT,
+  _PAPPL_ATTR_MEDIA_COL_READY,
+  _PAPPL_ATTR_MEDIA_DEFAULT,
+  _PAPPL_ATTR_MEDIA_READY,
+  _PAPPL_ATTR_MULTIPLE_DOCUMENT_HANDLING_DEFAULT,
+  _PAPPL_ATTR_ORIENTATION_REQUESTED_DEFAULT,
+  _PAPPL_ATTR_OUTPUT_BIN_DEFAULT,
+  _PAPPL_ATTR_PRINT_COLOR_MODE_DEFAULT,
+  _PAPPL_ATTR_PRINT_CONTENT_OPTIMIZE_DEFAULT,
+  _PAPPL_ATTR_PRINT_QUALITY_DEFAULT,
+  _PAPPL_ATTR_PRINT_SCALING_DEFAULT,
+  _PAPPL_ATTR_PRINTER_CONFIG_CHANGE_DATE_TIME,
+  _PAPPL_ATTR_PRINTER_CONFIG_CHANGE_TIME,
+  _PAPPL_ATTR_PRINTER_CONTACT_COL,
+  _PAPPL_ATTR_PRINTER_CURRENT_TIME,
+  _PAPPL_ATTR_PRINTER_DARKNESS_CONFIGURED,
+  _PAPPL_ATTR_PRINTER_DNS_SD_NAME,
+  _PAPPL_ATTR_PRINTER_FIRMWARE_NAME,
+  _PAPPL_ATTR_PRINTER_FIRMWARE_PATCHES,
+  _PAPPL_ATTR_PRINTER_FIRMWARE_STRING_VERSION,
+  _PAPPL_ATTR_PRINTER_FIRMWARE_VERSION,
+  _PAPPL_ATTR_PRINTER_GEO_LOCATION,
+  _PAPPL_ATTR_PRINTER_ICONS,
+  _PAPPL_ATTR_PRINTER_IMPRESSIONS_COMPLETED,
+  _PAPPL_ATTR_PRINTER_INPUT_TRAY,
+  _PAPPL_ATTR_PRINTER_IS_ACCEPTING_JOBS,
+  _PAPPL_ATTR_PRINTER_LOCATION,
+  _PAPPL_ATTR_PRINTER_MORE_INFO,
+  _PAPPL_ATTR_PRINTER_ORGANIZATION,
+  _PAPPL_ATTR_PRINTER_ORGANIZATIONAL_UNIT,
+  _PAPPL_ATTR_PRINTER_RESOLUTION_DEFAULT,
+  _PAPPL_ATTR_PRINTER_SPEED_DEFAULT,
+  _PAPPL_ATTR_PRINTER_STATE,
+  _PAPPL_ATTR_PRINTER_STATE_CHANGE_DATE_TIME,
+  _PAPPL_ATTR_PRINTER_STATE_CHANGE_TIME,
+  _PAPPL_ATTR_PRINTER_STATE_MESSAGE,
+  _PAPPL_ATTR_PRINTER_STATE_REASONS,
+  _PAPPL_ATTR_PRINTER_STRINGS_LANGUAGES_SUPPORTED,
+  _PAPPL_ATTR_PRINTER_STRINGS_URI,
+  _PAPPL_ATTR_PRINTER_SUPPLY,
+  _PAPPL_ATTR_PRINTER_SUPPLY_DESCRIPTION,
+  _PAPPL_ATTR_PRINTER_SUPPLY_INFO_URI,
+  _PAPPL_ATTR_PRINTER_UP_TIME,
+  _PAPPL_ATTR_PRINTER_URI_SUPPORTED,
+  _PAPPL_ATTR_PRINTER_XRI_SUPPORTED,
+  _PAPPL_ATTR_QUEUED_JOB_COUNT,
+  _PAPPL_ATTR_SIDES_DEFAULT,
+  _PAPPL_ATTR_SYSTEM_CONFIG_CHANGE_DATE_TIME,
+  _PAPPL_ATTR_SYSTEM_CONFIG_CHANGE_TIME,
+  _PAPPL_ATTR_SYSTEM_CONFIGURED_PRINTERS,
+  _PAPPL_ATTR_SYSTEM_CONTACT_COL,
+  _PAPPL_ATTR_SYSTEM_CURRENT_TIME,
+  _PAPPL_ATTR_SYSTEM_DEFAULT_PRINTER_ID,
+  _PAPPL_ATTR_SYSTEM_FIRMWARE_NAME,
+  _PAPPL_ATTR_SYSTEM_FIRMWARE_PATCHES,
+  _PAPPL_ATTR_SYSTEM_FIRMWARE_STRING_VERSION,
+  _PAPPL_ATTR_SYSTEM_FIRMWARE_VERSION,
+  _PAPPL_ATTR_SYSTEM_GEO_LOCATION,
+  _PAPPL_ATTR_SYSTEM_LOCATION,
+  _PAPPL_ATTR_SYSTEM_NAME,
+  _PAPPL_ATTR_SYSTEM_ORGANIZATION,
+  _PAPPL_ATTR_SYSTEM_ORGANIZATIONAL_UNIT,
+  _PAPPL_ATTR_SYSTEM_STATE,
+  _PAPPL_ATTR_SYSTEM_STATE_CHANGE_DATE_TIME,
+  _PAPPL_ATTR_SYSTEM_STATE_CHANGE_TIME,
+  _PAPPL_ATTR_SYSTEM_STATE_REASONS,
+  _PAPPL_ATTR_SYSTEM_UP_TIME,
+  _PAPPL_ATTR_SYSTEM_UUID,
+  _PAPPL_ATTR_SYSTEM_XRI_SUPPORTED,
+  _PAPPL_ATTR_TIME_AT_COMPLETED,
+  _PAPPL_ATTR_TIME_AT_CREATION,
+  _PAPPL_ATTR_TIME_AT_PROCESSING,
+  _PAPPL_ATTR_URI_AUTHENTICATION_SUPPORTED,
+  _PAPPL_ATTR_MAX			// Number of attribute IDs
+} _pappl_attr_id_t;
+
+typedef struct _pappl_ra_s		// Requested attributes
+{
+  cups_array_t		*array;			// Requested attribute names or `NULL` for all
+  unsigned		bits[(_PAPPL_ATTR_MAX + 31) / 32];
+						// Requested attribute IDs
+} _pappl_ra_t;
+
+typedef struct _pappl_blob_attr_s	// Pre-encoded attribute
+{
+  const char		*name;			// Attribute name
+  const unsigned char	*data;			// Wire-format attribute and values
+  size_t		length;			// Length of wire-format data
+} _pappl_blob_attr_t;
+
+typedef struct _pappl_blob_s		// Pre-encoded static attributes
+{
+  pthread_mutex_t	mutex;			// Reference count mutex
+  int			use;			// Reference count
+  unsigned char		*data;			// Wire-format data
+  size_t		datalen;		// Length of wire-format data
+  char			*names;			// Attribute names
+  size_t		num_attrs;		// Number of attributes
+  _pappl_blob_attr_t	*attrs;			// Attributes, sorted by name
+} _pappl_blob_t;
+
+
+//
+// Functions...
+//
+
+extern _pappl_blob_t	*_papplBlobCreate(ipp_t *ipp) _PAPPL_PRIVATE;
+extern unsigned char	*_papplBlobEncode(ipp_t *ipp, size_t *datalen) _PAPPL_PRIVATE;
+extern _pappl_blob_attr_t *_papplBlobFind(_pappl_blob_t *blob, const char *name) _PAPPL_PRIVATE;
+extern void		_papplBlobRelease(_pappl_blob_t *blob) _PAPPL_PRIVATE;
+extern _pappl_blob_t	*_papplBlobRetain(_pappl_blob_t *blob) _PAPPL_PRIVATE;
+
+extern void		_papplRequestedCreate(_pappl_ra_t *ra, ipp_t *request, size_t num_defaults, const char * const *defaults) _PAPPL_PRIVATE;
+extern void		_papplRequestedCreateNames(_pappl_ra_t *ra, size_t num_names, const char * const *names) _PAPPL_PRIVATE;
+extern void		_papplRequestedDelete(_pappl_ra_t *ra) _PAPPL_PRIVATE;
+extern _pappl_attr_id_t	_papplRequestedLookup(const char *name) _PAPPL_PRIVATE;
+
+
+#endif // !_PAPPL_ATTRS_PRIVATE_H_
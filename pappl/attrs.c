@@ -0,0 +1,636 @@
+//
+// Pre-encoded attribute functions for the Printer Application Framework
+//
+// Copyright © 2021 by Michael R Sweet.
+//
+// Licensed under Apache License v2.0.  See the file "LICENSE" for more
+// information.
+//
+
+//
+// Include necessary headers...
+//
+
+#include "base-private.h"
+
+
+//
+// Local constants...
+//
+
+#define _PAPPL_ATTR_HASH_SIZE	4096	// Size of attribute name hash table (power of 2)
+#define _PAPPL_ATTR_HASH_EMPTY	255	// Empty hash table slot
+#define _PAPPL_ATTR_HASH_SLOT(name,seed) (_papplHashString(name, _PAPPL_HASH_INIT ^ (seed)) & (_PAPPL_ATTR_HASH_SIZE - 1))
+					// Hash table slot for an attribute name
+
+
+//
+// Local types...
+//
+
+typedef struct _pappl_buffer_s		// Memory buffer for ippWriteIO
+{
+  unsigned char	*data;			// Buffer
+  size_t	used,			// Bytes used
+		size;			// Size of buffer
+} _pappl_buffer_t;
+
+
+//
+// Local globals...
+//
+
+static const char * const pappl_attr_names[_PAPPL_ATTR_MAX] =
+{					// Attribute names, in ID order
+  "copies-supported",
+  "date-time-at-completed",
+  "date-time-at-creation",
+  "date-time-at-processing",
+  "identify-actions-default",
+  "job-impressions",
+  "job-impressions-completed",
+  "job-printer-up-time",
+  "job-state",
+  "job-state-message",
+  "job-state-reasons",
+  "label-mode-configured",
+  "label-tear-offset-configured",
+  "marker-colors",
+  "marker-high-levels",
+  "marker-levels",
+  "marker-low-levels",
+  "marker-names",
+  "marker-types",
+  "media-col-default",
+  "media-col-ready",
+  "media-default",
+  "media-ready",
+  "multiple-document-handling-default",
+  "orientation-requested-default",
+  "output-bin-default",
+  "print-color-mode-default",
+  "print-content-optimize-default",
+  "print-quality-default",
+  "print-scaling-default",
+  "printer-config-change-date-time",
+  "printer-config-change-time",
+  "printer-contact-col",
+  "printer-current-time",
+  "printer-darkness-configured",
+  "printer-dns-sd-name",
+  "printer-firmware-name",
+  "printer-firmware-patches",
+  "printer-firmware-string-version",
+  "printer-firmware-version",
+  "printer-geo-location",
+  "printer-icons",
+  "printer-impressions-completed",
+  "printer-input-tray",
+  "printer-is-accepting-jobs",
+  "printer-location",
+  "printer-more-info",
+  "printer-organization",
+  "printer-organizational-unit",
+  "printer-resolution-default",
+  "printer-speed-default",
+  "printer-state",
+  "printer-state-change-date-time",
+  "printer-state-change-time",
+  "printer-state-message",
+  "printer-state-reasons",
+  "printer-strings-languages-supported",
+  "printer-strings-uri",
+  "printer-supply",
+  "printer-supply-description",
+  "printer-supply-info-uri",
+  "printer-up-time",
+  "printer-uri-supported",
+  "printer-xri-supported",
+  "queued-job-count",
+  "sides-default",
+  "system-config-change-date-time",
+  "system-config-change-time",
+  "system-configured-printers",
+  "system-contact-col",
+  "system-current-time",
+  "system-default-printer-id",
+  "system-firmware-name",
+  "system-firmware-patches",
+  "system-firmware-string-version",
+  "system-firmware-version",
+  "system-geo-location",
+  "system-location",
+  "system-name",
+  "system-organization",
+  "system-organizational-unit",
+  "system-state",
+  "system-state-change-date-time",
+  "system-state-change-time",
+  "system-state-reasons",
+  "system-up-time",
+  "system-uuid",
+  "system-xri-supported",
+  "time-at-completed",
+  "time-at-creation",
+  "time-at-processing",
+  "uri-authentication-supported"
+};
+
+static const char * const pappl_attr_groups[] =
+{					// Group names for requested-attributes
+  "all",
+  "document-description",
+  "document-status",
+  "document-template",
+  "job-actuals",
+  "job-description",
+  "job-status",
+  "job-template",
+  "printer-configuration",
+  "printer-defaults",
+  "printer-description",
+  "printer-status",
+  "resource-description",
+  "resource-status",
+  "resource-template",
+  "subscription-description",
+  "subscription-template",
+  "system-configuration",
+  "system-description",
+  "system-status"
+};
+
+static pthread_once_t	pappl_attr_once = PTHREAD_ONCE_INIT;
+					// One-time initialization for hash table
+static unsigned		pappl_attr_seed = 0;
+					// Hash seed
+static unsigned char	pappl_attr_hash[_PAPPL_ATTR_HASH_SIZE];
+					// Hash table of attribute IDs
+
+
+//
+// Local functions...
+//
+
+static void	attr_init(void);
+static int	compare_attrs(_pappl_blob_attr_t *a, _pappl_blob_attr_t *b);
+static ssize_t	write_cb(_pappl_buffer_t *buffer, ipp_uchar_t *data, size_t bytes);
+
+
+//
+// '_papplBlobCreate()' - Pre-encode a collection of static attributes.
+//
+// This function serializes the attributes in "ipp" once to the IPP wire format
+// and builds an index of the encoded attributes by name so that responses can
+// copy the requested attributes as byte spans.
+//
+
+_pappl_blob_t *				// O - Pre-encoded attributes or `NULL` on error
+_papplBlobCreate(ipp_t *ipp)		// I - Attributes to encode
+{
+  _pappl_blob_t		*blob;		// Pre-encoded attributes
+  unsigned char		*data,		// Encoded attributes
+			*ptr,		// Pointer into data
+			*end,		// End of data
+			*start;		// Start of current attribute
+  size_t		datalen,	// Length of encoded attributes
+			namelen,	// Length of name
+			valuelen,	// Length of value
+			alloc_attrs = 0;// Allocated attributes
+  char			*nameptr;	// Pointer into names
+  _pappl_blob_attr_t	*battr = NULL;	// Current attribute
+
+
+  if (!ipp)
+    return (NULL);
+
+  // Serialize the attributes...
+  if ((data = _papplBlobEncode(ipp, &datalen)) == NULL)
+    return (NULL);
+
+  if ((blob = calloc(1, sizeof(_pappl_blob_t))) == NULL)
+  {
+    free(data);
+    return (NULL);
+  }
+
+  pthread_mutex_init(&blob->mutex, NULL);
+
+  blob->use     = 1;
+  blob->data    = data;
+  blob->datalen = datalen;
+
+  // Names are stored nul-terminated in a separate pool that is never larger
+  // than the encoded data...
+  if ((blob->names = malloc(datalen)) == NULL)
+    goto error;
+
+  // Index the encoded attributes, skipping the 8-byte message header.  Each
+  // attribute is a value tag, 2-byte name length, name, 2-byte value length,
+  // and value; additional values and collection members use a zero-length
+  // name and are folded into the preceding attribute...
+  for (ptr = blob->data + 8, end = blob->data + blob->datalen, nameptr = blob->names; ptr < end;)
+  {
+    if (*ptr < IPP_TAG_UNSUPPORTED_VALUE)
+    {
+      // Delimiter tag...
+      if (*ptr++ == IPP_TAG_END)
+        break;
+
+      battr = NULL;
+      continue;
+    }
+
+    start = ptr;
+
+    if (*ptr++ == IPP_TAG_EXTENSION)
+      ptr += 4;
+
+    if ((ptr + 2) > end)
+      goto error;
+
+    namelen = (size_t)((ptr[0] << 8) | ptr[1]);
+    ptr     += 2;
+
+    if ((ptr + namelen + 2) > end)
+      goto error;
+
+    if (namelen > 0)
+    {
+      // Start a new attribute...
+      if (blob->num_attrs >= alloc_attrs)
+      {
+        _pappl_blob_attr_t *temp;	// New attributes
+
+        alloc_attrs += 32;
+
+        if ((temp = realloc(blob->attrs, alloc_attrs * sizeof(_pappl_blob_attr_t))) == NULL)
+          goto error;
+
+        blob->attrs = temp;
+      }
+
+      battr = blob->attrs + blob->num_attrs;
+      blob->num_attrs ++;
+
+      memcpy(nameptr, ptr, namelen);
+      nameptr[namelen] = '\0';
+
+      battr->name   = nameptr;
+      battr->data   = start;
+      battr->length = 0;
+
+      nameptr += namelen + 1;
+    }
+    else if (!battr)
+    {
+      // Additional value without an attribute...
+      goto error;
+    }
+
+    ptr += namelen;
+
+    valuelen = (size_t)((ptr[0] << 8) | ptr[1]);
+    ptr      += 2 + valuelen;
+
+    if (ptr > end)
+      goto error;
+
+    battr->length = (size_t)(ptr - battr->data);
+  }
+
+  // Sort the index by name...
+  if (blob->num_attrs > 1)
+    qsort(blob->attrs, blob->num_attrs, sizeof(_pappl_blob_attr_t), (int (*)(const void *, const void *))compare_attrs);
+
+  return (blob);
+
+  // If we get here there was an error...
+  error:
+
+  _papplBlobRelease(blob);
+
+  return (NULL);
+}
+
+
+//
+// '_papplBlobEncode()' - Encode an IPP message to a memory buffer.
+//
+// The returned buffer is allocated using `malloc` and must be freed by the
+// caller.
+//
+
+unsigned char *				// O - Encoded message or `NULL` on error
+_papplBlobEncode(ipp_t  *ipp,		// I - IPP message
+                 size_t *datalen)	// O - Length of encoded message
+{
+  _pappl_buffer_t	buffer;		// Write buffer
+
+
+  *datalen = 0;
+
+  buffer.used = 0;
+  buffer.size = ippLength(ipp);
+
+  if ((buffer.data = malloc(buffer.size)) == NULL)
+    return (NULL);
+
+  ippSetState(ipp, IPP_STATE_IDLE);
+
+  if (ippWriteIO(&buffer, (ipp_iocb_t)write_cb, 1, NULL, ipp) != IPP_STATE_DATA)
+  {
+    free(buffer.data);
+    return (NULL);
+  }
+
+  *datalen = buffer.used;
+
+  return (buffer.data);
+}
+
+
+//
+// '_papplBlobFind()' - Find a pre-encoded attribute by name.
+//
+
+_pappl_blob_attr_t *			// O - Attribute or `NULL` if not found
+_papplBlobFind(_pappl_blob_t *blob,	// I - Pre-encoded attributes
+               const char    *name)	// I - Attribute name
+{
+  _pappl_blob_attr_t	key;		// Search key
+
+
+  if (!blob || !name || !blob->num_attrs)
+    return (NULL);
+
+  key.name = name;
+
+  return ((_pappl_blob_attr_t *)bsearch(&key, blob->attrs, blob->num_attrs, sizeof(_pappl_blob_attr_t), (int (*)(const void *, const void *))compare_attrs));
+}
+
+
+//
+// '_papplBlobRelease()' - Release a reference to pre-encoded attributes.
+//
+
+void
+_papplBlobRelease(_pappl_blob_t *blob)	// I - Pre-encoded attributes
+{
+  int	use;				// Remaining references
+
+
+  if (!blob)
+    return;
+
+  pthread_mutex_lock(&blob->mutex);
+  use = -- blob->use;
+  pthread_mutex_unlock(&blob->mutex);
+
+  if (use > 0)
+    return;
+
+  pthread_mutex_destroy(&blob->mutex);
+
+  free(blob->data);
+  free(blob->names);
+  free(blob->attrs);
+  free(blob);
+}
+
+
+//
+// '_papplBlobRetain()' - Add a reference to pre-encoded attributes.
+//
+
+_pappl_blob_t *				// O - Pre-encoded attributes
+_papplBlobRetain(_pappl_blob_t *blob)	// I - Pre-encoded attributes
+{
+  if (blob)
+  {
+    pthread_mutex_lock(&blob->mutex);
+    blob->use ++;
+    pthread_mutex_unlock(&blob->mutex);
+  }
+
+  return (blob);
+}
+
+
+//
+// '_papplRequestedCreate()' - Create the requested attributes for a request.
+//
+// The "requested-attributes" values are looked up once and recorded as a
+// bitset of attribute IDs so that the copy functions can use
+// `_PAPPL_REQUESTED` instead of searching an array of names.  Group names such
+// as "job-template" are expanded using `ippCreateRequestedArray`, otherwise
+// the name array simply points at the strings in the request.
+//
+// When the request has no "requested-attributes", the "num_defaults" and
+// "defaults" arguments specify the attributes to return - pass `0` and `NULL`
+// to return all attributes.
+//
+
+void
+_papplRequestedCreate(
+    _pappl_ra_t       *ra,		// I - Requested attributes
+    ipp_t             *request,		// I - IPP request
+    size_t            num_defaults,	// I - Number of default attributes
+    const char *const *defaults)	// I - Default attributes or `NULL` for all
+{
+  ipp_attribute_t	*attr;		// "requested-attributes" attribute
+  int			i,		// Looping var
+			count;		// Number of values
+  size_t		j;		// Looping var
+  const char		*name;		// Current attribute name
+  _pappl_attr_id_t		id;		// Attribute ID
+
+
+  memset(ra, 0, sizeof(_pappl_ra_t));
+
+  if ((attr = ippFindAttribute(request, "requested-attributes", IPP_TAG_KEYWORD)) == NULL)
+  {
+    // No requested-attributes means the operation's defaults...
+    if (num_defaults > 0 && defaults)
+      _papplRequestedCreateNames(ra, num_defaults, defaults);
+    else
+      memset(ra->bits, 255, sizeof(ra->bits));
+    return;
+  }
+
+  for (i = 0, count = ippGetCount(attr); i < count; i ++)
+  {
+    name = ippGetString(attr, i, NULL);
+
+    for (j = 0; j < (sizeof(pappl_attr_groups) / sizeof(pappl_attr_groups[0])); j ++)
+    {
+      if (!strcmp(name, pappl_attr_groups[j]))
+        break;
+    }
+
+    if (j < (sizeof(pappl_attr_groups) / sizeof(pappl_attr_groups[0])))
+      break;
+  }
+
+  if (i < count)
+  {
+    // Expand group names the slow way...
+    if ((ra->array = ippCreateRequestedArray(request)) == NULL)
+    {
+      memset(ra->bits, 255, sizeof(ra->bits));
+      return;
+    }
+
+    for (name = (const char *)cupsArrayFirst(ra->array); name; name = (const char *)cupsArrayNext(ra->array))
+    {
+      if ((id = _papplRequestedLookup(name)) < _PAPPL_ATTR_MAX)
+        ra->bits[id / 32] |= 1U << (id & 31);
+    }
+  }
+  else
+  {
+    // Only attribute names, no need to copy the strings...
+    ra->array = cupsArrayNew((cups_array_func_t)strcmp, NULL);
+
+    for (i = 0; i < count; i ++)
+    {
+      name = ippGetString(attr, i, NULL);
+
+      cupsArrayAdd(ra->array, (void *)name);
+
+      if ((id = _papplRequestedLookup(name)) < _PAPPL_ATTR_MAX)
+        ra->bits[id / 32] |= 1U << (id & 31);
+    }
+  }
+}
+
+
+//
+// '_papplRequestedCreateNames()' - Create the requested attributes from a list of names.
+//
+// The names must remain valid until `_papplRequestedDelete` is called.
+//
+
+void
+_papplRequestedCreateNames(
+    _pappl_ra_t       *ra,		// I - Requested attributes
+    size_t            num_names,	// I - Number of names
+    const char *const *names)		// I - Names
+{
+  size_t	i;			// Looping var
+  _pappl_attr_id_t	id;			// Attribute ID
+
+
+  memset(ra, 0, sizeof(_pappl_ra_t));
+
+  ra->array = cupsArrayNew((cups_array_func_t)strcmp, NULL);
+
+  for (i = 0; i < num_names; i ++)
+  {
+    cupsArrayAdd(ra->array, (void *)names[i]);
+
+    if ((id = _papplRequestedLookup(names[i])) < _PAPPL_ATTR_MAX)
+      ra->bits[id / 32] |= 1U << (id & 31);
+  }
+}
+
+
+//
+// '_papplRequestedDelete()' - Free the requested attributes.
+//
+
+void
+_papplRequestedDelete(_pappl_ra_t *ra)	// I - Requested attributes
+{
+  cupsArrayDelete(ra->array);
+  ra->array = NULL;
+}
+
+
+//
+// '_papplRequestedLookup()' - Look up the ID for an attribute name.
+//
+
+_pappl_attr_id_t				// O - Attribute ID or `_PAPPL_ATTR_MAX` if unknown
+_papplRequestedLookup(const char *name)	// I - Attribute name
+{
+  unsigned	h;			// Current hash table slot
+  unsigned char	id;			// Attribute ID
+
+
+  pthread_once(&pappl_attr_once, attr_init);
+
+  for (h = _PAPPL_ATTR_HASH_SLOT(name, pappl_attr_seed); (id = pappl_attr_hash[h]) != _PAPPL_ATTR_HASH_EMPTY; h = (h + 1) & (_PAPPL_ATTR_HASH_SIZE - 1))
+  {
+    if (!strcmp(name, pappl_attr_names[id]))
+      return ((_pappl_attr_id_t)id);
+  }
+
+  return (_PAPPL_ATTR_MAX);
+}
+
+
+//
+// 'attr_init()' - Build the attribute name hash table.
+//
+// A seed that maps every attribute name to its own slot is chosen so that
+// lookups take a single probe.  If no such seed is found the table falls back
+// to linear probing.
+//
+
+static void
+attr_init(void)
+{
+  unsigned	seed,			// Current seed
+		h;			// Hash table slot
+  int		id;			// Attribute ID
+  bool		collision = true;	// Did two names collide?
+
+
+  for (seed = 0; seed < 1000 && collision; seed ++)
+  {
+    memset(pappl_attr_hash, _PAPPL_ATTR_HASH_EMPTY, sizeof(pappl_attr_hash));
+
+    pappl_attr_seed = seed;
+    collision       = false;
+
+    for (id = 0; id < _PAPPL_ATTR_MAX; id ++)
+    {
+      for (h = _PAPPL_ATTR_HASH_SLOT(pappl_attr_names[id], seed); pappl_attr_hash[h] != _PAPPL_ATTR_HASH_EMPTY; h = (h + 1) & (_PAPPL_ATTR_HASH_SIZE - 1))
+        collision = true;
+
+      pappl_attr_hash[h] = (unsigned char)id;
+    }
+  }
+}
+
+
+//
+// 'compare_attrs()' - Compare two pre-encoded attributes by name.
+//
+
+static int				// O - Result of comparison
+compare_attrs(_pappl_blob_attr_t *a,	// I - First attribute
+              _pappl_blob_attr_t *b)	// I - Second attribute
+{
+  return (strcmp(a->name, b->name));
+}
+
+
+//
+// 'write_cb()' - Write IPP data to a memory buffer.
+//
+
+static ssize_t				// O - Number of bytes written or `-1` on error
+write_cb(_pappl_buffer_t *buffer,	// I - Memory buffer
+         ipp_uchar_t     *data,		// I - Data to write
+         size_t          bytes)		// I - Number of bytes
+{
+  if (bytes > (buffer->size - buffer->used))
+    return (-1);
+
+  memcpy(buffer->data + buffer->used, data, bytes);
+  buffer->used += bytes;
+
+  return ((ssize_t)bytes);
+}
@@ -15,7 +15,7 @@
 // Include necessary headers...
 //
 
-#  include "base.h"
+#  include "attrs-private.h"
 #  include <config.h>
 #  include <limits.h>
 #  include <poll.h>
@@ -39,6 +39,8 @@ extern char **environ;
 #  define _PAPPL_LOOKUP_STRING(bit,strings) _papplLookupString(bit, sizeof(strings) / sizeof(strings[0]), strings)
 #  define _PAPPL_LOOKUP_VALUE(keyword,strings) _papplLookupValue(keyword, sizeof(strings) / sizeof(strings[0]), strings)
 
+#  define _PAPPL_HASH_INIT	2166136261U	// Initial FNV-1a hash value
+
 #  ifndef HAVE_STRLCPY
 #    define strlcpy(dst,src,dstsize) _pappl_strlcpy(dst,src,dstsize)
 #  endif // !HAVE_STRLCPY
@@ -73,6 +75,8 @@ extern ipp_t		*_papplContactExport(pappl_contact_t *contact) _PAPPL_PRIVATE;
 extern void		_papplContactImport(ipp_t *col, pappl_contact_t *contact) _PAPPL_PRIVATE;
 extern void		_papplCopyAttributes(ipp_t *to, ipp_t *from, cups_array_t *ra, ipp_tag_t group_tag, int quickcopy) _PAPPL_PRIVATE;
 extern unsigned		_papplGetRand(void) _PAPPL_PRIVATE;
+extern double		_papplGetTime(void) _PAPPL_PRIVATE;
+extern unsigned		_papplHashString(const char *s, unsigned hash) _PAPPL_PRIVATE;
 extern const char	*_papplLookupString(unsigned bit, size_t num_strings, const char * const *strings) _PAPPL_PRIVATE;
 extern unsigned		_papplLookupValue(const char *keyword, size_t num_strings, const char * const *strings) _PAPPL_PRIVATE;
 
@@ -12,7 +12,7 @@
 //
 
 #include "client-private.h"
-#include "system.h"
+#include "system-private.h"
 
 
 //
@@ -41,6 +41,7 @@ papplClientGetCSRFToken(
   char		session_key[65],	// Current session key
 		csrf_data[1024];	// CSRF data to hash
   unsigned char	csrf_sum[32];		// SHA2-256 sum of data
+  size_t	epoch;			// Session key generation
 
 
   if (!client || !buffer || bufsize < 65)
@@ -51,9 +52,19 @@ papplClientGetCSRFToken(
     return (NULL);
   }
 
-  snprintf(csrf_data, sizeof(csrf_data), "%s:%s", papplSystemGetSessionKey(client->system, session_key, sizeof(session_key)), client->hostname);
-  cupsHashData("sha2-256", csrf_data, strlen(csrf_data), csrf_sum, sizeof(csrf_sum));
-  cupsHashString(csrf_sum, sizeof(csrf_sum), buffer, bufsize);
+  // Compute the token once per session key...
+  epoch = _papplSystemGetSessionEpoch(client->system);
+
+  if (!client->csrf_token[0] || client->csrf_epoch != epoch)
+  {
+    snprintf(csrf_data, sizeof(csrf_data), "%s:%s", papplSystemGetSessionKey(client->system, session_key, sizeof(session_key)), client->hostname);
+    cupsHashData("sha2-256", csrf_data, strlen(csrf_data), csrf_sum, sizeof(csrf_sum));
+    cupsHashString(csrf_sum, sizeof(csrf_sum), client->csrf_token, sizeof(client->csrf_token));
+
+    client->csrf_epoch = epoch;
+  }
+
+  strlcpy(buffer, client->csrf_token, bufsize);
 
   return (buffer);
 }
@@ -97,14 +108,20 @@ papplClientGetHostPort(
 //
 // This function returns the HTTP connection associated with the client and is
 // used when sending response data directly to the client using the CUPS
-// `httpXxx` functions.
+// `httpXxx` functions.  Any HTML output that has been buffered by the
+// `papplClientHTML` functions is sent first.
 //
 
 http_t *				// O - HTTP connection
 papplClientGetHTTP(
     pappl_client_t *client)		// I - Client
 {
-  return (client ? client->http : NULL);
+  if (!client)
+    return (NULL);
+
+  _papplClientFlushHTML(client);
+
+  return (client->http);
 }
 
 
@@ -38,6 +38,9 @@ typedef struct _pappl_authdata_s	// PAM authentication data
 // Local functions...
 //
 
+static void	pappl_auth_cache_add(pappl_system_t *system, const char *username, const unsigned char *hash, http_status_t status);
+static http_status_t pappl_auth_cache_find(pappl_system_t *system, const char *username, const unsigned char *hash);
+static void	pappl_auth_cache_hash(pappl_client_t *client, const char *username, const char *password, unsigned char *hash);
 static int	pappl_authenticate_user(pappl_client_t *client, const char *username, const char *password);
 #ifdef HAVE_LIBPAM
 static int	pappl_pam_func(int num_msg, const struct pam_message **msg, struct pam_response **resp, _pappl_authdata_t *data);
@@ -90,6 +93,8 @@ papplClientIsAuthorized(
 		*password;		// Password value
       int	userlen = sizeof(username);
 					// Length of username:password
+      unsigned char hash[32];		// Hash of credentials
+      http_status_t status;		// Cached status
       struct passwd *user;		// User information
       int	num_groups;		// Number of autbenticated groups, if any
 #  ifdef __APPLE__
@@ -107,6 +112,17 @@ papplClientIsAuthorized(
       {
 	*password++ = '\0';
 
+        // Use the cached result if these credentials were recently verified...
+        pappl_auth_cache_hash(client, username, password, hash);
+
+        if ((status = pappl_auth_cache_find(client->system, username, hash)) != HTTP_STATUS_NONE)
+        {
+	  papplLogClient(client, PAPPL_LOGLEVEL_DEBUG, "Using cached authentication for \"%s\".", username);
+	  strlcpy(client->username, username, sizeof(client->username));
+
+	  return (status);
+        }
+
         // Authenticate the username and password...
 	if (pappl_authenticate_user(client, username, password))
 	{
@@ -144,12 +160,14 @@ papplClientIsAuthorized(
                 if (i >= num_groups)
                 {
                   // Not in the admin group, access is forbidden...
+                  pappl_auth_cache_add(client->system, username, hash, HTTP_STATUS_FORBIDDEN);
                   return (HTTP_STATUS_FORBIDDEN);
 		}
               }
             }
 
             // If we get this far, authentication and authorization are good...
+            pappl_auth_cache_add(client->system, username, hash, HTTP_STATUS_CONTINUE);
             return (HTTP_STATUS_CONTINUE);
 	  }
 	  else
@@ -181,6 +199,113 @@ papplClientIsAuthorized(
 }
 
 
+//
+// 'pappl_auth_cache_add()' - Add an authentication result to the cache.
+//
+// When the cache is full, the entry that expires first is replaced.
+//
+
+static void
+pappl_auth_cache_add(
+    pappl_system_t      *system,	// I - System
+    const char          *username,	// I - Username
+    const unsigned char *hash,		// I - Hash of credentials
+    http_status_t       status)		// I - Authorization status
+{
+  size_t		i;		// Looping var
+  _pappl_auth_cache_t	*ac,		// Current entry
+			*oldest = NULL;	// Entry to replace
+
+
+  pthread_mutex_lock(&system->auth_mutex);
+
+  if (system->auth_cache_time > 0)
+  {
+    for (i = system->num_auth_cache, ac = system->auth_cache; i > 0; i --, ac ++)
+    {
+      if (!strcmp(ac->username, username))
+      {
+        // Replace the previous result for this user...
+        oldest = ac;
+        break;
+      }
+      else if (!oldest || ac->expires < oldest->expires)
+        oldest = ac;
+    }
+
+    if (!oldest || (i == 0 && system->num_auth_cache < _PAPPL_MAX_AUTH_CACHE))
+      oldest = system->auth_cache + system->num_auth_cache ++;
+
+    strlcpy(oldest->username, username, sizeof(oldest->username));
+    memcpy(oldest->hash, hash, sizeof(oldest->hash));
+    oldest->status  = status;
+    oldest->expires = time(NULL) + system->auth_cache_time;
+  }
+
+  pthread_mutex_unlock(&system->auth_mutex);
+}
+
+
+//
+// 'pappl_auth_cache_find()' - Find a cached authentication result.
+//
+
+static http_status_t			// O - Authorization status or `HTTP_STATUS_NONE` if not cached
+pappl_auth_cache_find(
+    pappl_system_t      *system,	// I - System
+    const char          *username,	// I - Username
+    const unsigned char *hash)		// I - Hash of credentials
+{
+  size_t		i;		// Looping var
+  _pappl_auth_cache_t	*ac;		// Current entry
+  http_status_t		status = HTTP_STATUS_NONE;
+					// Authorization status
+
+
+  pthread_mutex_lock(&system->auth_mutex);
+
+  for (i = system->num_auth_cache, ac = system->auth_cache; i > 0; i --, ac ++)
+  {
+    if (!strcmp(ac->username, username))
+    {
+      if (ac->expires > time(NULL) && !memcmp(ac->hash, hash, sizeof(ac->hash)))
+        status = ac->status;
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&system->auth_mutex);
+
+  if (system->auth_cache_time > 0)
+    _papplSystemAddMetricCount(system, status != HTTP_STATUS_NONE ? _PAPPL_COUNTER_AUTH_CACHE_HITS : _PAPPL_COUNTER_AUTH_CACHE_MISSES, 1);
+
+  return (status);
+}
+
+
+//
+// 'pappl_auth_cache_hash()' - Hash the credentials for the cache.
+//
+// The hash includes the current session key so that passwords are never
+// stored, and the client hostname since PAM access rules can depend on it.
+//
+
+static void
+pappl_auth_cache_hash(
+    pappl_client_t *client,		// I - Client
+    const char     *username,		// I - Username
+    const char     *password,		// I - Password
+    unsigned char  *hash)		// O - Hash (32 bytes)
+{
+  char	session_key[65],		// Current session key
+	text[1024];			// Text to hash
+
+
+  snprintf(text, sizeof(text), "%s:%s:%s:%s", papplSystemGetSessionKey(client->system, session_key, sizeof(session_key)), client->hostname, username, password);
+  cupsHashData("sha2-256", text, strlen(text), hash, 32);
+}
+
+
 //
 // 'pappl_authenticate_user()' - Validate a username + password combination.
 //
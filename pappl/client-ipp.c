@@ -15,6 +15,120 @@
 #include "pappl-private.h"
 
 
+//
+// Local functions...
+//
+
+static ssize_t	write_splices(pappl_client_t *client, ipp_uchar_t *buffer, size_t bytes);
+
+
+//
+// '_papplClientCleanSplices()' - Release any pre-encoded attributes.
+//
+
+void
+_papplClientCleanSplices(
+    pappl_client_t *client)		// I - Client
+{
+  size_t		i;		// Looping var
+  _pappl_splice_t	*splice;	// Current splice
+
+
+  for (i = client->num_splices, splice = client->splices; i > 0; i --, splice ++)
+  {
+    _papplBlobRelease(splice->blob);
+    free(splice->attrs);
+  }
+
+  client->num_splices = 0;
+}
+
+
+//
+// '_papplClientCopyBlob()' - Copy pre-encoded attributes to the response.
+//
+// This function selects the requested attributes from "blob" and adds a
+// placeholder to the response that is replaced by the pre-encoded attributes
+// when the response is written by @link _papplClientWriteIPP@.  The
+// "media-col-database" attribute is only copied when explicitly requested.
+//
+
+bool					// O - `true` on success, `false` on error
+_papplClientCopyBlob(
+    pappl_client_t *client,		// I - Client
+    _pappl_blob_t  *blob,		// I - Pre-encoded attributes
+    ipp_tag_t      group_tag,		// I - Group for attributes
+    cups_array_t   *ra)			// I - Requested attributes
+{
+  _pappl_splice_t	*splice;	// New splice
+  _pappl_blob_attr_t	*battr;		// Current attribute
+  size_t		i;		// Looping var
+  int			index;		// Splice index
+  const char		*name;		// Requested attribute name
+
+
+  if (!blob)
+    return (false);
+
+  // Allocate the splice...
+  if (client->num_splices >= client->alloc_splices)
+  {
+    if ((splice = realloc(client->splices, (client->alloc_splices + 4) * sizeof(_pappl_splice_t))) == NULL)
+      return (false);
+
+    client->splices      = splice;
+    client->alloc_splices += 4;
+  }
+
+  splice = client->splices + client->num_splices;
+
+  if ((splice->attrs = calloc(blob->num_attrs, sizeof(_pappl_blob_attr_t *))) == NULL)
+    return (false);
+
+  splice->num_attrs = 0;
+  splice->length    = 0;
+
+  // Select the requested attributes...
+  if (!ra)
+  {
+    for (i = blob->num_attrs, battr = blob->attrs; i > 0; i --, battr ++)
+    {
+      if (strcmp(battr->name, "media-col-database"))
+      {
+        splice->attrs[splice->num_attrs ++] = battr;
+        splice->length += battr->length;
+      }
+    }
+  }
+  else
+  {
+    for (name = (const char *)cupsArrayFirst(ra); name; name = (const char *)cupsArrayNext(ra))
+    {
+      if ((battr = _papplBlobFind(blob, name)) != NULL)
+      {
+        splice->attrs[splice->num_attrs ++] = battr;
+        splice->length += battr->length;
+      }
+    }
+  }
+
+  if (splice->num_attrs == 0)
+  {
+    // Nothing to copy...
+    free(splice->attrs);
+    return (true);
+  }
+
+  // Add the placeholder attribute...
+  splice->blob = _papplBlobRetain(blob);
+  index        = (int)client->num_splices ++;
+
+  ippAddOctetString(client->response, group_tag, _PAPPL_SPLICE_NAME, &index, (int)sizeof(index));
+
+  return (true);
+}
+
+
 //
 // '_papplClientFlushDocumentData()' - Safely flush remaining document data.
 //
@@ -70,6 +184,12 @@ _papplClientProcessIPP(
   const char		*name;		// Name of attribute
   bool			printer_op = true;
 					// Printer operation?
+  size_t		length,		// Length of response
+			i;		// Looping var
+  _pappl_splice_t	*splice;	// Current pre-encoded attributes
+  bool			ret;		// Return value
+  double		start = _papplGetTime();
+					// Start time of request
 
 
   // First build an empty response message for this request...
@@ -242,7 +362,45 @@ _papplClientProcessIPP(
   if (httpGetState(client->http) != HTTP_STATE_POST_SEND)
     _papplClientFlushDocumentData(client);	// Flush trailing (junk) data
 
-  return (papplClientRespond(client, HTTP_STATUS_OK, NULL, "application/ipp", 0, ippLength(client->response)));
+  // Adjust the response length for any pre-encoded attributes...
+  length = ippLength(client->response);
+
+  for (i = client->num_splices, splice = client->splices; i > 0; i --, splice ++)
+    length += splice->length - (sizeof(_PAPPL_SPLICE_NAME) + 4 + sizeof(int));
+
+  ret = papplClientRespond(client, HTTP_STATUS_OK, NULL, "application/ipp", 0, length);
+
+  _papplSystemAddMetricIPP(client->system, op, _papplGetTime() - start);
+
+  return (ret);
+}
+
+
+//
+// '_papplClientWriteIPP()' - Write the IPP response message.
+//
+// This function writes the IPP response message, replacing any placeholder
+// attributes with the corresponding pre-encoded attributes as the response is
+// encoded.
+//
+
+bool					// O - `true` on success, `false` on error
+_papplClientWriteIPP(
+    pappl_client_t *client)		// I - Client
+{
+  ippSetState(client->response, IPP_STATE_IDLE);
+
+  if (!client->num_splices)
+    return (ippWrite(client->http, client->response) == IPP_STATE_DATA);
+
+  client->num_spliced = 0;
+
+  if (ippWriteIO(client, (ipp_iocb_t)write_splices, 1, NULL, client->response) != IPP_STATE_DATA)
+    return (false);
+
+  // Every placeholder must have been replaced for the Content-Length to be
+  // correct...
+  return (client->num_spliced == client->num_splices);
 }
 
 
@@ -315,3 +473,70 @@ papplClientRespondIPPUnsupported(
   temp = ippCopyAttribute(client->response, attr, 0);
   ippSetGroupTag(client->response, &temp, IPP_TAG_UNSUPPORTED_GROUP);
 }
+
+
+//
+// 'write_splices()' - Write encoded IPP data, replacing placeholders.
+//
+// Each placeholder attribute is encoded as a single octetString value holding
+// the splice index, which is replaced by the pre-encoded attributes.
+//
+
+static ssize_t				// O - Number of bytes written or `-1` on error
+write_splices(
+    pappl_client_t *client,		// I - Client
+    ipp_uchar_t    *buffer,		// I - Encoded IPP data
+    size_t         bytes)		// I - Number of bytes
+{
+  ipp_uchar_t		*ptr,		// Pointer into buffer
+			*end,		// End of buffer
+			*segment;	// Start of current segment
+  size_t		i,		// Looping var
+			namelen = sizeof(_PAPPL_SPLICE_NAME) - 1,
+					// Length of placeholder name
+			length = namelen + 5 + sizeof(int);
+					// Length of placeholder attribute
+  int			index;		// Splice index
+  _pappl_splice_t	*splice;	// Current splice
+
+
+  // Placeholders are encoded as an octetString tag, the name, and a value
+  // containing the splice index...
+  for (ptr = buffer, end = buffer + bytes, segment = buffer; (ptr = memchr(ptr, IPP_TAG_STRING, (size_t)(end - ptr))) != NULL;)
+  {
+    if ((size_t)(end - ptr) < length || ptr[1] != 0 || ptr[2] != namelen || memcmp(ptr + 3, _PAPPL_SPLICE_NAME, namelen) || ptr[namelen + 3] != 0 || ptr[namelen + 4] != sizeof(int))
+    {
+      ptr ++;
+      continue;
+    }
+
+    memcpy(&index, ptr + namelen + 5, sizeof(index));
+
+    if (index < 0 || (size_t)index >= client->num_splices)
+    {
+      ptr ++;
+      continue;
+    }
+
+    // Write everything up to the placeholder followed by the pre-encoded
+    // attributes...
+    if (ptr > segment && httpWrite2(client->http, (char *)segment, (size_t)(ptr - segment)) < 0)
+      return (-1);
+
+    for (i = 0, splice = client->splices + index; i < splice->num_attrs; i ++)
+    {
+      if (httpWrite2(client->http, (const char *)splice->attrs[i]->data, splice->attrs[i]->length) < 0)
+        return (-1);
+    }
+
+    client->num_spliced ++;
+
+    ptr = segment = ptr + length;
+  }
+
+  // Write the remainder...
+  if (end > segment && httpWrite2(client->http, (char *)segment, (size_t)(end - segment)) < 0)
+    return (-1);
+
+  return ((ssize_t)bytes);
+}
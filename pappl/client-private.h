@@ -21,9 +21,27 @@
 
 
 //
-// Client structure...
+// Constants...
 //
 
+#  define _PAPPL_SPLICE_NAME	"-pappl-splice-"
+					// Placeholder attribute for pre-encoded attributes
+#  define _PAPPL_HTML_BUFMIN	4096	// Initial size of HTML output buffer
+#  define _PAPPL_HTML_BUFMAX	65536	// Maximum size of HTML output buffer
+
+
+//
+// Types and structures...
+//
+
+typedef struct _pappl_splice_s		// Pre-encoded attributes in a response
+{
+  _pappl_blob_t		*blob;			// Pre-encoded attributes
+  size_t		num_attrs;		// Number of requested attributes
+  _pappl_blob_attr_t	**attrs;		// Requested attributes
+  size_t		length;			// Length of requested attributes
+} _pappl_splice_t;
+
 struct _pappl_client_s			// Client data
 {
   pappl_system_t	*system;		// Containing system
@@ -32,6 +50,10 @@ struct _pappl_client_s			// Client data
   http_t		*http;			// HTTP connection
   ipp_t			*request,		// IPP request
 			*response;		// IPP response
+  size_t		num_splices,		// Number of pre-encoded attribute splices
+			alloc_splices,		// Allocated pre-encoded attribute splices
+			num_spliced;		// Number of splices written
+  _pappl_splice_t	*splices;		// Pre-encoded attribute splices
   time_t		start;			// Request start time
   http_state_t		operation;		// Request operation
   ipp_op_t		operation_id;		// IPP operation-id
@@ -43,10 +65,15 @@ struct _pappl_client_s			// Client data
   http_addr_t		addr;			// Client address
   char			hostname[256];		// Client hostname
   char			username[256];		// Authenticated username, if any
+  size_t		csrf_epoch;		// Session key generation for CSRF token
+  char			csrf_token[65];		// CSRF token, if computed
   pappl_printer_t	*printer;		// Printer, if any
   pappl_job_t		*job;			// Job, if any
   int			num_files;		// Number of temporary files
   char			*files[10];		// Temporary files
+  char			*htmlbuf;		// HTML output buffer
+  size_t		htmlused,		// Bytes in HTML output buffer
+			htmlsize;		// Size of HTML output buffer
 };
 
 
@@ -54,15 +81,19 @@ struct _pappl_client_s			// Client data
 // Functions...
 //
 
+extern void		_papplClientCleanSplices(pappl_client_t *client) _PAPPL_PRIVATE;
 extern void		_papplClientCleanTempFiles(pappl_client_t *client) _PAPPL_PRIVATE;
+extern bool		_papplClientCopyBlob(pappl_client_t *client, _pappl_blob_t *blob, ipp_tag_t group_tag, cups_array_t *ra) _PAPPL_PRIVATE;
 extern pappl_client_t	*_papplClientCreate(pappl_system_t *system, int sock) _PAPPL_PRIVATE;
 extern char		*_papplClientCreateTempFile(pappl_client_t *client, const void *data, size_t datasize) _PAPPL_PRIVATE;
 extern void		_papplClientDelete(pappl_client_t *client) _PAPPL_PRIVATE;
 extern void		_papplClientFlushDocumentData(pappl_client_t *client) _PAPPL_PRIVATE;
+extern void		_papplClientFlushHTML(pappl_client_t *client) _PAPPL_PRIVATE;
 extern bool		_papplClientHaveDocumentData(pappl_client_t *client) _PAPPL_PRIVATE;
 extern bool		_papplClientProcessHTTP(pappl_client_t *client) _PAPPL_PRIVATE;
 extern bool		_papplClientProcessIPP(pappl_client_t *client) _PAPPL_PRIVATE;
 extern void		*_papplClientRun(pappl_client_t *client) _PAPPL_PRIVATE;
+extern bool		_papplClientWriteIPP(pappl_client_t *client) _PAPPL_PRIVATE;
 extern void		_papplClientHTMLInfo(pappl_client_t *client, bool is_form, const char *dns_sd_name, const char *location, const char *geo_location, const char *organization, const char *org_unit, pappl_contact_t *contact);
 extern void		_papplClientHTMLPutLinks(pappl_client_t *client, cups_array_t *links, pappl_loptions_t which);
 
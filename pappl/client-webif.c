@@ -14,6 +14,31 @@
 
 #include "pappl-private.h"
 #include <math.h>
+#include <stdint.h>
+
+
+//
+// Local functions...
+//
+
+static size_t	html_span(const char *s, const char *end);
+static void	html_write(pappl_client_t *client, const char *s, size_t len);
+
+
+//
+// '_papplClientFlushHTML()' - Send any buffered HTML output to the client.
+//
+
+void
+_papplClientFlushHTML(
+    pappl_client_t *client)		// I - Client
+{
+  if (client->htmlused > 0)
+  {
+    httpWrite2(client->http, client->htmlbuf, client->htmlused);
+    client->htmlused = 0;
+  }
+}
 
 
 //
@@ -403,10 +428,8 @@ papplClientHTMLAuthorize(
     pappl_client_t *client)		// I - Client
 {
   char		auth_cookie[65],	// Authorization cookie
-		session_key[65],	// Current session key
 		password_hash[100],	// Password hash
 		auth_text[256];		// Authorization string
-  unsigned char	auth_hash[32];		// Authorization hash
   const char	*status = NULL;		// Status message, if any
 
 
@@ -431,9 +454,7 @@ papplClientHTMLAuthorize(
   // Otherwise look for the authorization cookie...
   if (papplClientGetCookie(client, "auth", auth_cookie, sizeof(auth_cookie)))
   {
-    snprintf(auth_text, sizeof(auth_text), "%s:%s", papplSystemGetSessionKey(client->system, session_key, sizeof(session_key)), papplSystemGetPassword(client->system, password_hash, sizeof(password_hash)));
-    cupsHashData("sha2-256", (unsigned char *)auth_text, strlen(auth_text), auth_hash, sizeof(auth_hash));
-    cupsHashString(auth_hash, sizeof(auth_hash), auth_text, sizeof(auth_text));
+    _papplSystemGetAuthCookie(client->system, auth_text, sizeof(auth_text));
 
     if (!strcmp(auth_cookie, auth_text))
     {
@@ -472,12 +493,9 @@ papplClientHTMLAuthorize(
 
       if (!strncmp(password_hash, auth_text, strlen(password_hash)))
       {
-        // Password hashes match, generate the cookie from the session key and
+        // Password hashes match, set the cookie from the session key and
         // password hash...
-
-	snprintf(auth_text, sizeof(auth_text), "%s:%s", papplSystemGetSessionKey(client->system, session_key, sizeof(session_key)), password_hash);
-	cupsHashData("sha2-256", (unsigned char *)auth_text, strlen(auth_text), auth_hash, sizeof(auth_hash));
-	cupsHashString(auth_hash, sizeof(auth_hash), auth_text, sizeof(auth_text));
+        _papplSystemGetAuthCookie(client->system, auth_text, sizeof(auth_text));
 
         papplClientSetCookie(client, "auth", auth_text, 3600);
       }
@@ -539,35 +557,33 @@ papplClientHTMLEscape(
     const char     *s,			// I - String to write
     size_t         slen)		// I - Number of characters to write (`0` for nul-terminated)
 {
-  const char	*start,			// Start of segment
-		*end;			// End of string
+  const char	*end;			// End of string
+  size_t	len;			// Length of unescaped run
 
 
-  start = s;
-  end   = s + (slen > 0 ? slen : strlen(s));
+  end = s + (slen > 0 ? slen : strlen(s));
 
-  while (*s && s < end)
+  while (s < end)
   {
-    if (*s == '&' || *s == '<' || *s == '\"')
+    // Copy characters up to the next one that needs escaping...
+    if ((len = html_span(s, end)) > 0)
     {
-      if (s > start)
-        httpWrite2(client->http, start, (size_t)(s - start));
+      html_write(client, s, len);
+      s += len;
+    }
 
-      if (*s == '&')
-        httpWrite2(client->http, "&amp;", 5);
-      else if (*s == '<')
-        httpWrite2(client->http, "&lt;", 4);
-      else
-        httpWrite2(client->http, "&quot;", 6);
+    if (s >= end || !*s)
+      break;
 
-      start = s + 1;
-    }
+    if (*s == '&')
+      html_write(client, "&amp;", 5);
+    else if (*s == '<')
+      html_write(client, "&lt;", 4);
+    else
+      html_write(client, "&quot;", 6);
 
     s ++;
   }
-
-  if (s > start)
-    httpWrite2(client->http, start, (size_t)(s - start));
 }
 
 
@@ -603,6 +619,7 @@ papplClientHTMLFooter(
   papplClientHTMLPuts(client,
 		      "  </body>\n"
 		      "</html>\n");
+  _papplClientFlushHTML(client);
   httpWrite2(client->http, "", 0);
 }
 
@@ -975,14 +992,14 @@ papplClientHTMLPrintf(
     if (*format == '%')
     {
       if (format > start)
-        httpWrite2(client->http, start, (size_t)(format - start));
+        html_write(client, start, (size_t)(format - start));
 
       tptr    = tformat;
       *tptr++ = *format++;
 
       if (*format == '%')
       {
-        httpWrite2(client->http, "%", 1);
+        html_write(client, "%", 1);
         format ++;
 	start = format;
 	continue;
@@ -1089,7 +1106,7 @@ papplClientHTMLPrintf(
 
 	    snprintf(temp, sizeof(temp), tformat, va_arg(ap, double));
 
-            httpWrite2(client->http, temp, strlen(temp));
+            html_write(client, temp, strlen(temp));
 	    break;
 
         case 'B' : // Integer formats
@@ -1113,7 +1130,7 @@ papplClientHTMLPrintf(
 	    else
 	      snprintf(temp, sizeof(temp), tformat, va_arg(ap, int));
 
-            httpWrite2(client->http, temp, strlen(temp));
+            html_write(client, temp, strlen(temp));
 	    break;
 
 	case 'p' : // Pointer value
@@ -1122,7 +1139,7 @@ papplClientHTMLPrintf(
 
 	    snprintf(temp, sizeof(temp), tformat, va_arg(ap, void *));
 
-            httpWrite2(client->http, temp, strlen(temp));
+            html_write(client, temp, strlen(temp));
 	    break;
 
         case 'c' : // Character or character array
@@ -1149,7 +1166,7 @@ papplClientHTMLPrintf(
   }
 
   if (format > start)
-    httpWrite2(client->http, start, (size_t)(format - start));
+    html_write(client, start, (size_t)(format - start));
 
   va_end(ap);
 }
@@ -1208,7 +1225,7 @@ papplClientHTMLPuts(
     const char     *s)			// I - String
 {
   if (client && s && *s)
-    httpWrite2(client->http, s, strlen(s));
+    html_write(client, s, strlen(s));
 }
 
 
@@ -1324,3 +1341,88 @@ papplClientSetCookie(
     httpSetCookie(client->http, buffer);
   }
 }
+
+
+//
+// 'html_span()' - Return the number of characters that need no escaping.
+//
+// The string is checked a word at a time for nul, "&", "<", and '"'
+// characters, falling back to single characters at the end of the string or
+// when a word contains one of them.
+//
+
+static size_t				// O - Number of characters
+html_span(const char *s,		// I - Start of string
+          const char *end)		// I - End of string
+{
+  const char	*start = s;		// Start of string
+  uint64_t	word;			// Current word
+
+
+#define HAS_ZERO(v)	(((v) - 0x0101010101010101ULL) & ~(v) & 0x8080808080808080ULL)
+#define HAS_BYTE(v,c)	HAS_ZERO((v) ^ (0x0101010101010101ULL * (unsigned char)(c)))
+
+  while ((end - s) >= 8)
+  {
+    memcpy(&word, s, sizeof(word));
+
+    if (HAS_ZERO(word) || HAS_BYTE(word, '&') || HAS_BYTE(word, '<') || HAS_BYTE(word, '"'))
+      break;
+
+    s += 8;
+  }
+
+#undef HAS_ZERO
+#undef HAS_BYTE
+
+  while (s < end && *s && *s != '&' && *s != '<' && *s != '"')
+    s ++;
+
+  return ((size_t)(s - start));
+}
+
+
+//
+// 'html_write()' - Add HTML output to the client buffer.
+//
+// The buffer grows as needed up to `_PAPPL_HTML_BUFMAX` bytes and is then sent
+// to the client, so that a page is written using a few large writes rather
+// than many small ones.
+//
+
+static void
+html_write(pappl_client_t *client,	// I - Client
+           const char     *s,		// I - Output data
+           size_t         len)		// I - Length of output data
+{
+  char		*buffer;		// New buffer
+  size_t	bufsize;		// New buffer size
+
+
+  if ((client->htmlused + len) > client->htmlsize)
+  {
+    // Grow the buffer...
+    for (bufsize = client->htmlsize ? client->htmlsize : _PAPPL_HTML_BUFMIN; bufsize < (client->htmlused + len) && bufsize < _PAPPL_HTML_BUFMAX; bufsize *= 2);
+
+    if (bufsize > client->htmlsize && (buffer = (char *)realloc(client->htmlbuf, bufsize)) != NULL)
+    {
+      client->htmlbuf  = buffer;
+      client->htmlsize = bufsize;
+    }
+
+    if ((client->htmlused + len) > client->htmlsize)
+    {
+      // Still too big, send what we have...
+      _papplClientFlushHTML(client);
+
+      if (len > client->htmlsize)
+      {
+        httpWrite2(client->http, s, len);
+        return;
+      }
+    }
+  }
+
+  memcpy(client->htmlbuf + client->htmlused, s, len);
+  client->htmlused += len;
+}
@@ -15,11 +15,21 @@
 #include "pappl-private.h"
 
 
+//
+// Local constants...
+//
+
+#define _PAPPL_CLIENT_COPY_SIZE	65536	// Size of file copy buffer
+#define _PAPPL_CLIENT_COMPRESS_MIN 1024	// Minimum size of compressed content
+
+
 //
 // Local functions...
 //
 
 static bool	eval_if_modified(pappl_client_t *client, _pappl_resource_t *r);
+static const char *get_content_encoding(pappl_client_t *client, const char *format, size_t length);
+static bool	respond_resource(pappl_client_t *client, _pappl_resource_t *r, const void *data, size_t length);
 
 
 //
@@ -164,6 +174,10 @@ _papplClientDelete(
   ippDelete(client->request);
   ippDelete(client->response);
 
+  _papplClientCleanSplices(client);
+  free(client->splices);
+  free(client->htmlbuf);
+
   free(client);
 }
 
@@ -212,6 +226,7 @@ _papplClientProcessHTTP(
   // Clear state variables...
   ippDelete(client->request);
   ippDelete(client->response);
+  _papplClientCleanSplices(client);
 
   client->request   = NULL;
   client->response  = NULL;
@@ -271,6 +286,8 @@ _papplClientProcessHTTP(
 
   papplLogClient(client, PAPPL_LOGLEVEL_INFO, "%s %s://%s%s HTTP/%d.%d", http_states[http_state], httpIsEncrypted(client->http) ? "https" : "http", httpGetField(client->http, HTTP_FIELD_HOST), uri, http_version / 100, http_version % 100);
 
+  _PAPPL_TRACE(PAPPL_TRACE_HTTP_REQUEST, http__request, client->uri, client->number, (size_t)http_state);
+
   // Validate the host header...
   if (!httpGetField(client->http, HTTP_FIELD_HOST)[0] &&
       httpGetVersion(client->http) >= HTTP_VERSION_1_1)
@@ -377,42 +394,77 @@ _papplClientProcessHTTP(
           else if (resource->cb)
           {
             // Send output of a callback...
-            return ((resource->cb)(client, resource->cbdata));
+            bool ret = (resource->cb)(client, resource->cbdata);
+					// Return value from callback
+
+            _papplClientFlushHTML(client);
+            return (ret);
 	  }
 	  else if (resource->filename)
 	  {
 	    // Send an external file...
+	    const void	*data;		// Cached file data
+	    size_t	length;		// Length of cached data
 	    int		fd;		// Resource file descriptor
-	    char	buffer[8192];	// Copy buffer
+	    struct stat	fileinfo;	// Resource file information
+	    char	*buffer;	// Copy buffer
 	    ssize_t	bytes;		// Bytes read/written
+	    off_t	remaining;	// Bytes remaining
+
+            if ((data = _papplSystemCacheResource(client->system, resource, &length)) != NULL)
+            {
+              // Send the cached copy of a small file...
+              return (respond_resource(client, resource, data, length));
+            }
 
             if ((fd = open(resource->filename, O_RDONLY)) >= 0)
 	    {
-	      if (!papplClientRespond(client, HTTP_STATUS_OK, NULL, resource->format, resource->last_modified, 0))
+	      const char *encoding;	// Content-Encoding, if any
+
+	      // Send the file with a Content-Length so that the connection can
+	      // be kept alive without chunking, unless we are compressing it or
+	      // the file is empty (a length of 0 means chunked)...
+	      if (fstat(fd, &fileinfo) || (buffer = malloc(_PAPPL_CLIENT_COPY_SIZE)) == NULL)
 	      {
+	        close(fd);
+	        return (papplClientRespond(client, HTTP_STATUS_SERVER_ERROR, NULL, NULL, 0, 0));
+	      }
+
+              encoding = get_content_encoding(client, resource->format, (size_t)fileinfo.st_size);
+
+	      if (!papplClientRespond(client, HTTP_STATUS_OK, encoding, resource->format, resource->last_modified, encoding ? 0 : (size_t)fileinfo.st_size))
+	      {
+	        free(buffer);
 	        close(fd);
 		return (false);
 	      }
 
-              while ((bytes = read(fd, buffer, sizeof(buffer))) > 0)
-                httpWrite2(client->http, buffer, (size_t)bytes);
+              for (remaining = fileinfo.st_size; remaining > 0; remaining -= bytes)
+              {
+                if ((bytes = read(fd, buffer, remaining > _PAPPL_CLIENT_COPY_SIZE ? _PAPPL_CLIENT_COPY_SIZE : (size_t)remaining)) <= 0)
+                  break;
+
+                if (httpWrite2(client->http, buffer, (size_t)bytes) < bytes)
+                  break;
+	      }
 
-	      httpWrite2(client->http, "", 0);
+              if (encoding || fileinfo.st_size == 0)
+                httpWrite2(client->http, "", 0);
+              else
+	        httpFlushWrite(client->http);
 
+	      free(buffer);
 	      close(fd);
 
-	      return (true);
+	      // If the file was truncated while we were sending it, close the
+	      // connection since the client is still waiting for data...
+	      return (remaining == 0);
 	    }
 	  }
 	  else
 	  {
 	    // Send a static resource file...
-	    if (!papplClientRespond(client, HTTP_STATUS_OK, NULL, resource->format, resource->last_modified, resource->length))
-	      return (false);
-
-	    httpWrite2(client->http, (const char *)resource->data, resource->length);
-	    httpFlushWrite(client->http);
-	    return (true);
+	    return (respond_resource(client, resource, resource->data, resource->length));
 	  }
 	}
 
@@ -444,7 +496,11 @@ _papplClientProcessHTTP(
           if (resource->cb)
           {
             // Handle a post request through the callback...
-            return ((resource->cb)(client, resource->cbdata));
+            bool ret = (resource->cb)(client, resource->cbdata);
+					// Return value from callback
+
+            _papplClientFlushHTML(client);
+            return (ret);
           }
           else
           {
@@ -578,9 +634,7 @@ papplClientRespond(
     // Send an IPP response...
     _papplLogAttributes(client, ippOpString(client->operation_id), client->response, true);
 
-    ippSetState(client->response, IPP_STATE_IDLE);
-
-    if (ippWrite(client->http, client->response) != IPP_STATE_DATA)
+    if (!_papplClientWriteIPP(client))
       return (false);
   }
 
@@ -641,7 +695,9 @@ void *					// O - Exit status
 _papplClientRun(
     pappl_client_t *client)		// I - Client
 {
-  int first_time = 1;			// First time request?
+  int		first_time = 1;		// First time request?
+  bool		ret;			// Result of request
+  double	start;			// Start time of request
 
 
   // Loop until we are out of requests or timeout (30 seconds)...
@@ -668,7 +724,12 @@ _papplClientRun(
       first_time = 0;
     }
 
-    if (!_papplClientProcessHTTP(client))
+    start = _papplGetTime();
+    ret   = _papplClientProcessHTTP(client);
+
+    _papplSystemAddMetricHTTP(client->system, client->operation, _papplGetTime() - start);
+
+    if (!ret)
       break;
 
     _papplClientCleanTempFiles(client);
@@ -737,3 +798,60 @@ eval_if_modified(
   // Return the evaluation based on the last modified date, time, and size...
   return ((size != 0 && size != (off_t)r->length) || (date != 0 && date < r->last_modified) || (size == 0 && date == 0));
 }
+
+
+//
+// 'get_content_encoding()' - Choose a Content-Encoding for a resource.
+//
+// Only text-based content that is large enough to benefit is compressed, and
+// only when the client's "Accept-Encoding" header allows it.  The compression
+// itself is done by libcups as the response is written.
+//
+
+static const char *			// O - Content-Encoding or `NULL` for none
+get_content_encoding(
+    pappl_client_t *client,		// I - Client
+    const char     *format,		// I - MIME media type of content
+    size_t         length)		// I - Length of content
+{
+  if (length < _PAPPL_CLIENT_COMPRESS_MIN || !format)
+    return (NULL);
+
+  if (strncmp(format, "text/", 5) && strcmp(format, "application/javascript") && strcmp(format, "application/json") && strcmp(format, "image/svg+xml"))
+    return (NULL);
+
+  return (httpGetContentEncoding(client->http));
+}
+
+
+//
+// 'respond_resource()' - Send the contents of a static or cached resource.
+//
+
+static bool				// O - `true` on success, `false` on error
+respond_resource(
+    pappl_client_t    *client,		// I - Client
+    _pappl_resource_t *r,		// I - Resource
+    const void        *data,		// I - Resource data
+    size_t            length)		// I - Length of resource data
+{
+  const char	*encoding;		// Content-Encoding, if any
+
+
+  // Compressed content is sent using chunking since the final length is not
+  // known in advance...
+  encoding = get_content_encoding(client, r->format, length);
+
+  if (!papplClientRespond(client, HTTP_STATUS_OK, encoding, r->format, r->last_modified, encoding ? 0 : length))
+    return (false);
+
+  if (length > 0)
+    httpWrite2(client->http, (const char *)data, length);
+
+  if (encoding || length == 0)
+    httpWrite2(client->http, "", 0);
+  else
+    httpFlushWrite(client->http);
+
+  return (true);
+}
@@ -13,6 +13,7 @@
 //
 
 #include "device-private.h"
+#include "log-private.h"
 #include "printer.h"
 #include <stdarg.h>
 
@@ -269,6 +270,8 @@ papplDeviceFlush(pappl_device_t *device)// I - Device
 {
   if (device && device->bufused > 0)
   {
+    _PAPPL_TRACE(PAPPL_TRACE_DEVICE_FLUSH, device__flush, NULL, 0, device->bufused);
+
     pappl_write(device, device->buffer, device->bufused);
     device->bufused = 0;
   }
@@ -598,10 +601,14 @@ papplDeviceOpen(
 
   if (!(ds->open_cb)(device, device_uri, name))
   {
+    _PAPPL_TRACE(PAPPL_TRACE_DEVICE_OPEN, device__open, device_uri, 0, 0);
+
     free(device);
     return (NULL);
   }
 
+  _PAPPL_TRACE(PAPPL_TRACE_DEVICE_OPEN, device__open, device_uri, 0, 1);
+
   return (device);
 }
 
@@ -857,5 +864,7 @@ pappl_write(pappl_device_t *device,	// I - Device
   if (count > 0)
     device->metrics.write_bytes += (size_t)count;
 
+  _PAPPL_TRACE(PAPPL_TRACE_DEVICE_WRITE, device__write, NULL, 0, count > 0 ? (size_t)count : 0);
+
   return (count);
 }
@@ -19,6 +19,8 @@
 // Constants...
 //
 
+#define _PAPPL_DNSSD_DELAY	250000	// Microseconds to wait for more changes
+
 #ifdef HAVE_AVAHI
 #  define AVAHI_DNS_TYPE_LOC 29		// Per RFC 1876
 #endif // HAVE_AVAHI
@@ -293,9 +295,47 @@ _papplDNSSDUnlock(void)
 }
 
 
+//
+// '_papplPrinterQueueDNSSDNoLock()' - Queue a printer's DNS-SD registration.
+//
+// The DNS-SD worker thread registers the printer after a short delay so that
+// a burst of changes results in a single update.  If the worker is not running
+// the printer is registered immediately.
+//
+
+void
+_papplPrinterQueueDNSSDNoLock(
+    pappl_printer_t *printer)		// I - Printer
+{
+  pappl_system_t	*system = printer->system;
+					// System
+
+
+  pthread_mutex_lock(&system->dns_sd_mutex);
+
+  if (system->dns_sd_worker)
+  {
+    printer->dns_sd_pending = true;
+    system->dns_sd_changes ++;
+
+    pthread_cond_signal(&system->dns_sd_cond);
+    pthread_mutex_unlock(&system->dns_sd_mutex);
+  }
+  else
+  {
+    pthread_mutex_unlock(&system->dns_sd_mutex);
+
+    _papplPrinterRegisterDNSSDNoLock(printer);
+  }
+}
+
+
 //
 // '_papplPrinterRegisterDNSSDNoLock()' - Register a printer's DNS-SD service.
 //
+// Nothing is registered if the services and TXT records are unchanged since
+// the last successful registration.
+//
 
 bool					// O - `true` on success, `false` on failure
 _papplPrinterRegisterDNSSDNoLock(
@@ -308,6 +348,7 @@ _papplPrinterRegisterDNSSDNoLock(
   _pappl_txt_t		txt;		// DNS-SD TXT record
   int			i,		// Looping var
 			count;		// Number of values
+  ipp_t			*driver_attrs;	// Driver attributes
   ipp_attribute_t	*color_supported,
 			*document_format_supported,
 			*printer_kind,
@@ -321,6 +362,8 @@ _papplPrinterRegisterDNSSDNoLock(
 			*ptr;		// Pointer into string
   char			regtype[256];	// DNS-SD service type
   char			product[248];	// Make and model (legacy)
+  char			flags[256];	// Other values for hash
+  unsigned		hash;		// Hash of services and TXT records
   int			max_width;	// Maximum media width (legacy)
   const char		*papermax;	// PaperMax string value (legacy)
 #  ifdef HAVE_DNSSD
@@ -338,11 +381,12 @@ _papplPrinterRegisterDNSSDNoLock(
   papplLogPrinter(printer, PAPPL_LOGLEVEL_DEBUG, "Registering DNS-SD name '%s' on '%s'", printer->dns_sd_name, printer->system->hostname);
 
   // Get attributes and values for the TXT record...
-  color_supported           = ippFindAttribute(printer->driver_attrs, "color-supported", IPP_TAG_BOOLEAN);
-  document_format_supported = ippFindAttribute(printer->driver_attrs, "document-format-supported", IPP_TAG_MIMETYPE);
-  printer_kind              = ippFindAttribute(printer->driver_attrs, "printer-kind", IPP_TAG_KEYWORD);
+  driver_attrs              = _papplPrinterGetDriverAttrsNoLock(printer);
+  color_supported           = ippFindAttribute(driver_attrs, "color-supported", IPP_TAG_BOOLEAN);
+  document_format_supported = ippFindAttribute(driver_attrs, "document-format-supported", IPP_TAG_MIMETYPE);
+  printer_kind              = ippFindAttribute(driver_attrs, "printer-kind", IPP_TAG_KEYWORD);
   printer_uuid              = ippFindAttribute(printer->attrs, "printer-uuid", IPP_TAG_URI);
-  urf_supported             = ippFindAttribute(printer->driver_attrs, "urf-supported", IPP_TAG_KEYWORD);
+  urf_supported             = ippFindAttribute(driver_attrs, "urf-supported", IPP_TAG_KEYWORD);
 
   for (i = 0, count = ippGetCount(document_format_supported), ptr = formats; i < count; i ++)
   {
@@ -463,6 +507,31 @@ _papplPrinterRegisterDNSSDNoLock(
     }
   }
 
+  // See if anything has changed since the last registration...
+  snprintf(flags, sizeof(flags), "%s:%d:%d:%d:%d:%d:%s", system->hostname, system->port, ippGetBoolean(color_supported, 0), printer->driver_data.sides_supported, printer->num_listeners, system->options, system->subtypes ? system->subtypes : "");
+
+  hash = _papplHashString(printer->dns_sd_name, _PAPPL_HASH_INIT);
+  hash = _papplHashString(printer->resource, hash);
+  hash = _papplHashString(printer->location ? printer->location : "", hash);
+  hash = _papplHashString(printer->geo_location ? printer->geo_location : "", hash);
+  hash = _papplHashString(ippGetString(printer_uuid, 0, NULL), hash);
+  hash = _papplHashString(product, hash);
+  hash = _papplHashString(papermax, hash);
+  hash = _papplHashString(formats, hash);
+  hash = _papplHashString(kind, hash);
+  hash = _papplHashString(urf, hash);
+  hash = _papplHashString(flags, hash);
+
+  if (!hash)
+    hash = 1;
+
+  if (hash == printer->dns_sd_hash)
+  {
+    papplLogPrinter(printer, PAPPL_LOGLEVEL_DEBUG, "DNS-SD services for '%s' are unchanged.", printer->dns_sd_name);
+    _papplSystemAddMetricCount(system, _PAPPL_COUNTER_DNSSD_UNCHANGED, 1);
+    return (true);
+  }
+
   master = _papplDNSSDInit(printer->system);
 #endif // HAVE_DNSSD || HAVE_AVAHI
 
@@ -670,6 +739,7 @@ _papplPrinterRegisterDNSSDNoLock(
     papplLogPrinter(printer, PAPPL_LOGLEVEL_ERROR, "Unable to register printer, is the Avahi daemon running?");
     _papplDNSSDUnlock();
     avahi_string_list_free(txt);
+    printer->dns_sd_hash = 0;
     return (false);
   }
 
@@ -809,6 +879,13 @@ _papplPrinterRegisterDNSSDNoLock(
   _papplDNSSDUnlock();
 #endif // HAVE_DNSSD
 
+#if defined(HAVE_DNSSD) || defined(HAVE_AVAHI)
+  printer->dns_sd_hash = ret ? hash : 0;
+
+  if (ret)
+    _papplSystemAddMetricCount(system, _PAPPL_COUNTER_DNSSD_REGISTRATIONS, 1);
+#endif // HAVE_DNSSD || HAVE_AVAHI
+
   return (ret);
 }
 
@@ -821,6 +898,8 @@ void
 _papplPrinterUnregisterDNSSDNoLock(
     pappl_printer_t *printer)		// I - Printer
 {
+  printer->dns_sd_hash = 0;
+
 #if HAVE_DNSSD
   if (printer->dns_sd_printer_ref)
   {
@@ -855,9 +934,6 @@ _papplPrinterUnregisterDNSSDNoLock(
   }
 
   _papplDNSSDUnlock();
-
-#else
-  (void)printer;
 #endif /* HAVE_DNSSD */
 }
 
@@ -1050,6 +1126,70 @@ _papplSystemRegisterDNSSDNoLock(
 }
 
 
+//
+// '_papplSystemRunDNSSD()' - Run the DNS-SD worker thread.
+//
+// The worker registers printers with queued DNS-SD changes so that clients
+// and the main loop do not wait for the DNS-SD daemon.
+//
+
+void *					// O - Thread exit status
+_papplSystemRunDNSSD(
+    pappl_system_t *system)		// I - System
+{
+  pappl_printer_t	*printer;	// Current printer
+  size_t		changes = 0;	// Last number of changes
+
+
+  pthread_mutex_lock(&system->dns_sd_mutex);
+
+  for (;;)
+  {
+    // Wait for changes...
+    while (system->dns_sd_changes == changes && !system->dns_sd_stop)
+      pthread_cond_wait(&system->dns_sd_cond, &system->dns_sd_mutex);
+
+    if (system->dns_sd_stop)
+      break;
+
+    pthread_mutex_unlock(&system->dns_sd_mutex);
+
+    // Give other changes a chance to be queued...
+    usleep(_PAPPL_DNSSD_DELAY);
+
+    pthread_mutex_lock(&system->dns_sd_mutex);
+    changes = system->dns_sd_changes;
+    pthread_mutex_unlock(&system->dns_sd_mutex);
+
+    // Register the printers with queued changes...
+    pthread_rwlock_rdlock(&system->rwlock);
+
+    for (printer = (pappl_printer_t *)cupsArrayFirst(system->printers); printer; printer = (pappl_printer_t *)cupsArrayNext(system->printers))
+    {
+      if (!printer->dns_sd_pending)
+        continue;
+
+      pthread_rwlock_wrlock(&printer->rwlock);
+
+      printer->dns_sd_pending = false;
+
+      if (printer->dns_sd_name)
+        _papplPrinterRegisterDNSSDNoLock(printer);
+
+      pthread_rwlock_unlock(&printer->rwlock);
+    }
+
+    pthread_rwlock_unlock(&system->rwlock);
+
+    pthread_mutex_lock(&system->dns_sd_mutex);
+  }
+
+  pthread_mutex_unlock(&system->dns_sd_mutex);
+
+  return (NULL);
+}
+
+
 //
 // '_papplSystemUnregisterDNSSDNoLock()' - Unregister a printer's DNS-SD service.
 //
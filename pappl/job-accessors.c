@@ -153,6 +153,90 @@ papplJobGetImpressionsCompleted(
 }
 
 
+//
+// 'papplJobGetMetrics()' - Get the job timing metrics.
+//
+// This function returns a copy of the job timing metrics, which includes the
+// time in milliseconds the job spent waiting in the queue, opening the output
+// device, processing the document, in the driver's raster callbacks, writing
+// to the output device, and finishing the job.  Times for stages that are in
+// progress are reported up to the current time, while stages that have not
+// been reached are reported as `0`.  The device write time is only available
+// once processing has completed.
+//
+// @since PAPPL 1.1@
+//
+
+pappl_jmetrics_t *			// O - Metrics data
+papplJobGetMetrics(
+    pappl_job_t      *job,		// I - Job
+    pappl_jmetrics_t *metrics)		// I - Buffer for metrics data
+{
+  if (!metrics)
+    return (NULL);
+
+  if (job)
+  {
+    pthread_rwlock_rdlock(&job->rwlock);
+    _papplJobGetMetricsNoLock(job, metrics);
+    pthread_rwlock_unlock(&job->rwlock);
+  }
+  else
+    memset(metrics, 0, sizeof(pappl_jmetrics_t));
+
+  return (metrics);
+}
+
+
+//
+// '_papplJobGetMetricsNoLock()' - Get the job timing metrics without locking.
+//
+
+void
+_papplJobGetMetricsNoLock(
+    pappl_job_t      *job,		// I - Job
+    pappl_jmetrics_t *metrics)		// I - Buffer for metrics data
+{
+  double	now = _papplGetTime();	// Current time
+  bool		active = job->state < IPP_JSTATE_CANCELED;
+					// Is the job active?
+
+
+  memset(metrics, 0, sizeof(pappl_jmetrics_t));
+
+  if (job->queued <= 0.0)
+    return;
+
+  if (job->opening > 0.0)
+    metrics->wait_msecs = 1000.0 * (job->opening - job->queued);
+  else if (active)
+    metrics->wait_msecs = 1000.0 * (now - job->queued);
+
+  if (job->started > 0.0)
+    metrics->device_msecs = 1000.0 * (job->started - job->opening);
+  else if (job->opening > 0.0 && active)
+    metrics->device_msecs = 1000.0 * (now - job->opening);
+
+  if (job->finishing > 0.0)
+  {
+    metrics->process_msecs = 1000.0 * (job->finishing - job->started);
+    metrics->write_msecs   = (double)job->write_msecs;
+  }
+  else if (job->started > 0.0 && active)
+    metrics->process_msecs = 1000.0 * (now - job->started);
+
+  metrics->driver_msecs = 1000.0 * job->driver_secs;
+
+  if (job->finished > 0.0)
+  {
+    metrics->finish_msecs = 1000.0 * (job->finished - job->finishing);
+    metrics->total_msecs  = 1000.0 * (job->finished - job->queued);
+  }
+  else if (active)
+    metrics->total_msecs = 1000.0 * (now - job->queued);
+}
+
+
 //
 // 'papplJobGetMessage()' - Get the current job message string, if any.
 //
@@ -441,6 +525,8 @@ _papplJobSetState(pappl_job_t  *job,	// I - Job
 
     job->state = state;
 
+    _PAPPL_TRACE(PAPPL_TRACE_JOB_STATE, job__state, job->printer->name, job->job_id, (size_t)state);
+
     if (state == IPP_JSTATE_PROCESSING)
     {
       job->processing = time(NULL);
@@ -13,6 +13,8 @@
 
 #include "pappl.h"
 #include "job-private.h"
+#include "log-private.h"
+#include "printer-private.h"
 #ifdef HAVE_LIBJPEG
 #  include <setjmp.h>
 #  include <jpeglib.h>
@@ -102,6 +104,9 @@ papplJobFilterImage(
 			xmod,		// X modulus
 			xstep,		// X step
 			ydir;		// Y direction
+  bool			ret;		// Driver callback result
+  double		start,		// Start time of driver callback
+			line_secs = 0.0;// Time spent in line callbacks
 
 
   // TODO: Implement interpolation (Issue #64)
@@ -331,7 +336,12 @@ papplJobFilterImage(
   }
 
   // Start the job...
-  if (!(driver_data.rstartjob_cb)(job, options, device))
+  start = _papplGetTime();
+  ret   = (driver_data.rstartjob_cb)(job, options, device);
+
+  _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+  if (!ret)
   {
     papplLogJob(job, PAPPL_LOGLEVEL_ERROR, "Unable to start raster job.");
     goto abort_job;
@@ -347,7 +357,14 @@ papplJobFilterImage(
   // Print every copy...
   for (i = 0; i < options->copies; i ++)
   {
-    if (!(driver_data.rstartpage_cb)(job, options, device, 1))
+    _PAPPL_TRACE(PAPPL_TRACE_PAGE_START, page__start, job->printer->name, job->job_id, 1);
+
+    start = _papplGetTime();
+    ret   = (driver_data.rstartpage_cb)(job, options, device, 1);
+
+    _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+    if (!ret)
     {
       papplLogJob(job, PAPPL_LOGLEVEL_ERROR, "Unable to start raster page.");
       goto abort_job;
@@ -355,13 +372,16 @@ papplJobFilterImage(
 
     // Leading blank space...
     memset(line, white, options->header.cupsBytesPerLine);
-    for (y = 0; y < ystart; y ++)
+
+    for (y = 0, ret = true, start = _papplGetTime(); y < ystart && ret; y ++)
+      ret = (driver_data.rwriteline_cb)(job, options, device, (unsigned)y, line);
+
+    _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+    if (!ret)
     {
-      if (!(driver_data.rwriteline_cb)(job, options, device, (unsigned)y, line))
-      {
-	papplLogJob(job, PAPPL_LOGLEVEL_ERROR, "Unable to write raster line %u.", y);
-	goto abort_job;
-      }
+      papplLogJob(job, PAPPL_LOGLEVEL_ERROR, "Unable to write raster line %u.", y - 1);
+      goto abort_job;
     }
 
     // Now RIP the image...
@@ -459,26 +479,45 @@ papplJobFilterImage(
 	}
       }
 
-      if (!(driver_data.rwriteline_cb)(job, options, device, (unsigned)y, line))
+      start = _papplGetTime();
+      ret   = (driver_data.rwriteline_cb)(job, options, device, (unsigned)y, line);
+
+      line_secs += _papplGetTime() - start;
+
+      if (!ret)
       {
 	papplLogJob(job, PAPPL_LOGLEVEL_ERROR, "Unable to write raster line %u.", y);
+	_papplJobAddDriverTime(job, line_secs);
 	goto abort_job;
       }
     }
 
+    // Record the time for all of the image lines at once...
+    _papplJobAddDriverTime(job, line_secs);
+
     // Trailing blank space...
     memset(line, white, options->header.cupsBytesPerLine);
-    for (; y < (int)options->header.cupsHeight; y ++)
+
+    for (ret = true, start = _papplGetTime(); y < (int)options->header.cupsHeight && ret; y ++)
+      ret = (driver_data.rwriteline_cb)(job, options, device, (unsigned)y, line);
+
+    _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+    if (!ret)
     {
-      if (!(driver_data.rwriteline_cb)(job, options, device, (unsigned)y, line))
-      {
-	papplLogJob(job, PAPPL_LOGLEVEL_ERROR, "Unable to write raster line %u.", y);
-	goto abort_job;
-      }
+      papplLogJob(job, PAPPL_LOGLEVEL_ERROR, "Unable to write raster line %u.", y - 1);
+      goto abort_job;
     }
 
     // End the page...
-    if (!(driver_data.rendpage_cb)(job, options, device, 1))
+    start = _papplGetTime();
+    ret   = (driver_data.rendpage_cb)(job, options, device, 1);
+
+    _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+    _PAPPL_TRACE(PAPPL_TRACE_PAGE_END, page__end, job->printer->name, job->job_id, 1);
+
+    if (!ret)
     {
       papplLogJob(job, PAPPL_LOGLEVEL_ERROR, "Unable to end raster page.");
       goto abort_job;
@@ -488,7 +527,12 @@ papplJobFilterImage(
   }
 
   // End the job...
-  if (!(driver_data.rendjob_cb)(job, options, device))
+  start = _papplGetTime();
+  ret   = (driver_data.rendjob_cb)(job, options, device);
+
+  _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+  if (!ret)
   {
     papplLogJob(job, PAPPL_LOGLEVEL_ERROR, "Unable to end raster job.");
     goto abort_job;
@@ -45,14 +45,14 @@ void
 _papplJobCopyAttributes(
     pappl_client_t *client,		// I - Client
     pappl_job_t    *job,		// I - Job
-    cups_array_t   *ra)			// I - requested-attributes
+    _pappl_ra_t    *ra)			// I - requested-attributes or `NULL` for all
 {
-  _papplCopyAttributes(client->response, job->attrs, ra, IPP_TAG_JOB, 0);
+  _papplCopyAttributes(client->response, job->attrs, ra ? ra->array : NULL, IPP_TAG_JOB, 0);
 
-  if (!ra || cupsArrayFind(ra, "date-time-at-creation"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_DATE_TIME_AT_CREATION))
     ippAddDate(client->response, IPP_TAG_JOB, "date-time-at-creation", ippTimeToDate(job->created));
 
-  if (!ra || cupsArrayFind(ra, "date-time-at-completed"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_DATE_TIME_AT_COMPLETED))
   {
     if (job->completed)
       ippAddDate(client->response, IPP_TAG_JOB, "date-time-at-completed", ippTimeToDate(job->completed));
@@ -60,7 +60,7 @@ _papplJobCopyAttributes(
       ippAddOutOfBand(client->response, IPP_TAG_JOB, IPP_TAG_NOVALUE, "date-time-at-completed");
   }
 
-  if (!ra || cupsArrayFind(ra, "date-time-at-processing"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_DATE_TIME_AT_PROCESSING))
   {
     if (job->processing)
       ippAddDate(client->response, IPP_TAG_JOB, "date-time-at-processing", ippTimeToDate(job->processing));
@@ -68,19 +68,19 @@ _papplJobCopyAttributes(
       ippAddOutOfBand(client->response, IPP_TAG_JOB, IPP_TAG_NOVALUE, "date-time-at-processing");
   }
 
-  if (!ra || cupsArrayFind(ra, "job-impressions"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_JOB_IMPRESSIONS))
     ippAddInteger(client->response, IPP_TAG_JOB, IPP_TAG_INTEGER, "job-impressions", job->impressions);
 
-  if (!ra || cupsArrayFind(ra, "job-impressions-completed"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_JOB_IMPRESSIONS_COMPLETED))
     ippAddInteger(client->response, IPP_TAG_JOB, IPP_TAG_INTEGER, "job-impressions-completed", job->impcompleted);
 
-  if (!ra || cupsArrayFind(ra, "job-printer-up-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_JOB_PRINTER_UP_TIME))
     ippAddInteger(client->response, IPP_TAG_JOB, IPP_TAG_INTEGER, "job-printer-up-time", (int)(time(NULL) - client->printer->start_time));
 
-  if (!ra || cupsArrayFind(ra, "job-state"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_JOB_STATE))
     ippAddInteger(client->response, IPP_TAG_JOB, IPP_TAG_ENUM, "job-state", (int)job->state);
 
-  if (!ra || cupsArrayFind(ra, "job-state-message"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_JOB_STATE_MESSAGE))
   {
     if (job->message)
     {
@@ -129,7 +129,7 @@ _papplJobCopyAttributes(
     }
   }
 
-  if (!ra || cupsArrayFind(ra, "job-state-reasons"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_JOB_STATE_REASONS))
   {
     if (job->state_reasons)
     {
@@ -186,14 +186,51 @@ _papplJobCopyAttributes(
     }
   }
 
-  if (!ra || cupsArrayFind(ra, "time-at-creation"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_TIME_AT_CREATION))
     ippAddInteger(client->response, IPP_TAG_JOB, IPP_TAG_INTEGER, "time-at-creation", (int)(job->created - client->printer->start_time));
 
-  if (!ra || cupsArrayFind(ra, "time-at-completed"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_TIME_AT_COMPLETED))
     ippAddInteger(client->response, IPP_TAG_JOB, job->completed ? IPP_TAG_INTEGER : IPP_TAG_NOVALUE, "time-at-completed", (int)(job->completed - client->printer->start_time));
 
-  if (!ra || cupsArrayFind(ra, "time-at-processing"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_TIME_AT_PROCESSING))
     ippAddInteger(client->response, IPP_TAG_JOB, job->processing ? IPP_TAG_INTEGER : IPP_TAG_NOVALUE, "time-at-processing", (int)(job->processing - client->printer->start_time));
+
+  // Timing metrics are only returned when explicitly requested...
+  if (ra && ra->array && cupsArrayFind(ra->array, "smi2699-job-metrics-col"))
+  {
+    pappl_jmetrics_t	metrics;	// Job timing metrics
+    double		msecs[7];	// Times in milliseconds
+    ipp_t		*col;		// Collection value
+    size_t		i;		// Looping var
+    static const char * const names[7] =
+    {					// Member attribute names
+      "job-wait-msecs",
+      "job-device-open-msecs",
+      "job-processing-msecs",
+      "job-driver-msecs",
+      "job-device-write-msecs",
+      "job-finish-msecs",
+      "job-total-msecs"
+    };
+
+    _papplJobGetMetricsNoLock(job, &metrics);
+
+    msecs[0] = metrics.wait_msecs;
+    msecs[1] = metrics.device_msecs;
+    msecs[2] = metrics.process_msecs;
+    msecs[3] = metrics.driver_msecs;
+    msecs[4] = metrics.write_msecs;
+    msecs[5] = metrics.finish_msecs;
+    msecs[6] = metrics.total_msecs;
+
+    col = ippNew();
+
+    for (i = 0; i < (sizeof(names) / sizeof(names[0])); i ++)
+      ippAddInteger(col, IPP_TAG_JOB, IPP_TAG_INTEGER, names[i], msecs[i] > INT_MAX ? INT_MAX : (int)(msecs[i] + 0.5));
+
+    ippAddCollection(client->response, IPP_TAG_JOB, "smi2699-job-metrics-col", col);
+    ippDelete(col);
+  }
 }
 
 
@@ -210,7 +247,23 @@ _papplJobCopyDocumentData(
   char			filename[1024],	// Filename buffer
 			buffer[4096];	// Copy buffer
   ssize_t		bytes;		// Bytes read
-  cups_array_t		*ra;		// Attributes to send in response
+  size_t		total = 0;	// Total bytes written
+  _pappl_ra_t		ra;		// Attributes to send in response
+  static const char * const completed[] =
+  {					// Attributes for a completed job
+    "job-id",
+    "job-state",
+    "job-state-message",
+    "job-state-reasons",
+    "job-uri"
+  };
+  static const char * const aborted[] =
+  {					// Attributes for an aborted job
+    "job-id",
+    "job-state",
+    "job-state-reasons",
+    "job-uri"
+  };
 
 
   // If we have a PWG or Apple raster file, process it directly or return
@@ -224,7 +277,8 @@ _papplJobCopyDocumentData(
       return;
     }
 
-    job->state = IPP_JSTATE_PENDING;
+    job->state  = IPP_JSTATE_PENDING;
+    job->queued = _papplGetTime();
 
     _papplJobProcessRaster(job, client);
 
@@ -256,6 +310,8 @@ _papplJobCopyDocumentData(
 
       goto abort_job;
     }
+
+    total += (size_t)bytes;
   }
 
   if (bytes < 0)
@@ -286,6 +342,8 @@ _papplJobCopyDocumentData(
 
   job->fd = -1;
 
+  _papplSystemAddMetricCount(client->system, _PAPPL_COUNTER_SPOOL_BYTES, total);
+
   // Submit the job for processing...
   _papplJobSubmitFile(job, filename);
 
@@ -294,15 +352,9 @@ _papplJobCopyDocumentData(
   // Return the job info...
   papplClientRespondIPP(client, IPP_STATUS_OK, NULL);
 
-  ra = cupsArrayNew((cups_array_func_t)strcmp, NULL);
-  cupsArrayAdd(ra, "job-id");
-  cupsArrayAdd(ra, "job-state");
-  cupsArrayAdd(ra, "job-state-message");
-  cupsArrayAdd(ra, "job-state-reasons");
-  cupsArrayAdd(ra, "job-uri");
-
-  _papplJobCopyAttributes(client, job, ra);
-  cupsArrayDelete(ra);
+  _papplRequestedCreateNames(&ra, sizeof(completed) / sizeof(completed[0]), completed);
+  _papplJobCopyAttributes(client, job, &ra);
+  _papplRequestedDelete(&ra);
   return;
 
   // If we get here we had to abort the job...
@@ -315,22 +367,16 @@ _papplJobCopyDocumentData(
 
   pthread_rwlock_wrlock(&client->printer->rwlock);
 
-  cupsArrayRemove(client->printer->active_jobs, job);
-  cupsArrayAdd(client->printer->completed_jobs, job);
+  _papplPrinterCompleteJob(client->printer, job);
 
   if (!client->system->clean_time)
     client->system->clean_time = time(NULL) + 60;
 
   pthread_rwlock_unlock(&client->printer->rwlock);
 
-  ra = cupsArrayNew((cups_array_func_t)strcmp, NULL);
-  cupsArrayAdd(ra, "job-id");
-  cupsArrayAdd(ra, "job-state");
-  cupsArrayAdd(ra, "job-state-reasons");
-  cupsArrayAdd(ra, "job-uri");
-
-  _papplJobCopyAttributes(client, job, ra);
-  cupsArrayDelete(ra);
+  _papplRequestedCreateNames(&ra, sizeof(aborted) / sizeof(aborted[0]), aborted);
+  _papplJobCopyAttributes(client, job, &ra);
+  _papplRequestedDelete(&ra);
 }
 
 
@@ -342,7 +388,13 @@ void
 _papplJobProcessIPP(
     pappl_client_t *client)		// I - Client
 {
-  switch (ippGetOperation(client->request))
+  ipp_op_t	op = ippGetOperation(client->request);
+					// IPP operation
+
+
+  _PAPPL_TRACE(PAPPL_TRACE_IPP_OPERATION, job__operation, ippOpString(op), client->number, (size_t)op);
+
+  switch (op)
   {
     case IPP_OP_SEND_DOCUMENT :
 	ipp_send_document(client);
@@ -600,7 +652,7 @@ ipp_get_job_attributes(
     pappl_client_t *client)		// I - Client
 {
   pappl_job_t	*job = client->job;	// Job information
-  cups_array_t	*ra;			// requested-attributes
+  _pappl_ra_t	ra;			// requested-attributes
 
 
   if (!job)
@@ -611,9 +663,9 @@ ipp_get_job_attributes(
 
   papplClientRespondIPP(client, IPP_STATUS_OK, NULL);
 
-  ra = ippCreateRequestedArray(client->request);
-  _papplJobCopyAttributes(client, job, ra);
-  cupsArrayDelete(ra);
+  _papplRequestedCreate(&ra, client->request, 0, NULL);
+  _papplJobCopyAttributes(client, job, &ra);
+  _papplRequestedDelete(&ra);
 }
 
 
@@ -694,6 +746,8 @@ ipp_send_document(
 
   _papplCopyAttributes(job->attrs, client->request, NULL, IPP_TAG_JOB, 0);
 
+  job->attrs_saved = false;
+
   if ((attr = ippFindAttribute(job->attrs, "document-format-detected", IPP_TAG_MIMETYPE)) != NULL)
     job->format = ippGetString(attr, 0, NULL);
   else if ((attr = ippFindAttribute(job->attrs, "document-format-supplied", IPP_TAG_MIMETYPE)) != NULL)
@@ -27,12 +27,28 @@ extern char **environ;
 // Types and structures...
 //
 
+typedef struct _pappl_job_list_s	// List of jobs, newest first
+{
+  pappl_job_t		*first,			// First (newest) job
+			*last;			// Last (oldest) job
+  int			count;			// Number of jobs
+} _pappl_job_list_t;
+
 struct _pappl_job_s			// Job data
 {
   pthread_rwlock_t	rwlock;			// Reader/writer lock
+  pthread_mutex_t	use_mutex;		// Reference count mutex
+  int			use;			// Reference count
   pappl_system_t	*system;		// Containing system
   pappl_printer_t	*printer;		// Containing printer
   int			job_id;			// "job-id" value
+  pappl_job_t		*prev,			// Previous job in active/completed list
+			*next,			// Next job in active/completed list
+			*all_prev,		// Previous job in list of all jobs
+			*all_next,		// Next job in list of all jobs
+			*user_prev,		// Previous job in list of user's jobs
+			*user_next,		// Next job in list of user's jobs
+			*hash_next;		// Next job in hash bucket
   const char		*name,			// "job-name" value
 			*username,		// "job-originating-user-name" value
 			*format;		// "document-format" value
@@ -44,12 +60,21 @@ struct _pappl_job_s			// Job data
   time_t		created,		// "[date-]time-at-creation" value
 			processing,		// "[date-]time-at-processing" value
 			completed;		// "[date-]time-at-completed" value
+  double		queued,			// Monotonic time job was queued
+			opening,		// Monotonic time device open started
+			started,		// Monotonic time processing started
+			finishing,		// Monotonic time processing ended
+			finished,		// Monotonic time job finished
+			driver_secs;		// Seconds spent in driver raster callbacks
+  size_t		write_msecs;		// Device write milliseconds (baseline while processing)
   int			impressions,		// "job-impressions" value
 			impcompleted;		// "job-impressions-completed" value
   ipp_t			*attrs;			// Static attributes
   char			*filename;		// Print file name
   int			fd;			// Print file descriptor
   bool			streaming;		// Streaming job?
+  bool			is_journaled;		// Is the job in the state journal?
+  bool			attrs_saved;		// Have the job attributes been saved?
   void			*data;			// Per-job driver data
 };
 
@@ -58,24 +83,30 @@ struct _pappl_job_s			// Job data
 // Functions...
 //
 
+extern void		_papplJobAddDriverTime(pappl_job_t *job, double secs) _PAPPL_PRIVATE;
 extern int		_papplJobCompareActive(pappl_job_t *a, pappl_job_t *b) _PAPPL_PRIVATE;
 extern int		_papplJobCompareAll(pappl_job_t *a, pappl_job_t *b) _PAPPL_PRIVATE;
 extern int		_papplJobCompareCompleted(pappl_job_t *a, pappl_job_t *b) _PAPPL_PRIVATE;
-extern void		_papplJobCopyAttributes(pappl_client_t *client, pappl_job_t *job, cups_array_t *ra) _PAPPL_PRIVATE;
+extern void		_papplJobCopyAttributes(pappl_client_t *client, pappl_job_t *job, _pappl_ra_t *ra) _PAPPL_PRIVATE;
 extern void		_papplJobCopyDocumentData(pappl_client_t *client, pappl_job_t *job) _PAPPL_PRIVATE;
 extern pappl_job_t	*_papplJobCreate(pappl_printer_t *printer, int job_id, const char *username, const char *format, const char *job_name, ipp_t *attrs) _PAPPL_PRIVATE;
 extern void		_papplJobDelete(pappl_job_t *job) _PAPPL_PRIVATE;
+extern void		_papplJobGetMetricsNoLock(pappl_job_t *job, pappl_jmetrics_t *metrics) _PAPPL_PRIVATE;
 #  ifdef HAVE_LIBJPEG
 extern bool		_papplJobFilterJPEG(pappl_job_t *job, pappl_device_t *device, void *data);
 #  endif // HAVE_LIBJPEG
 #  ifdef HAVE_LIBPNG
 extern bool		_papplJobFilterPNG(pappl_job_t *job, pappl_device_t *device, void *data);
 #  endif // HAVE_LIBPNG
+extern void		_papplJobListAdd(_pappl_job_list_t *list, pappl_job_t *job) _PAPPL_PRIVATE;
+extern void		_papplJobListRemove(_pappl_job_list_t *list, pappl_job_t *job) _PAPPL_PRIVATE;
 extern void		*_papplJobProcess(pappl_job_t *job) _PAPPL_PRIVATE;
 extern void		_papplJobProcessIPP(pappl_client_t *client) _PAPPL_PRIVATE;
 extern void		_papplJobProcessRaster(pappl_job_t *job, pappl_client_t *client) _PAPPL_PRIVATE;
 extern const char	*_papplJobReasonString(pappl_jreason_t reason) _PAPPL_PRIVATE;
+extern void		_papplJobRelease(pappl_job_t *job) _PAPPL_PRIVATE;
 extern void		_papplJobRemoveFile(pappl_job_t *job) _PAPPL_PRIVATE;
+extern pappl_job_t	*_papplJobRetain(pappl_job_t *job) _PAPPL_PRIVATE;
 extern void		_papplJobSetState(pappl_job_t *job, ipp_jstate_t state) _PAPPL_PRIVATE;
 extern void		_papplJobSubmitFile(pappl_job_t *job, const char *filename) _PAPPL_PRIVATE;
 extern bool		_papplJobValidateDocumentAttributes(pappl_client_t *client) _PAPPL_PRIVATE;
@@ -24,6 +24,21 @@ static void	finish_job(pappl_job_t *job);
 static void	start_job(pappl_job_t *job);
 
 
+//
+// '_papplJobAddDriverTime()' - Add time spent in driver callbacks.
+//
+
+void
+_papplJobAddDriverTime(
+    pappl_job_t *job,			// I - Job
+    double      secs)			// I - Seconds spent in callbacks
+{
+  pthread_rwlock_wrlock(&job->rwlock);
+  job->driver_secs += secs;
+  pthread_rwlock_unlock(&job->rwlock);
+}
+
+
 //
 // 'papplJobCreatePrintOptions()' - Create the printer options for a job.
 //
@@ -483,6 +498,9 @@ _papplJobProcessRaster(
   unsigned		page = 0,	// Current page
 			x,		// Current column
 			y;		// Current line
+  bool			ret;		// Driver callback result
+  double		start,		// Start time of driver callback
+			line_secs;	// Time spent in line callbacks
 
 
   // Start processing the job...
@@ -511,7 +529,12 @@ _papplJobProcessRaster(
 
   options = papplJobCreatePrintOptions(job, (unsigned)job->impressions, header.cupsBitsPerPixel > 8);
 
-  if (!(printer->driver_data.rstartjob_cb)(job, options, job->printer->device))
+  start = _papplGetTime();
+  ret   = (printer->driver_data.rstartjob_cb)(job, options, job->printer->device);
+
+  _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+  if (!ret)
   {
     job->state = IPP_JSTATE_ABORTED;
     goto complete_job;
@@ -551,7 +574,14 @@ _papplJobProcessRaster(
     if (options->header.cupsBitsPerPixel >= 8 && header.cupsBitsPerPixel >= 8)
       options->header = header;		// Use page header from client
 
-    if (!(printer->driver_data.rstartpage_cb)(job, options, job->printer->device, page))
+    _PAPPL_TRACE(PAPPL_TRACE_PAGE_START, page__start, printer->name, job->job_id, page);
+
+    start = _papplGetTime();
+    ret   = (printer->driver_data.rstartpage_cb)(job, options, job->printer->device, page);
+
+    _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+    if (!ret)
     {
       job->state = IPP_JSTATE_ABORTED;
       break;
@@ -592,6 +622,9 @@ _papplJobProcessRaster(
       break;
     }
 
+    // Add up the time for each line and record it once per page...
+    line_secs = 0.0;
+
     for (y = 0; !job->is_canceled && y < header.cupsHeight && y < options->header.cupsHeight; y ++)
     {
       if (cupsRasterReadPixels(ras, pixels, header.cupsBytesPerLine))
@@ -645,15 +678,23 @@ _papplJobProcessRaster(
 	      *lineptr = byte;
 	  }
 
+          start = _papplGetTime();
           (printer->driver_data.rwriteline_cb)(job, options, job->printer->device, y, line);
         }
         else
+        {
+          start = _papplGetTime();
           (printer->driver_data.rwriteline_cb)(job, options, job->printer->device, y, pixels);
+        }
+
+        line_secs += _papplGetTime() - start;
       }
       else
         break;
     }
 
+    _papplJobAddDriverTime(job, line_secs);
+
     if (!job->is_canceled && y < header.cupsHeight)
     {
       // Discard excess lines from client...
@@ -670,11 +711,15 @@ _papplJobProcessRaster(
       {
         memset(line, 0, options->header.cupsBytesPerLine);
 
+        start = _papplGetTime();
+
         while (y < options->header.cupsHeight)
         {
 	  (printer->driver_data.rwriteline_cb)(job, options, job->printer->device, y, line);
           y ++;
         }
+
+        _papplJobAddDriverTime(job, _papplGetTime() - start);
       }
       else
       {
@@ -683,18 +728,29 @@ _papplJobProcessRaster(
 	else
           memset(pixels, 0xff, header.cupsBytesPerLine);
 
+        start = _papplGetTime();
+
         while (y < options->header.cupsHeight)
         {
 	  (printer->driver_data.rwriteline_cb)(job, options, job->printer->device, y, pixels);
           y ++;
         }
+
+        _papplJobAddDriverTime(job, _papplGetTime() - start);
       }
     }
 
     free(pixels);
     free(line);
 
-    if (!(printer->driver_data.rendpage_cb)(job, options, job->printer->device, page))
+    start = _papplGetTime();
+    ret   = (printer->driver_data.rendpage_cb)(job, options, job->printer->device, page);
+
+    _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+    _PAPPL_TRACE(PAPPL_TRACE_PAGE_END, page__end, printer->name, job->job_id, page);
+
+    if (!ret)
     {
       job->state = IPP_JSTATE_ABORTED;
       break;
@@ -711,7 +767,12 @@ _papplJobProcessRaster(
   }
   while (cupsRasterReadHeader2(ras, &header));
 
-  if (!(printer->driver_data.rendjob_cb)(job, options, job->printer->device))
+  start = _papplGetTime();
+  ret   = (printer->driver_data.rendjob_cb)(job, options, job->printer->device);
+
+  _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+  if (!ret)
     job->state = IPP_JSTATE_ABORTED;
   else if (header_pages == 0)
     papplJobSetImpressions(job, (int)page);
@@ -828,12 +889,19 @@ filter_raw(pappl_job_t    *job,		// I - Job
            pappl_device_t *device)	// I - Device
 {
   pappl_pr_options_t	*options;	// Job options
+  bool			ret;		// Driver callback result
+  double		start;		// Start time of driver callback
 
 
   papplJobSetImpressions(job, 1);
   options = papplJobCreatePrintOptions(job, 1, false);
 
-  if (!(job->printer->driver_data.printfile_cb)(job, options, device))
+  start = _papplGetTime();
+  ret   = (job->printer->driver_data.printfile_cb)(job, options, device);
+
+  _papplJobAddDriverTime(job, _papplGetTime() - start);
+
+  if (!ret)
   {
     papplJobDeletePrintOptions(options);
     return (false);
@@ -855,6 +923,7 @@ finish_job(pappl_job_t  *job)		// I - Job
 {
   pappl_printer_t *printer = job->printer;
 					// Printer
+  pappl_devmetrics_t	metrics;	// Metrics for device IO
 
 
   pthread_rwlock_wrlock(&job->rwlock);
@@ -865,11 +934,25 @@ finish_job(pappl_job_t  *job)		// I - Job
   else if (job->state == IPP_JSTATE_PROCESSING)
     job->state = IPP_JSTATE_COMPLETED;
 
+  // Record the processing time and device writes for this job...
+  papplDeviceGetMetrics(printer->device, &metrics);
+
+  job->finishing   = _papplGetTime();
+  job->write_msecs = metrics.write_msecs - job->write_msecs;
+
+  if (job->started > 0.0)
+    _papplSystemAddMetricTime(job->system, _PAPPL_TIMER_JOB_PROCESS, job->finishing - job->started);
+
+  _papplSystemAddMetricCount(job->system, job->state == IPP_JSTATE_COMPLETED ? _PAPPL_COUNTER_JOBS_COMPLETED : job->state == IPP_JSTATE_CANCELED ? _PAPPL_COUNTER_JOBS_CANCELED : _PAPPL_COUNTER_JOBS_ABORTED, 1);
+
   papplLogJob(job, PAPPL_LOGLEVEL_INFO, "%s, job-impressions-completed=%d.", job->state == IPP_JSTATE_COMPLETED ? "Completed" : job->state == IPP_JSTATE_CANCELED ? "Canceled" : "Aborted", job->impcompleted);
 
   job->completed          = time(NULL);
+  job->finished           = _papplGetTime();
   printer->processing_job = NULL;
 
+  _PAPPL_TRACE(PAPPL_TRACE_JOB_STATE, job__state, printer->name, job->job_id, (size_t)job->state);
+
   _papplJobRemoveFile(job);
 
   pthread_rwlock_unlock(&job->rwlock);
@@ -888,8 +971,7 @@ finish_job(pappl_job_t  *job)		// I - Job
 
   printer->state_time = time(NULL);
 
-  cupsArrayRemove(printer->active_jobs, job);
-  cupsArrayAdd(printer->completed_jobs, job);
+  _papplPrinterCompleteJob(printer, job);
 
   printer->impcompleted += job->impcompleted;
 
@@ -898,31 +980,38 @@ finish_job(pappl_job_t  *job)		// I - Job
 
   pthread_rwlock_unlock(&printer->rwlock);
 
-  _papplSystemConfigChanged(printer->system);
+  _papplSystemJournalJob(printer->system, job);
 
   if (printer->is_deleted)
   {
     papplPrinterDelete(printer);
   }
-  else if (cupsArrayCount(printer->active_jobs) > 0)
+  else if (printer->active_jobs.count > 0)
   {
     _papplPrinterCheckJobs(printer);
   }
   else
   {
-    pappl_devmetrics_t	metrics;	// Metrics for device IO
-
     pthread_rwlock_wrlock(&printer->rwlock);
 
     papplDeviceGetMetrics(printer->device, &metrics);
     papplLogJob(job, PAPPL_LOGLEVEL_DEBUG, "Device read metrics: %lu requests, %lu bytes, %lu msecs", metrics.read_requests, metrics.read_bytes, metrics.read_msecs);
     papplLogJob(job, PAPPL_LOGLEVEL_DEBUG, "Device write metrics: %lu requests, %lu bytes, %lu msecs", metrics.write_requests, metrics.write_bytes, metrics.write_msecs);
 
+    _papplSystemAddMetricCount(job->system, _PAPPL_COUNTER_DEVICE_READ_BYTES, metrics.read_bytes);
+    _papplSystemAddMetricCount(job->system, _PAPPL_COUNTER_DEVICE_READ_MSECS, metrics.read_msecs);
+    _papplSystemAddMetricCount(job->system, _PAPPL_COUNTER_DEVICE_READ_REQUESTS, metrics.read_requests);
+    _papplSystemAddMetricCount(job->system, _PAPPL_COUNTER_DEVICE_WRITE_BYTES, metrics.write_bytes);
+    _papplSystemAddMetricCount(job->system, _PAPPL_COUNTER_DEVICE_WRITE_MSECS, metrics.write_msecs);
+    _papplSystemAddMetricCount(job->system, _PAPPL_COUNTER_DEVICE_WRITE_REQUESTS, metrics.write_requests);
+
     papplDeviceClose(printer->device);
     printer->device = NULL;
 
     pthread_rwlock_unlock(&printer->rwlock);
   }
+
+  _papplSystemAddMetricTime(job->system, _PAPPL_TIMER_JOB_FINISH, _papplGetTime() - job->finishing);
 }
 
 
@@ -936,6 +1025,7 @@ start_job(pappl_job_t *job)		// I - Job
   pappl_printer_t *printer = job->printer;
 					// Printer
   bool	first_open = true;		// Is this the first time we try to open the device?
+  pappl_devmetrics_t metrics;		// Metrics for device IO
 
 
   // Move the job to the 'processing' state...
@@ -944,10 +1034,17 @@ start_job(pappl_job_t *job)		// I - Job
 
   papplLogJob(job, PAPPL_LOGLEVEL_INFO, "Starting print job.");
 
+  job->opening = _papplGetTime();
+
+  if (job->queued > 0.0)
+    _papplSystemAddMetricTime(job->system, _PAPPL_TIMER_JOB_WAIT, job->opening - job->queued);
+
   job->state              = IPP_JSTATE_PROCESSING;
   job->processing         = time(NULL);
   printer->processing_job = job;
 
+  _PAPPL_TRACE(PAPPL_TRACE_JOB_STATE, job__state, printer->name, job->job_id, (size_t)job->state);
+
   pthread_rwlock_unlock(&job->rwlock);
 
   // Open the output device...
@@ -978,4 +1075,15 @@ start_job(pappl_job_t *job)		// I - Job
   printer->state_time = time(NULL);
 
   pthread_rwlock_unlock(&printer->rwlock);
+
+  // Record the start of processing, including the current device write time
+  // so that finish_job() can report the writes for this job...
+  papplDeviceGetMetrics(printer->device, &metrics);
+
+  pthread_rwlock_wrlock(&job->rwlock);
+  job->started     = _papplGetTime();
+  job->write_msecs = metrics.write_msecs;
+  pthread_rwlock_unlock(&job->rwlock);
+
+  _papplSystemAddMetricTime(job->system, _PAPPL_TIMER_JOB_DEVICE, job->started - job->opening);
 }
@@ -15,6 +15,20 @@
 #include "pappl-private.h"
 
 
+//
+// Local constants...
+//
+
+#define _PAPPL_CLEAN_BATCH	50	// Maximum jobs to remove per printer per pass
+
+
+//
+// Local functions...
+//
+
+static int	compare_jobs(pappl_job_t *a, pappl_job_t *b);
+
+
 //
 // 'papplJobCancel()' - Cancel a job.
 //
@@ -43,8 +57,7 @@ papplJobCancel(pappl_job_t *job)	// I - Job
 
     _papplJobRemoveFile(job);
 
-    cupsArrayRemove(job->printer->active_jobs, job);
-    cupsArrayAdd(job->printer->completed_jobs, job);
+    _papplPrinterCompleteJob(job->printer, job);
   }
 
   pthread_rwlock_unlock(&job->printer->rwlock);
@@ -80,7 +93,7 @@ _papplJobCreate(
 
   pthread_rwlock_wrlock(&printer->rwlock);
 
-  if (printer->max_active_jobs > 0 && cupsArrayCount(printer->active_jobs) >= printer->max_active_jobs)
+  if (printer->max_active_jobs > 0 && printer->active_jobs.count >= printer->max_active_jobs)
   {
     pthread_rwlock_unlock(&printer->rwlock);
     return (NULL);
@@ -94,6 +107,10 @@ _papplJobCreate(
     return (NULL);
   }
 
+  pthread_rwlock_init(&job->rwlock, NULL);
+  pthread_mutex_init(&job->use_mutex, NULL);
+
+  job->use     = 1;
   job->attrs   = ippNew();
   job->fd      = -1;
   job->format  = format;
@@ -118,8 +135,8 @@ _papplJobCreate(
 	job->format = "application/octet-stream";
     }
   }
-  else
-    ippAddString(job->attrs, IPP_TAG_JOB, IPP_TAG_NAME, "job-name", NULL, job_name);
+  else if ((attr = ippAddString(job->attrs, IPP_TAG_JOB, IPP_TAG_NAME, "job-name", NULL, job_name)) != NULL)
+    job->name = ippGetString(attr, 0, NULL);
 
   if ((attr = ippAddString(job->attrs, IPP_TAG_JOB, IPP_TAG_NAME, "job-originating-user-name", NULL, username)) != NULL)
     job->username = ippGetString(attr, 0, NULL);
@@ -149,14 +166,14 @@ _papplJobCreate(
   ippAddString(job->attrs, IPP_TAG_JOB, IPP_TAG_URI, "job-uuid", NULL, job_uuid);
   ippAddString(job->attrs, IPP_TAG_JOB, IPP_TAG_URI, "job-printer-uri", NULL, job_printer_uri);
 
-  cupsArrayAdd(printer->all_jobs, job);
+  _papplPrinterAddJob(printer, job);
 
   if (!job_id)
-    cupsArrayAdd(printer->active_jobs, job);
+    _papplJobListAdd(&printer->active_jobs, job);
 
   pthread_rwlock_unlock(&printer->rwlock);
 
-  _papplSystemConfigChanged(printer->system);
+  _papplSystemJournalJob(printer->system, job);
 
   return (job);
 }
@@ -171,15 +188,84 @@ _papplJobDelete(pappl_job_t *job)	// I - Job
 {
   papplLogJob(job, PAPPL_LOGLEVEL_INFO, "Removing job from history.");
 
-  ippDelete(job->attrs);
+  _papplJobRelease(job);
+}
 
-  free(job->message);
 
-  // Only remove the job file (document) if the job is in a terminating state...
-  if (job->state >= IPP_JSTATE_CANCELED)
-    _papplJobRemoveFile(job);
+//
+// '_papplJobListAdd()' - Add a job to a list.
+//
+// Lists are sorted newest first by completion time and then "job-id", so the
+// completed jobs list doubles as the age list used for cleaning out old jobs.
+// New and just-completed jobs are added to the front of the list and jobs
+// loaded from the state file are added to the end, so both cases take constant
+// time.
+//
 
-  free(job);
+void
+_papplJobListAdd(
+    _pappl_job_list_t *list,		// I - List of jobs
+    pappl_job_t       *job)		// I - Job
+{
+  pappl_job_t	*current;		// Current job in list
+
+
+  if (!list->first || compare_jobs(job, list->first) < 0)
+  {
+    // Add to the front...
+    job->prev = NULL;
+    job->next = list->first;
+
+    if (list->first)
+      list->first->prev = job;
+    else
+      list->last = job;
+
+    list->first = job;
+  }
+  else
+  {
+    // Find the insertion point, starting from the end...
+    for (current = list->last; current && compare_jobs(current, job) > 0; current = current->prev);
+
+    job->prev = current;
+    job->next = current->next;
+
+    if (current->next)
+      current->next->prev = job;
+    else
+      list->last = job;
+
+    current->next = job;
+  }
+
+  list->count ++;
+}
+
+
+//
+// '_papplJobListRemove()' - Remove a job from a list.
+//
+
+void
+_papplJobListRemove(
+    _pappl_job_list_t *list,		// I - List of jobs
+    pappl_job_t       *job)		// I - Job
+{
+  if (job->prev)
+    job->prev->next = job->next;
+  else
+    list->first = job->next;
+
+  if (job->next)
+    job->next->prev = job->prev;
+  else
+    list->last = job->prev;
+
+  job->prev = NULL;
+  job->next = NULL;
+
+  list->count --;
 }
 
 
@@ -290,6 +376,40 @@ papplJobOpenFile(
 }
 
 
+//
+// '_papplJobRelease()' - Release a reference to a job.
+//
+// The job is freed when the last reference is released.
+//
+
+void
+_papplJobRelease(pappl_job_t *job)	// I - Job
+{
+  int	use;				// Remaining references
+
+
+  pthread_mutex_lock(&job->use_mutex);
+  use = -- job->use;
+  pthread_mutex_unlock(&job->use_mutex);
+
+  if (use > 0)
+    return;
+
+  pthread_mutex_destroy(&job->use_mutex);
+  pthread_rwlock_destroy(&job->rwlock);
+
+  ippDelete(job->attrs);
+
+  free(job->message);
+
+  // Only remove the job file (document) if the job is in a terminating state...
+  if (job->state >= IPP_JSTATE_CANCELED)
+    _papplJobRemoveFile(job);
+
+  free(job);
+}
+
+
 //
 // '_papplJobRemoveFile()' - Remove a file in spool directory
 //
@@ -310,6 +430,21 @@ _papplJobRemoveFile(pappl_job_t *job)	// I - Job
 }
 
 
+//
+// '_papplJobRetain()' - Add a reference to a job.
+//
+
+pappl_job_t *				// O - Job
+_papplJobRetain(pappl_job_t *job)	// I - Job
+{
+  pthread_mutex_lock(&job->use_mutex);
+  job->use ++;
+  pthread_mutex_unlock(&job->use_mutex);
+
+  return (job);
+}
+
+
 //
 // '_papplJobSubmitFile()' - Submit a file for printing.
 //
@@ -380,7 +515,10 @@ _papplJobSubmitFile(
   if ((job->filename = strdup(filename)) != NULL)
   {
     // Process the job...
-    job->state = IPP_JSTATE_PENDING;
+    job->state  = IPP_JSTATE_PENDING;
+    job->queued = _papplGetTime();
+
+    _PAPPL_TRACE(PAPPL_TRACE_JOB_STATE, job__state, job->printer->name, job->job_id, (size_t)job->state);
 
     _papplPrinterCheckJobs(job->printer);
   }
@@ -394,8 +532,7 @@ _papplJobSubmitFile(
     unlink(filename);
 
     pthread_rwlock_wrlock(&job->printer->rwlock);
-    cupsArrayRemove(job->printer->active_jobs, job);
-    cupsArrayAdd(job->printer->completed_jobs, job);
+    _papplPrinterCompleteJob(job->printer, job);
     pthread_rwlock_unlock(&job->printer->rwlock);
 
     if (!job->system->clean_time)
@@ -435,10 +572,8 @@ _papplPrinterCheckJobs(
 
   pthread_rwlock_wrlock(&printer->rwlock);
 
-  // Enumerate the jobs.  Since we have a writer (exclusive) lock, we are the
-  // only thread enumerating and can use cupsArrayFirst/Last...
-
-  for (job = (pappl_job_t *)cupsArrayFirst(printer->active_jobs); job; job = (pappl_job_t *)cupsArrayNext(printer->active_jobs))
+  // Enumerate the jobs...
+  for (job = printer->active_jobs.first; job; job = job->next)
   {
     if (job->state == IPP_JSTATE_PENDING)
     {
@@ -451,8 +586,7 @@ _papplPrinterCheckJobs(
 	job->state     = IPP_JSTATE_ABORTED;
 	job->completed = time(NULL);
 
-	cupsArrayRemove(printer->active_jobs, job);
-	cupsArrayAdd(printer->completed_jobs, job);
+	_papplPrinterCompleteJob(printer, job);
 
 	if (!printer->system->clean_time)
 	  printer->system->clean_time = time(NULL) + 60;
@@ -481,14 +615,13 @@ papplPrinterFindJob(
     pappl_printer_t *printer,		// I - Printer
     int             job_id)		// I - Job ID
 {
-  pappl_job_t		key,		// Job search key
-			*job;		// Matching job, if any
+  pappl_job_t		*job;		// Matching job, if any
 
 
-  key.job_id = job_id;
-
   pthread_rwlock_rdlock(&(printer->rwlock));
-  job = (pappl_job_t *)cupsArrayFind(printer->all_jobs, &key);
+
+  job = _papplPrinterFindJobNoLock(printer, job_id);
+
   pthread_rwlock_unlock(&(printer->rwlock));
 
   return (job);
@@ -511,13 +644,24 @@ papplSystemCleanJobs(
     pappl_system_t *system)		// I - System
 {
   int			i,		// Looping var
-			count;		// Number of printers
+			count,		// Number of printers
+			num_jobs;	// Number of jobs to free
   pappl_printer_t	*printer;	// Current printer
-  pappl_job_t		*job;		// Current job
-  time_t		cleantime;	// Clean time
+  pappl_job_t		*job,		// Current job
+			*jobs[_PAPPL_CLEAN_BATCH];
+					// Jobs to free
+  time_t		curtime,	// Current time
+			cleantime,	// Clean time
+			next_time = 0,	// Next time to clean
+			job_time;	// Next clean time for printer
 
 
-  cleantime = time(NULL) - 60;
+  curtime   = time(NULL);
+  cleantime = curtime - 60;
+
+  // Clear the clean time so that jobs completing while we clean will schedule
+  // another pass...
+  system->clean_time = 0;
 
   pthread_rwlock_rdlock(&system->rwlock);
 
@@ -530,27 +674,55 @@ papplSystemCleanJobs(
   {
     printer = (pappl_printer_t *)cupsArrayIndex(system->printers, i);
 
-    if (cupsArrayCount(printer->completed_jobs) == 0 || printer->max_completed_jobs <= 0)
+    if (printer->completed_jobs.count == 0 || printer->max_completed_jobs <= 0)
       continue;
 
     pthread_rwlock_wrlock(&printer->rwlock);
 
-    // Enumerate the jobs.  Since we have a writer (exclusive) lock, we are the
-    // only thread enumerating and can use cupsArrayFirst/Last...
+    // Remove a limited number of the oldest jobs from the end of the list so
+    // that we don't hold the printer lock for long.  Each job is retained so
+    // that it is freed (and its files removed) after the lock is released...
+    for (num_jobs = 0; num_jobs < _PAPPL_CLEAN_BATCH && (job = printer->completed_jobs.last) != NULL && job->completed < cleantime && printer->completed_jobs.count > printer->max_completed_jobs; num_jobs ++)
+    {
+      jobs[num_jobs] = _papplJobRetain(job);
+      _papplPrinterRemoveJob(printer, job);
+    }
 
-    for (job = (pappl_job_t *)cupsArrayFirst(printer->completed_jobs); job; job = (pappl_job_t *)cupsArrayNext(printer->completed_jobs))
+    // See when we need to look at this printer again...
+    if (printer->completed_jobs.count > printer->max_completed_jobs && (job = printer->completed_jobs.last) != NULL)
     {
-      if (job->completed && job->completed < cleantime && cupsArrayCount(printer->completed_jobs) > printer->max_completed_jobs)
-      {
-	cupsArrayRemove(printer->completed_jobs, job);
-	cupsArrayRemove(printer->all_jobs, job);
-      }
+      if (num_jobs == _PAPPL_CLEAN_BATCH)
+        job_time = curtime;		// More to do now
       else
-	break;
+        job_time = job->completed + 61;	// Oldest job will be eligible
+
+      if (!next_time || job_time < next_time)
+        next_time = job_time;
     }
 
     pthread_rwlock_unlock(&printer->rwlock);
+
+    while (num_jobs > 0)
+      _papplJobRelease(jobs[-- num_jobs]);
   }
 
   pthread_rwlock_unlock(&system->rwlock);
+
+  if (next_time && (!system->clean_time || next_time < system->clean_time))
+    system->clean_time = next_time;
+}
+
+
+//
+// 'compare_jobs()' - Compare the age of two jobs.
+//
+
+static int				// O - Result of comparison
+compare_jobs(pappl_job_t *a,		// I - First job
+             pappl_job_t *b)		// I - Second job
+{
+  if (a->completed != b->completed)
+    return (a->completed > b->completed ? -1 : 1);
+  else
+    return (b->job_id - a->job_id);
 }
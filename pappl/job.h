@@ -59,6 +59,22 @@ enum pappl_jreason_e			// IPP "job-state-reasons" bit values
 typedef unsigned int pappl_jreason_t;	// Bitfield for IPP "job-state-reasons" values
 
 
+//
+// Types...
+//
+
+typedef struct pappl_jmetrics_s		// Job timing metrics @since PAPPL 1.1@
+{
+  double	wait_msecs;			// Milliseconds waiting in the queue
+  double	device_msecs;			// Milliseconds opening the output device
+  double	process_msecs;			// Milliseconds processing the document, including driver and device time
+  double	driver_msecs;			// Milliseconds spent in driver raster callbacks
+  double	write_msecs;			// Milliseconds spent writing to the output device
+  double	finish_msecs;			// Milliseconds finishing the job
+  double	total_msecs;			// Milliseconds from queuing to completion
+} pappl_jmetrics_t;
+
+
 //
 // Functions...
 //
@@ -77,6 +93,7 @@ extern const char	*papplJobGetFormat(pappl_job_t *job) _PAPPL_PUBLIC;
 extern int		papplJobGetID(pappl_job_t *job) _PAPPL_PUBLIC;
 extern int		papplJobGetImpressions(pappl_job_t *job) _PAPPL_PUBLIC;
 extern int		papplJobGetImpressionsCompleted(pappl_job_t *job) _PAPPL_PUBLIC;
+extern pappl_jmetrics_t	*papplJobGetMetrics(pappl_job_t *job, pappl_jmetrics_t *metrics) _PAPPL_PUBLIC;
 extern const char	*papplJobGetMessage(pappl_job_t *job) _PAPPL_PUBLIC;
 extern const char	*papplJobGetName(pappl_job_t *job) _PAPPL_PUBLIC;
 extern pappl_printer_t	*papplJobGetPrinter(pappl_job_t *job) _PAPPL_PUBLIC;
@@ -16,6 +16,52 @@
 
 #  include "base-private.h"
 #  include "log.h"
+#  if defined(HAVE_TRACING) && defined(HAVE_SYS_SDT_H)
+#    include <sys/sdt.h>
+#  endif // HAVE_TRACING && HAVE_SYS_SDT_H
+
+
+//
+// Macros...
+//
+// _PAPPL_TRACE fires the named USDT probe (provider "pappl") when <sys/sdt.h>
+// is available and calls the registered trace callback, if any.  Both compile
+// to nothing when tracing is disabled with "--disable-tracing".
+//
+
+#  ifdef HAVE_TRACING
+#    ifdef HAVE_SYS_SDT_H
+#      define _PAPPL_TRACE_PROBE(probe,name,id,value) DTRACE_PROBE3(pappl, probe, name, id, value)
+#    else
+#      define _PAPPL_TRACE_PROBE(probe,name,id,value)
+#    endif // HAVE_SYS_SDT_H
+#    define _PAPPL_TRACE(point,probe,name,id,value) do { _PAPPL_TRACE_PROBE(probe, name, id, value); if (_papplTraceCB) _papplTrace(point, name, id, value); } while (0)
+#  else
+#    define _PAPPL_TRACE(point,probe,name,id,value)
+#  endif // HAVE_TRACING
+
+
+//
+// Types...
+//
+
+typedef struct _pappl_logfilter_s	// Log tail request
+{
+  off_t			offset;			// Starting offset or `-1` for the last lines
+  size_t		lines;			// Number of lines when offset is `-1`
+  size_t		maxbytes;		// Maximum number of bytes to read
+  pappl_loglevel_t	level;			// Minimum log level
+  const char		*printer;		// Printer name or `NULL` for all
+  int			job_id;			// Job ID or `0` for all
+} _pappl_logfilter_t;
+
+
+//
+// Globals...
+//
+
+extern pappl_trace_cb_t	_papplTraceCB _PAPPL_PRIVATE;
+					// Trace callback
 
 
 //
@@ -23,6 +69,8 @@
 //
 
 extern void	_papplLogAttributes(pappl_client_t *client, const char *title, ipp_t *ipp, bool is_response) _PAPPL_PRIVATE;
+extern char	*_papplLogCopyTail(pappl_system_t *system, _pappl_logfilter_t *filter, off_t *start, off_t *next, off_t *size) _PAPPL_PRIVATE;
 extern void	_papplLogOpen(pappl_system_t *system) _PAPPL_PRIVATE;
+extern void	_papplTrace(pappl_trace_t point, const char *name, int id, size_t value) _PAPPL_PRIVATE;
 
 #endif // !_PAPPL_LOG_PRIVATE_H_
@@ -25,15 +25,27 @@
 //
 
 static void	rotate_log(pappl_system_t *system);
+static off_t	skip_lines(int fd, off_t offset, off_t size, size_t lines);
+static void	update_index(pappl_system_t *system, int fd, struct stat *loginfo);
 static void	write_log(pappl_system_t *system, pappl_loglevel_t level, const char *message, va_list ap);
 
 
+//
+// Globals...
+//
+
+pappl_trace_cb_t	_papplTraceCB = NULL;
+					// Trace callback
+
+
 //
 // Local globals...
 //
 
 static pthread_mutex_t	log_mutex = PTHREAD_MUTEX_INITIALIZER;
 					// Log rotation mutex
+static void		*trace_data = NULL;
+					// Trace callback data
 static const int	syslevels[] =	// Mapping of log levels to syslog
 {
   LOG_DEBUG | LOG_PID | LOG_LPR,
@@ -149,6 +161,28 @@ _papplLogAttributes(
       papplLogClient(client, PAPPL_LOGLEVEL_DEBUG, "%s %s: %s", title, is_response ? "response" : "request", ippTagString(group));
     }
 
+    if (is_response && !strcmp(name, _PAPPL_SPLICE_NAME))
+    {
+      // Pre-encoded attributes...
+      int		index,		// Splice index
+			datalen;	// Length of index
+      void		*data;		// Index data
+      size_t		i;		// Looping var
+      _pappl_splice_t	*splice;	// Splice
+
+      if ((data = ippGetOctetString(attr, 0, &datalen)) == NULL || datalen != (int)sizeof(index))
+        continue;
+
+      memcpy(&index, data, sizeof(index));
+
+      if (index < 0 || (size_t)index >= client->num_splices)
+        continue;
+
+      for (i = 0, splice = client->splices + index; i < splice->num_attrs; i ++)
+        papplLogClient(client, PAPPL_LOGLEVEL_DEBUG, "%s response:   %s (pre-encoded, %u bytes)", title, splice->attrs[i]->name, (unsigned)splice->attrs[i]->length);
+      continue;
+    }
+
     ippAttributeString(attr, value, sizeof(value));
     papplLogClient(client, PAPPL_LOGLEVEL_DEBUG, "%s %s:   %s %s%s %s", title, is_response ? "response" : "request", name, ippGetCount(attr) > 1 ? "1setOf " : "", ippTagString(ippGetValueTag(attr)), value);
   }
@@ -201,6 +235,177 @@ papplLogClient(
 }
 
 
+//
+// '_papplLogCopyTail()' - Copy filtered lines from the log file.
+//
+// This function copies complete lines from the log file starting at the
+// requested offset or, when the offset is `-1`, the requested number of lines
+// from the end of the log file.  An offset past the end of the log file (after
+// the log has been rotated) starts over at the beginning of the file.
+//
+// Lines are filtered by level, printer, and job, so the "start" and "next"
+// offsets describe the part of the log file that was read, which may be more
+// than what is returned.  Since job IDs are only unique for a printer, the job
+// filter is only used together with the printer filter.  The returned string must be freed using `free`.
+//
+
+char *					// O - Log lines or `NULL` on error
+_papplLogCopyTail(
+    pappl_system_t     *system,		// I - System
+    _pappl_logfilter_t *filter,		// I - Filter
+    off_t              *start,		// O - Starting offset
+    off_t              *next,		// O - Next offset
+    off_t              *size)		// O - Size of log file
+{
+  int		fd;			// Log file descriptor
+  struct stat	loginfo;		// Log file information
+  off_t		offset;			// Starting offset
+  size_t	length,			// Number of bytes to read
+		linelen,		// Length of current line
+		lo,			// Low index entry
+		hi,			// High index entry
+		mid,			// Middle index entry
+		target;			// Target line number
+  ssize_t	bytes;			// Bytes read
+  char		*buffer,		// Read buffer
+		*bufptr,		// Pointer into buffer
+		*bufend,		// End of complete lines in buffer
+		*lineend,		// End of current line
+		*output,		// Output buffer
+		*outptr,		// Pointer into output buffer
+		prefix[300];		// "[Printer NAME] [Job N] " prefix
+  size_t	prefixlen = 0;		// Length of prefix
+  const char	*level;			// Level character in prefix
+  static const char *levels = "DIWEF";	// Level characters
+
+
+  *start = *next = *size = 0;
+
+  if (!system || !filter || !system->logfile || (fd = open(system->logfile, O_RDONLY)) < 0)
+    return (NULL);
+
+  if (fstat(fd, &loginfo))
+  {
+    close(fd);
+    return (NULL);
+  }
+
+  *size = loginfo.st_size;
+
+  if (filter->offset >= 0)
+  {
+    // Continue from the requested offset...
+    offset = filter->offset <= loginfo.st_size ? filter->offset : 0;
+  }
+  else
+  {
+    // Find the starting line using the line index, then skip forward to the
+    // exact line...
+    pthread_mutex_lock(&system->logindex_mutex);
+
+    update_index(system, fd, &loginfo);
+
+    target = system->logindex_lines > filter->lines ? system->logindex_lines - filter->lines : 0;
+
+    for (lo = 0, hi = system->num_logindex; (hi - lo) > 1;)
+    {
+      mid = (lo + hi) / 2;
+
+      if (system->logindex[mid].line <= target)
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+    if (system->num_logindex > 0)
+    {
+      offset = system->logindex[lo].offset;
+      target -= system->logindex[lo].line;
+    }
+    else
+      offset = 0;
+
+    pthread_mutex_unlock(&system->logindex_mutex);
+
+    offset = skip_lines(fd, offset, loginfo.st_size, target);
+
+    // Don't send more than the maximum number of bytes...
+    if ((size_t)(loginfo.st_size - offset) > filter->maxbytes)
+      offset = skip_lines(fd, loginfo.st_size - (off_t)filter->maxbytes, loginfo.st_size, 1);
+  }
+
+  *start = *next = offset;
+
+  // Read the log data...
+  if ((length = (size_t)(loginfo.st_size - offset)) > filter->maxbytes)
+    length = filter->maxbytes;
+
+  if ((buffer = malloc(length + 1)) == NULL || (output = malloc(length + 1)) == NULL)
+  {
+    free(buffer);
+    close(fd);
+    return (NULL);
+  }
+
+  for (bufptr = buffer; length > 0; bufptr += bytes, length -= (size_t)bytes)
+  {
+    if ((bytes = pread(fd, bufptr, length, offset + (bufptr - buffer))) <= 0)
+      break;
+  }
+
+  close(fd);
+
+  // Only use complete lines, unless a single line is longer than the maximum
+  // number of bytes...
+  bufend = bufptr;
+
+  while (bufend > buffer && bufend[-1] != '\n')
+    bufend --;
+
+  if (bufend == buffer && (size_t)(bufptr - buffer) >= filter->maxbytes)
+    bufend = bufptr;
+
+  *next = offset + (bufend - buffer);
+
+  // Copy matching lines, which for a printer and job start with
+  // "[Printer NAME] " or "[Printer NAME] [Job N] " after the level and
+  // timestamp...
+  if (filter->printer && filter->job_id > 0)
+    snprintf(prefix, sizeof(prefix), "[Printer %s] [Job %d] ", filter->printer, filter->job_id);
+  else if (filter->printer)
+    snprintf(prefix, sizeof(prefix), "[Printer %s] ", filter->printer);
+
+  if (filter->printer)
+    prefixlen = strlen(prefix);
+
+  for (bufptr = buffer, outptr = output; bufptr < bufend; bufptr = lineend)
+  {
+    if ((lineend = memchr(bufptr, '\n', (size_t)(bufend - bufptr))) != NULL)
+      lineend ++;
+    else
+      lineend = bufend;
+
+    linelen = (size_t)(lineend - bufptr);
+
+    // Lines start with "L [YYYY-MM-DDTHH:MM:SS.SSSZ] " followed by the message...
+    if (filter->level > PAPPL_LOGLEVEL_DEBUG && (level = strchr(levels, *bufptr)) != NULL && (level - levels) < filter->level)
+      continue;
+
+    if (prefixlen > 0 && (linelen < (29 + prefixlen) || memcmp(bufptr + 29, prefix, prefixlen)))
+      continue;
+
+    memcpy(outptr, bufptr, linelen);
+    outptr += linelen;
+  }
+
+  *outptr = '\0';
+
+  free(buffer);
+
+  return (output);
+}
+
+
 //
 // 'papplLogDevice()' - Log a device error for the system...
 //
@@ -244,7 +449,9 @@ papplLogJob(
     const char       *message,		// I - Printf-style message string
     ...)				// I - Additional arguments as needed
 {
-  char		jmessage[1024];		// Message with job prefix
+  char		jmessage[1024],		// Message with printer and job prefix
+		*jptr,			// Pointer into prefix
+		*nameptr;		// Pointer into printer name
   va_list	ap;			// Pointer to arguments
 
 
@@ -254,7 +461,16 @@ papplLogJob(
   if (level < job->system->loglevel)
     return;
 
-  snprintf(jmessage, sizeof(jmessage), "[Job %d] %s", job->job_id, message);
+  // Prefix the message with "[Printer foo] [Job N]", making sure to not insert
+  // any printf format specifiers.  Job IDs are only unique for a printer...
+  strlcpy(jmessage, "[Printer ", sizeof(jmessage));
+  for (jptr = jmessage + 9, nameptr = job->printer->name; *nameptr && jptr < (jmessage + 200); jptr ++)
+  {
+    if (*nameptr == '%')
+      *jptr++ = '%';
+    *jptr = *nameptr++;
+  }
+  snprintf(jptr, sizeof(jmessage) - (size_t)(jptr - jmessage), "] [Job %d] %s", job->job_id, message);
   va_start(ap, message);
 
   if (job->system->logfd >= 0)
@@ -369,6 +585,52 @@ papplLogPrinter(
 }
 
 
+//
+// 'papplLogSetTraceCallback()' - Set a callback for trace points.
+//
+// This function sets a callback that is called for each trace point: HTTP
+// requests, IPP operations, job state changes, device opens, writes, and
+// flushes, and page boundaries.  The callback is called from many threads at
+// once and must return quickly.  Pass `NULL` to remove the callback.
+//
+// When the library is built with <sys/sdt.h>, the same trace points are also
+// available as USDT probes for the "pappl" provider.  Trace points are not
+// available when the library is configured with "--disable-tracing".
+//
+// The callback should be set before calling @link papplSystemRun@.
+//
+// @since PAPPL 1.1@
+//
+
+void
+papplLogSetTraceCallback(
+    pappl_trace_cb_t cb,		// I - Trace callback or `NULL` for none
+    void             *data)		// I - Trace callback data
+{
+  trace_data    = data;
+  _papplTraceCB = cb;
+}
+
+
+//
+// '_papplTrace()' - Call the trace callback.
+//
+
+void
+_papplTrace(pappl_trace_t point,	// I - Trace point
+            const char    *name,	// I - Name, if any
+            int           id,		// I - Numeric identifier
+            size_t        value)	// I - Value
+{
+  pappl_trace_cb_t	cb = _papplTraceCB;
+					// Trace callback
+
+
+  if (cb)
+    (cb)(point, name, id, value, trace_data);
+}
+
+
 //
 // 'rotate_log()' - Rotate the log file...
 //
@@ -394,6 +656,120 @@ rotate_log(pappl_system_t *system)	// I - System
 }
 
 
+//
+// 'skip_lines()' - Skip lines in the log file.
+//
+
+static off_t				// O - Offset after the skipped lines
+skip_lines(int    fd,			// I - Log file descriptor
+           off_t  offset,		// I - Starting offset
+           off_t  size,			// I - Size of log file
+           size_t lines)		// I - Number of lines to skip
+{
+  char		buffer[8192],		// Read buffer
+		*bufptr,		// Pointer into buffer
+		*bufend;		// End of buffer
+  ssize_t	bytes;			// Bytes read
+
+
+  while (lines > 0 && offset < size && (bytes = pread(fd, buffer, sizeof(buffer), offset)) > 0)
+  {
+    for (bufptr = buffer, bufend = buffer + bytes; lines > 0 && (bufptr = memchr(bufptr, '\n', (size_t)(bufend - bufptr))) != NULL; lines --)
+      bufptr ++;
+
+    if (lines == 0)
+      return (offset + (bufptr - buffer));
+
+    offset += bytes;
+  }
+
+  return (offset < size ? offset : size);
+}
+
+
+//
+// 'update_index()' - Update the log line index.
+//
+// The index records the offset and number of one line every
+// `_PAPPL_LOG_INDEX_BYTES` bytes, and is updated incrementally as the log
+// grows.  Call with the `logindex_mutex` held.
+//
+
+static void
+update_index(pappl_system_t *system,	// I - System
+             int            fd,		// I - Log file descriptor
+             struct stat    *loginfo)	// I - Log file information
+{
+  char		buffer[32768],		// Read buffer
+		*bufptr,		// Pointer into buffer
+		*bufend;		// End of buffer
+  ssize_t	bytes;			// Bytes read
+  off_t		offset,			// Current offset
+		lineoffset;		// Offset of next line
+  _pappl_logline_t *entry;		// New index entry
+
+
+  // Start over if the log file has been rotated...
+  if (loginfo->st_ino != system->logindex_ino || loginfo->st_size < system->logindex_size)
+  {
+    system->logindex_ino   = loginfo->st_ino;
+    system->logindex_size  = 0;
+    system->logindex_lines = 0;
+    system->num_logindex   = 0;
+  }
+
+  if (system->num_logindex == 0)
+  {
+    if (!system->logindex)
+    {
+      if ((system->logindex = calloc(64, sizeof(_pappl_logline_t))) == NULL)
+        return;
+
+      system->alloc_logindex = 64;
+    }
+
+    system->logindex[0].offset = 0;
+    system->logindex[0].line   = 0;
+    system->num_logindex       = 1;
+  }
+
+  // Scan any new data for line breaks...
+  for (offset = system->logindex_size; offset < loginfo->st_size; offset += bytes)
+  {
+    if ((bytes = pread(fd, buffer, sizeof(buffer), offset)) <= 0)
+      break;
+
+    for (bufptr = buffer, bufend = buffer + bytes; (bufptr = memchr(bufptr, '\n', (size_t)(bufend - bufptr))) != NULL;)
+    {
+      bufptr ++;
+      system->logindex_lines ++;
+
+      lineoffset = offset + (bufptr - buffer);
+
+      if ((lineoffset - system->logindex[system->num_logindex - 1].offset) < _PAPPL_LOG_INDEX_BYTES)
+        continue;
+
+      if (system->num_logindex >= system->alloc_logindex)
+      {
+        if ((entry = realloc(system->logindex, 2 * system->alloc_logindex * sizeof(_pappl_logline_t))) == NULL)
+          continue;
+
+        system->logindex       = entry;
+        system->alloc_logindex *= 2;
+      }
+
+      entry = system->logindex + system->num_logindex;
+      system->num_logindex ++;
+
+      entry->offset = lineoffset;
+      entry->line   = system->logindex_lines;
+    }
+  }
+
+  system->logindex_size = offset;
+}
+
+
 //
 // 'write_log()' - Write a line to the log file...
 //
@@ -640,5 +1016,6 @@ write_log(pappl_system_t   *system,	// I - System
   // Add a newline and write it out...
   *bufptr++ = '\n';
 
-  write(system->logfd, buffer, (size_t)(bufptr - buffer));
+  if (write(system->logfd, buffer, (size_t)(bufptr - buffer)) < (ssize_t)(bufptr - buffer))
+    _papplSystemAddMetricCount(system, _PAPPL_COUNTER_LOG_DROPS, 1);
 }
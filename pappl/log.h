@@ -41,6 +41,26 @@ typedef enum pappl_loglevel_e		// Log levels
   PAPPL_LOGLEVEL_FATAL				// Fatal message
 } pappl_loglevel_t;
 
+typedef enum pappl_trace_e		// Trace points @since PAPPL 1.1@
+{
+  PAPPL_TRACE_HTTP_REQUEST,			// HTTP request (name=resource, id=client number, value=method)
+  PAPPL_TRACE_IPP_OPERATION,			// IPP operation (name=operation, id=client number, value=operation code)
+  PAPPL_TRACE_JOB_STATE,			// Job state change (name=printer, id=job-id, value=job-state)
+  PAPPL_TRACE_DEVICE_OPEN,			// Device open (name=device URI, id=0, value=1 on success)
+  PAPPL_TRACE_DEVICE_WRITE,			// Device write (name=`NULL`, id=0, value=bytes)
+  PAPPL_TRACE_DEVICE_FLUSH,			// Device flush (name=`NULL`, id=0, value=bytes)
+  PAPPL_TRACE_PAGE_START,			// Start of page (name=printer, id=job-id, value=page number)
+  PAPPL_TRACE_PAGE_END				// End of page (name=printer, id=job-id, value=page number)
+} pappl_trace_t;
+
+
+//
+// Callback function types...
+//
+
+typedef void (*pappl_trace_cb_t)(pappl_trace_t point, const char *name, int id, size_t value, void *data);
+					// Trace callback function @since PAPPL 1.1@
+
 
 //
 // Functions...
@@ -51,6 +71,7 @@ extern void		papplLogClient(pappl_client_t *client, pappl_loglevel_t level, cons
 extern void		papplLogDevice(const char *message, void *data) _PAPPL_PUBLIC;
 extern void		papplLogJob(pappl_job_t *job, pappl_loglevel_t level, const char *message, ...) _PAPPL_PUBLIC _PAPPL_FORMAT(3, 4);
 extern void		papplLogPrinter(pappl_printer_t *printer, pappl_loglevel_t level, const char *message, ...) _PAPPL_PUBLIC _PAPPL_FORMAT(3, 4);
+extern void		papplLogSetTraceCallback(pappl_trace_cb_t cb, void *data) _PAPPL_PUBLIC;
 
 
 //
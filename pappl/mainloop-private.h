@@ -27,6 +27,16 @@ extern "C" {
 #  endif // __cplusplus
 
 
+//
+// Constants...
+//
+
+#  define _PAPPL_MAINLOOP_LISTEN_FD	"PAPPL_LISTEN_FD"
+					// Environment variable for inherited listener socket
+#  define _PAPPL_MAINLOOP_READY_FD	"PAPPL_READY_FD"
+					// Environment variable for server readiness pipe
+
+
 //
 // Globals...
 //
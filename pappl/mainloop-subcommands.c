@@ -33,6 +33,24 @@ typedef struct _pappl_ml_printer_s	// Printer data
   char	*device_id;			// IEEE-1284 device ID
 } _pappl_ml_printer_t;
 
+typedef struct _pappl_ml_submit_s	// Submit data
+{
+  pthread_mutex_t	mutex;		// Mutex for submit data
+  const char		*base_name;	// Base name
+  int			num_options;	// Number of options
+  cups_option_t		*options;	// Options
+  const char		*printer_name,	// Printer name
+			*printer_uri;	// Printer URI
+  ipp_t			*supported;	// Supported attributes
+  int			num_files;	// Number of files
+  char			**files;	// Files
+  int			next_file,	// Next file to submit
+			num_jobs,	// Number of jobs submitted
+			*job_ids;	// Job IDs for each file
+  size_t		bytes;		// Number of bytes submitted
+  bool			failed;		// Did a submission fail?
+} _pappl_ml_submit_t;
+
 
 //
 // Local functions
@@ -40,13 +58,14 @@ typedef struct _pappl_ml_printer_s	// Printer data
 
 static int	compare_printers(_pappl_ml_printer_t *a, _pappl_ml_printer_t *b);
 static _pappl_ml_printer_t *copy_printer(_pappl_ml_printer_t *p);
-static char	*copy_stdin(const char *base_name, char *name, size_t namesize);
 static bool	device_autoadd_cb(const char *device_info, const char *device_uri, const char *device_id, void *data);
 static void	device_error_cb(const char *message, void *err_data);
 static bool	device_list_cb(const char *device_info, const char *device_uri, const char *device_id, void *data);
 static void	free_printer(_pappl_ml_printer_t *p);
 static char	*get_value(ipp_attribute_t *attr, const char *name, int element, char *buffer, size_t bufsize);
 static void	print_option(ipp_t *response, const char *name);
+static bool	submit_file(_pappl_ml_submit_t *submit, http_t *http, ipp_t *supported, char *resource, size_t rsize, int file);
+static void	*submit_thread(_pappl_ml_submit_t *submit);
 
 
 //
@@ -535,6 +554,7 @@ _papplMainloopRunServer(
   pappl_system_t	*system;	// System object
   char			sockname[1024],	// Socket filename
 			statename[1024];// State filename
+  const char		*env;		// Environment variable
 
 
   // Create the system object...
@@ -620,8 +640,30 @@ _papplMainloopRunServer(
   if (system->num_drivers == 0 && num_drivers > 0 && drivers && driver_cb)
     papplSystemSetPrinterDrivers(system, num_drivers, drivers, autoadd_cb, /* create_cb */NULL, driver_cb, data);
 
-  // Listen for connections...
-  papplSystemAddListeners(system, _papplMainloopGetServerPath(base_name, sockname, sizeof(sockname)));
+  // Listen for connections, using the listener socket from the command that
+  // started us if provided...
+  _papplMainloopGetServerPath(base_name, sockname, sizeof(sockname));
+
+  if ((env = getenv(_PAPPL_MAINLOOP_LISTEN_FD)) == NULL || !_papplSystemAddListenerFd(system, (int)strtol(env, NULL, 10), sockname))
+    papplSystemAddListeners(system, sockname);
+
+  // Tell the command that started us that we are ready for connections...
+  if ((env = getenv(_PAPPL_MAINLOOP_READY_FD)) != NULL)
+  {
+    int	ready_fd = (int)strtol(env, NULL, 10);
+					// Readiness pipe
+
+    if (ready_fd > 2)
+    {
+      if (write(ready_fd, "R", 1) < 0)
+        papplLog(system, PAPPL_LOGLEVEL_WARN, "Unable to send readiness notification: %s", strerror(errno));
+
+      close(ready_fd);
+    }
+  }
+
+  unsetenv(_PAPPL_MAINLOOP_LISTEN_FD);
+  unsetenv(_PAPPL_MAINLOOP_READY_FD);
 
   // Finish initialization...
   if (!system->save_cb)
@@ -1086,6 +1128,12 @@ _papplMainloopShutdownServer(
 //
 // '_papplMainloopSubmitJob()' - Submit job(s).
 //
+// Each file is sent using a separate Print-Job request with the data streamed
+// as it is read, so the standard input is sent without a temporary file.  The
+// "submit-connections" option sends multiple files concurrently over up to 16
+// connections.  A throughput summary is shown when more than one file is
+// submitted.
+//
 
 int					// O - Exit status
 _papplMainloopSubmitJob(
@@ -1095,22 +1143,18 @@ _papplMainloopSubmitJob(
     int           num_files,		// I - Number of files
     char          **files)		// I - Files
 {
-  const char	*document_format,	// Document format
-		*document_name,		// Document name
-		*filename,		// Current print filename
-		*job_name,		// Job name
-		*printer_name,		// Printer name
-		*printer_uri;		// Printer URI
+  _pappl_ml_submit_t submit;		// Submit data
+  const char	*value;			// Option value
   http_t	*http;			// Server connection
-  ipp_t		*request,		// IPP request
-		*response,		// IPP response
-		*supported;		// Supported attributes
+  ipp_t		*request;		// IPP request
   char		default_printer[256],	// Default printer name
-		resource[1024],		// Resource path
-		tempfile[1024];		// Temporary file
-  int		i;			// Looping var
+		resource[1024];		// Resource path
+  int		i,			// Looping var
+		num_threads = 1;	// Number of submit threads
+  pthread_t	threads[16];		// Submit threads
   char		*stdin_file;		// Dummy filename for passive stdin jobs
-  ipp_attribute_t *job_id;		// job-id for created job
+  double	start,			// Start time
+		elapsed;		// Elapsed time
 
 
   // If there are no input files and stdin is not a TTY, treat that as an
@@ -1128,10 +1172,18 @@ _papplMainloopSubmitJob(
     return (1);
   }
 
-  if ((printer_uri = cupsGetOption("printer-uri", num_options, options)) != NULL)
+  memset(&submit, 0, sizeof(submit));
+
+  submit.base_name   = base_name;
+  submit.num_options = num_options;
+  submit.options     = options;
+  submit.num_files   = num_files;
+  submit.files       = files;
+
+  if ((submit.printer_uri = cupsGetOption("printer-uri", num_options, options)) != NULL)
   {
     // Connect to the remote printer...
-    if ((http = _papplMainloopConnectURI(base_name, printer_uri, resource, sizeof(resource))) == NULL)
+    if ((http = _papplMainloopConnectURI(base_name, submit.printer_uri, resource, sizeof(resource))) == NULL)
       return (1);
   }
   else
@@ -1140,9 +1192,9 @@ _papplMainloopSubmitJob(
     if ((http = _papplMainloopConnect(base_name, true)) == NULL)
       return (1);
 
-    if ((printer_name = cupsGetOption("printer-name", num_options, options)) == NULL)
+    if ((submit.printer_name = cupsGetOption("printer-name", num_options, options)) == NULL)
     {
-      if ((printer_name = _papplMainloopGetDefaultPrinter(http, default_printer, sizeof(default_printer))) == NULL)
+      if ((submit.printer_name = _papplMainloopGetDefaultPrinter(http, default_printer, sizeof(default_printer))) == NULL)
       {
         fprintf(stderr, "%s: No default printer available.\n", base_name);
         httpClose(http);
@@ -1151,85 +1203,107 @@ _papplMainloopSubmitJob(
     }
   }
 
-  // Loop through the print files
-  job_name        = cupsGetOption("job-name", num_options, options);
-  document_format = cupsGetOption("document-format", num_options, options);
-
-  for (i = 0; i < num_files; i ++)
+  if ((value = cupsGetOption("submit-connections", num_options, options)) != NULL)
   {
-    // Get the current print file...
-    if (!strcmp(files[i], "-"))
-    {
-      if (!copy_stdin(base_name, tempfile, sizeof(tempfile)))
-      {
-        httpClose(http);
-        return (1);
-      }
+    char	*end;			// End of value
 
-      filename      = tempfile;
-      document_name = "(stdin)";
-    }
-    else
+    num_threads = (int)strtol(value, &end, 10);
+
+    if (num_threads < 1 || num_threads > (int)(sizeof(threads) / sizeof(threads[0])) || *end)
     {
-      filename = files[i];
-      if ((document_name = strrchr(filename, '/')) != NULL)
-        document_name ++;
-      else
-        document_name = filename;
+      fprintf(stderr, "%s: Bad 'submit-connections' value '%s'.\n", base_name, value);
+      httpClose(http);
+      return (1);
     }
 
-    // Send a Get-Printer-Attributes request...
-    request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
-    if (printer_uri)
-      ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, printer_uri);
-    else
-      _papplMainloopAddPrinterURI(request, printer_name, resource, sizeof(resource));
+    if (num_threads > num_files)
+      num_threads = num_files;
+  }
 
-    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+  if ((submit.job_ids = (int *)calloc((size_t)num_files, sizeof(int))) == NULL)
+  {
+    fprintf(stderr, "%s: Unable to allocate memory.\n", base_name);
+    httpClose(http);
+    return (1);
+  }
 
-    supported = cupsDoRequest(http, request, resource);
+  pthread_mutex_init(&submit.mutex, NULL);
 
-    // Send a Print-Job request...
-    request = ippNewRequest(IPP_OP_PRINT_JOB);
-    if (printer_uri)
-      ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, printer_uri);
-    else
-      _papplMainloopAddPrinterURI(request, printer_name, resource, sizeof(resource));
+  // Send a Get-Printer-Attributes request - the same printer is used for all
+  // of the files...
+  request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
+  if (submit.printer_uri)
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, submit.printer_uri);
+  else
+    _papplMainloopAddPrinterURI(request, submit.printer_name, resource, sizeof(resource));
 
-    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
-    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "job-name", NULL, job_name ? job_name : document_name);
-    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "document-name", NULL, document_name);
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+
+  submit.supported = cupsDoRequest(http, request, resource);
+
+  // Submit the files...
+  start = _papplGetTime();
+
+  if (num_threads == 1)
+  {
+    // Submit over the current connection, showing job IDs as they are created...
+    for (i = 0; i < num_files && submit_file(&submit, http, submit.supported, resource, sizeof(resource), i); i ++)
+    {
+      if (submit.printer_uri)
+        printf("%d\n", submit.job_ids[i]);
+      else
+        printf("%s-%d\n", submit.printer_name, submit.job_ids[i]);
+    }
+  }
+  else
+  {
+    // Submit over multiple connections and then show the job IDs in order...
+    for (i = 0; i < num_threads; i ++)
+    {
+      if (pthread_create(threads + i, NULL, (void *(*)(void *))submit_thread, &submit))
+      {
+        fprintf(stderr, "%s: Unable to create submit thread: %s\n", base_name, strerror(errno));
+        break;
+      }
+    }
 
-    if (document_format)
-      ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_MIMETYPE, "document-format", NULL, document_format);
+    num_threads = i;
 
-    _papplMainloopAddOptions(request, num_options, options, supported);
-    ippDelete(supported);
+    if (num_threads == 0)
+      submit_thread(&submit);
 
-    response = cupsDoFileRequest(http, request, resource, filename);
+    for (i = 0; i < num_threads; i ++)
+      pthread_join(threads[i], NULL);
 
-    if ((job_id = ippFindAttribute(response, "job-id", IPP_TAG_INTEGER)) == NULL)
+    for (i = 0; i < num_files; i ++)
     {
-      fprintf(stderr, "%s: Unable to print '%s': %s\n", base_name, filename, cupsLastErrorString());
-      ippDelete(response);
-      httpClose(http);
-      return (1);
+      if (submit.job_ids[i] <= 0)
+        continue;
+
+      if (submit.printer_uri)
+        printf("%d\n", submit.job_ids[i]);
+      else
+        printf("%s-%d\n", submit.printer_name, submit.job_ids[i]);
     }
+  }
 
-    if (printer_uri)
-      printf("%d\n", ippGetInteger(job_id, 0));
-    else
-      printf("%s-%d\n", printer_name, ippGetInteger(job_id, 0));
+  elapsed = _papplGetTime() - start;
 
-    ippDelete(response);
+  if (num_files > 1)
+  {
+    if (elapsed <= 0.0)
+      elapsed = 0.001;
 
-    if (filename == tempfile)
-      unlink(tempfile);
+    fprintf(stderr, "%s: Submitted %d of %d files (%.1f KiB) in %.3f seconds, %.1f jobs/second, %.1f KiB/second.\n", base_name, submit.num_jobs, num_files, submit.bytes / 1024.0, elapsed, submit.num_jobs / elapsed, submit.bytes / 1024.0 / elapsed);
   }
 
+  ippDelete(submit.supported);
+  free(submit.job_ids);
+  pthread_mutex_destroy(&submit.mutex);
+
   httpClose(http);
 
-  return (0);
+  return (submit.failed ? 1 : 0);
 }
 
 
@@ -1274,67 +1348,6 @@ copy_printer(_pappl_ml_printer_t *p)	// I - Printer to copy
 }
 
 
-//
-// 'copy_stdin()' - Copy print data from the standard input.
-//
-
-static char *				// O - Temporary filename or `NULL` on error
-copy_stdin(
-    const char *base_name,		// I - Printer application name
-    char       *name,			// I - Filename buffer
-    size_t     namesize)		// I - Size of filename buffer
-{
-  int		tempfd;			// Temporary file descriptor
-  size_t	total = 0;		// Total bytes read/written
-  ssize_t	bytes;			// Number of bytes read/written
-  char		buffer[65536];		// Copy buffer
-
-
-  // Create a temporary file for printing...
-  if ((tempfd = cupsTempFd(name, (int)namesize)) < 0)
-  {
-    fprintf(stderr, "%s: Unable to create temporary file: %s\n", base_name, strerror(errno));
-    return (NULL);
-  }
-
-  // Read from stdin until we see EOF...
-  while ((bytes = read(0, buffer, sizeof(buffer))) > 0)
-  {
-    if (write(tempfd, buffer, (size_t)bytes) < 0)
-    {
-      fprintf(stderr, "%s: Unable to write to temporary file: %s\n", base_name, strerror(errno));
-      goto fail;
-    }
-
-    total += (size_t)bytes;
-  }
-
-  // Only allow non-empty files...
-  if (total == 0)
-  {
-    fprintf(stderr, "%s: Empty print file received on the standard input.\n", base_name);
-    goto fail;
-  }
-
-  // Close the temporary file and return it...
-  close(tempfd);
-
-  return (name);
-
-  // If we get here, something went wrong...
-  fail:
-
-  // Close and remove the temporary file...
-  close(tempfd);
-  unlink(name);
-
-  // Return NULL and an empty filename...
-  *name = '\0';
-
-  return (NULL);
-}
-
-
 //
 // 'device_autoadd_cb()' - Device callback.
 //
@@ -1563,3 +1576,195 @@ print_option(ipp_t      *response,	// I - Get-Printer-Attributes response
       printf("  -o %s=%s\n", name, supvalue);
   }
 }
+
+
+//
+// 'submit_file()' - Submit a single file for printing.
+//
+
+static bool				// O - `true` on success, `false` on failure
+submit_file(
+    _pappl_ml_submit_t *submit,		// I - Submit data
+    http_t             *http,		// I - Server connection
+    ipp_t              *supported,	// I - Supported attributes
+    char               *resource,	// I - Resource path buffer
+    size_t             rsize,		// I - Size of resource path buffer
+    int                file)		// I - File number
+{
+  const char	*filename,		// Print filename
+		*document_format,	// Document format
+		*document_name,		// Document name
+		*job_name;		// Job name
+  int		fd;			// File descriptor
+  ipp_t		*request,		// IPP request
+		*response;		// IPP response
+  ipp_attribute_t *job_id;		// job-id for created job
+  http_status_t	status;			// Status of request
+  ssize_t	bytes;			// Bytes read
+  size_t	total = 0;		// Total bytes sent
+  char		buffer[65536];		// Copy buffer
+
+
+  // Open the current print file...
+  filename = submit->files[file];
+
+  if (!strcmp(filename, "-"))
+  {
+    fd            = 0;
+    document_name = "(stdin)";
+  }
+  else if ((fd = open(filename, O_RDONLY)) < 0)
+  {
+    fprintf(stderr, "%s: Unable to open '%s': %s\n", submit->base_name, filename, strerror(errno));
+    goto fail;
+  }
+  else if ((document_name = strrchr(filename, '/')) != NULL)
+    document_name ++;
+  else
+    document_name = filename;
+
+  // Read the first block so that empty input can be rejected before the job
+  // is created...
+  if ((bytes = read(fd, buffer, sizeof(buffer))) < 0)
+  {
+    fprintf(stderr, "%s: Unable to read '%s': %s\n", submit->base_name, filename, strerror(errno));
+    goto fail;
+  }
+  else if (bytes == 0 && fd == 0)
+  {
+    fprintf(stderr, "%s: Empty print file received on the standard input.\n", submit->base_name);
+    goto fail;
+  }
+
+  // Send a Print-Job request...
+  job_name        = cupsGetOption("job-name", submit->num_options, submit->options);
+  document_format = cupsGetOption("document-format", submit->num_options, submit->options);
+
+  request = ippNewRequest(IPP_OP_PRINT_JOB);
+  if (submit->printer_uri)
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, submit->printer_uri);
+  else
+    _papplMainloopAddPrinterURI(request, submit->printer_name, resource, rsize);
+
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "job-name", NULL, job_name ? job_name : document_name);
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "document-name", NULL, document_name);
+
+  if (document_format)
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_MIMETYPE, "document-format", NULL, document_format);
+
+  _papplMainloopAddOptions(request, submit->num_options, submit->options, supported);
+
+  // Stream the document data as it is read...
+  status = cupsSendRequest(http, request, resource, CUPS_LENGTH_VARIABLE);
+
+  while (status == HTTP_STATUS_CONTINUE && bytes > 0)
+  {
+    status = cupsWriteRequestData(http, buffer, (size_t)bytes);
+    total  += (size_t)bytes;
+    bytes  = read(fd, buffer, sizeof(buffer));
+  }
+
+  ippDelete(request);
+
+  if (bytes < 0)
+  {
+    // Don't finish the request so the server discards the partial job...
+    fprintf(stderr, "%s: Unable to read '%s': %s\n", submit->base_name, filename, strerror(errno));
+    httpShutdown(http);
+    goto fail;
+  }
+
+  if (fd > 0)
+    close(fd);
+
+  fd       = -1;
+  response = cupsGetResponse(http, resource);
+
+  if ((job_id = ippFindAttribute(response, "job-id", IPP_TAG_INTEGER)) == NULL)
+  {
+    fprintf(stderr, "%s: Unable to print '%s': %s\n", submit->base_name, filename, cupsLastErrorString());
+    ippDelete(response);
+    goto fail;
+  }
+
+  pthread_mutex_lock(&submit->mutex);
+  submit->job_ids[file] = ippGetInteger(job_id, 0);
+  submit->num_jobs ++;
+  submit->bytes += total;
+  pthread_mutex_unlock(&submit->mutex);
+
+  ippDelete(response);
+
+  return (true);
+
+  // If we get here, something went wrong...
+  fail:
+
+  if (fd > 0)
+    close(fd);
+
+  pthread_mutex_lock(&submit->mutex);
+  submit->failed = true;
+  pthread_mutex_unlock(&submit->mutex);
+
+  return (false);
+}
+
+
+//
+// 'submit_thread()' - Submit files over a separate connection.
+//
+
+static void *				// O - Thread exit status
+submit_thread(
+    _pappl_ml_submit_t *submit)		// I - Submit data
+{
+  http_t	*http;			// Server connection
+  ipp_t		*supported;		// Supported attributes
+  char		resource[1024];		// Resource path
+  int		file;			// Current file
+
+
+  // Open a connection for this thread...
+  if (submit->printer_uri)
+    http = _papplMainloopConnectURI(submit->base_name, submit->printer_uri, resource, sizeof(resource));
+  else
+    http = _papplMainloopConnect(submit->base_name, false);
+
+  if (!http)
+  {
+    pthread_mutex_lock(&submit->mutex);
+    submit->failed = true;
+    pthread_mutex_unlock(&submit->mutex);
+
+    return (NULL);
+  }
+
+  // Use a private copy of the supported attributes since looking up attributes
+  // is not thread-safe...
+  supported = ippNew();
+
+  pthread_mutex_lock(&submit->mutex);
+  ippCopyAttributes(supported, submit->supported, 0, NULL, NULL);
+  pthread_mutex_unlock(&submit->mutex);
+
+  // Submit files until there are no more or a submission fails...
+  for (;;)
+  {
+    pthread_mutex_lock(&submit->mutex);
+    if (submit->failed || submit->next_file >= submit->num_files)
+      file = -1;
+    else
+      file = submit->next_file ++;
+    pthread_mutex_unlock(&submit->mutex);
+
+    if (file < 0 || !submit_file(submit, http, supported, resource, sizeof(resource), file))
+      break;
+  }
+
+  ippDelete(supported);
+  httpClose(http);
+
+  return (NULL);
+}
@@ -330,25 +330,94 @@ _papplMainloopConnect(
       "server",
       NULL
     };
+    http_addrlist_t *addrlist;		// Domain socket address
+    int		listen_fd = -1,		// Listener socket for server
+		ready_fds[2];		// Server readiness pipe
+    char	fdstr[32];		// File descriptor string
+    bool	spawned;		// Did the server start?
+
+    // Open the domain socket listener for the server so that connections are
+    // queued as soon as it starts, and create a pipe for the server to tell us
+    // when it is ready...
+    if ((addrlist = httpAddrGetList(sockname, AF_LOCAL, "0")) != NULL)
+    {
+      if ((listen_fd = httpAddrListen(&addrlist->addr, 0)) >= 0)
+      {
+        fcntl(listen_fd, F_SETFD, 0);
+        snprintf(fdstr, sizeof(fdstr), "%d", listen_fd);
+        setenv(_PAPPL_MAINLOOP_LISTEN_FD, fdstr, 1);
+      }
+
+      httpAddrFreeList(addrlist);
+    }
+
+    if (pipe(ready_fds))
+    {
+      ready_fds[0] = ready_fds[1] = -1;
+    }
+    else
+    {
+      fcntl(ready_fds[0], F_SETFD, FD_CLOEXEC);
+      snprintf(fdstr, sizeof(fdstr), "%d", ready_fds[1]);
+      setenv(_PAPPL_MAINLOOP_READY_FD, fdstr, 1);
+    }
 
     posix_spawnattr_init(&server_attrs);
     posix_spawnattr_setpgroup(&server_attrs, 0);
 
-    if (posix_spawn(&server_pid, _papplMainloopPath, NULL, &server_attrs, server_argv, environ))
-    {
+    spawned = !posix_spawn(&server_pid, _papplMainloopPath, NULL, &server_attrs, server_argv, environ);
+
+    if (!spawned)
       fprintf(stderr, "%s: Unable to start server: %s\n", base_name, strerror(errno));
-      posix_spawnattr_destroy(&server_attrs);
-      return (NULL);
-    }
 
     posix_spawnattr_destroy(&server_attrs);
 
+    // The server has its own copies of the listener and pipe now...
+    unsetenv(_PAPPL_MAINLOOP_LISTEN_FD);
+    unsetenv(_PAPPL_MAINLOOP_READY_FD);
+
+    if (listen_fd >= 0)
+      close(listen_fd);
+
+    if (ready_fds[1] >= 0)
+      close(ready_fds[1]);
+
+    if (!spawned)
+    {
+      if (ready_fds[0] >= 0)
+        close(ready_fds[0]);
+
+      return (NULL);
+    }
+
     // Wait for it to start...
-    do
+    if (ready_fds[0] >= 0)
+    {
+      struct pollfd	pfd;		// Poll data
+      int		ret;		// Return value from poll
+      char		ready;		// Readiness byte
+
+      pfd.fd     = ready_fds[0];
+      pfd.events = POLLIN;
+
+      while ((ret = poll(&pfd, 1, 30000)) < 0 && errno == EINTR);
+
+      if (ret <= 0 || read(ready_fds[0], &ready, 1) != 1)
+      {
+        // Timeout or the server exited before it was ready...
+        fprintf(stderr, "%s: Server did not start.\n", base_name);
+        close(ready_fds[0]);
+        return (NULL);
+      }
+
+      close(ready_fds[0]);
+    }
+    else
     {
-      usleep(250000);
+      // No pipe, wait for the domain socket to appear...
+      while (access(sockname, 0))
+        usleep(10000);
     }
-    while (access(sockname, 0));
 
     http = httpConnect2(sockname, 0, NULL, AF_UNSPEC, HTTP_ENCRYPTION_IF_REQUESTED, 1, 30000, NULL);
 
@@ -466,6 +466,7 @@ usage(const char *base_name,		// I - Base name of application
   puts("  -m DRIVER-NAME   Specify driver (add/modify).");
   puts("  -n COPIES        Specify number of copies (submit).");
   puts("  -o NAME=VALUE    Specify option (add,modify,server,submit).");
+  puts("  -o submit-connections=N\n                   Submit files over N connections (submit).");
   puts("  -u URI           Specify ipp: or ipps: printer/server.");
   puts("  -v DEVICE-URI    Specify socket: or usb: device (add/modify).");
 }
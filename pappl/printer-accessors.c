@@ -295,7 +295,7 @@ int					// O - Number of active print jobs
 papplPrinterGetNumberOfActiveJobs(
     pappl_printer_t *printer)		// I - Printer
 {
-  return (printer ? cupsArrayCount(printer->active_jobs) : 0);
+  return (printer ? printer->active_jobs.count : 0);
 }
 
 
@@ -311,7 +311,7 @@ int					// O - Number of completed print jobs
 papplPrinterGetNumberOfCompletedJobs(
     pappl_printer_t *printer)		// I - Printer
 {
-  return (printer ? cupsArrayCount(printer->completed_jobs) : 0);
+  return (printer ? printer->completed_jobs.count : 0);
 }
 
 
@@ -326,7 +326,7 @@ int					// O - Total number of print jobs
 papplPrinterGetNumberOfJobs(
     pappl_printer_t *printer)		// I - Printer
 {
-  return (printer ? cupsArrayCount(printer->all_jobs) : 0);
+  return (printer ? printer->all_jobs.count : 0);
 }
 
 
@@ -579,7 +579,9 @@ papplPrinterIterateActiveJobs(
 
   pthread_rwlock_rdlock(&printer->rwlock);
 
-  for (job = (pappl_job_t *)cupsArrayIndex(printer->active_jobs, job_index - 1), count = 0; job; job = (pappl_job_t *)cupsArrayNext(printer->active_jobs), count ++)
+  for (job = printer->active_jobs.first; job && job_index > 1; job = job->next, job_index --);
+
+  for (count = 0; job; job = job->next, count ++)
   {
     if (limit == 0 || count < limit)
       (cb)(job, data);
@@ -619,7 +621,9 @@ papplPrinterIterateAllJobs(
 
   pthread_rwlock_rdlock(&printer->rwlock);
 
-  for (job = (pappl_job_t *)cupsArrayIndex(printer->all_jobs, job_index - 1), count = 0; job; job = (pappl_job_t *)cupsArrayNext(printer->all_jobs), count ++)
+  for (job = printer->all_jobs.first; job && job_index > 1; job = job->all_next, job_index --);
+
+  for (count = 0; job; job = job->all_next, count ++)
   {
     if (limit == 0 || count < limit)
       (cb)(job, data);
@@ -660,7 +664,9 @@ papplPrinterIterateCompletedJobs(
 
   pthread_rwlock_rdlock(&printer->rwlock);
 
-  for (job = (pappl_job_t *)cupsArrayIndex(printer->completed_jobs, job_index - 1), count = 0; job; job = (pappl_job_t *)cupsArrayNext(printer->completed_jobs), count ++)
+  for (job = printer->completed_jobs.first; job && job_index > 1; job = job->next, job_index --);
+
+  for (count = 0; job; job = job->next, count ++)
   {
     if (limit == 0 || count < limit)
       (cb)(job, data);
@@ -813,7 +819,7 @@ papplPrinterSetDNSSDName(
   if (!value)
     _papplPrinterUnregisterDNSSDNoLock(printer);
   else
-    _papplPrinterRegisterDNSSDNoLock(printer);
+    _papplPrinterQueueDNSSDNoLock(printer);
 
   pthread_rwlock_unlock(&printer->rwlock);
 
@@ -842,7 +848,7 @@ papplPrinterSetGeoLocation(
   printer->geo_location = value ? strdup(value) : NULL;
   printer->config_time  = time(NULL);
 
-  _papplPrinterRegisterDNSSDNoLock(printer);
+  _papplPrinterQueueDNSSDNoLock(printer);
 
   pthread_rwlock_unlock(&printer->rwlock);
 
@@ -898,7 +904,7 @@ papplPrinterSetLocation(
   printer->location    = value ? strdup(value) : NULL;
   printer->config_time = time(NULL);
 
-  _papplPrinterRegisterDNSSDNoLock(printer);
+  _papplPrinterQueueDNSSDNoLock(printer);
 
   pthread_rwlock_unlock(&printer->rwlock);
 
@@ -19,23 +19,100 @@
 // Local functions...
 //
 
+static ipp_t	*create_attrs(pappl_printer_t *printer);
 static ipp_t	*make_attrs(pappl_system_t *system, pappl_pr_driver_data_t *data);
 static bool	validate_defaults(pappl_printer_t *printer, pappl_pr_driver_data_t *data);
 static bool	validate_driver(pappl_printer_t *printer, pappl_pr_driver_data_t *data);
 static bool	validate_ready(pappl_printer_t *printer, int num_ready, pappl_media_col_t *ready);
 
 
+//
+// '_papplPrinterCopyDriverDefaultNoLock()' - Copy a vendor default to the driver attributes.
+//
+// This function copies the named "xxx-default" value from the application
+// driver attributes to the current driver attributes, if they have been
+// created.  The printer must be locked for writing.
+//
+
+void
+_papplPrinterCopyDriverDefaultNoLock(
+    pappl_printer_t *printer,		// I - Printer
+    const char      *defname)		// I - "xxx-default" attribute name
+{
+  ipp_attribute_t	*attr;		// Vendor default attribute
+
+
+  if (!printer->driver_attrs)
+    return;
+
+  ippDeleteAttribute(printer->driver_attrs, ippFindAttribute(printer->driver_attrs, defname, IPP_TAG_ZERO));
+
+  if ((attr = ippFindAttribute(printer->driver_extra, defname, IPP_TAG_ZERO)) != NULL)
+    ippCopyAttribute(printer->driver_attrs, attr, 0);
+}
+
+
 //
 // 'papplPrinterGetDriverAttributes()' - Get the current driver attributes.
 //
-// This function returns the current driver attributes.
+// This function returns the current driver attributes.  The attributes remain
+// valid until @link papplPrinterSetDriverData@ is called.  Changes made to the
+// attributes are reported to clients once the next Get-Printer-Attributes
+// request is processed, so call this function again before making further
+// changes.
 //
 
 ipp_t *					// O - Driver attributes
 papplPrinterGetDriverAttributes(
     pappl_printer_t *printer)		// I - Printer
 {
-  return (printer ? printer->driver_attrs : NULL);
+  ipp_t	*attrs;				// Driver attributes
+
+
+  if (!printer)
+    return (NULL);
+
+  // Don't lock the printer since this function is often called from driver
+  // callbacks.  The application may keep and change the returned attributes,
+  // so they are not freed when the printer is idle and the pre-encoded copy is
+  // discarded so that it is created again from the changed attributes...
+  pthread_mutex_lock(&printer->blob_mutex);
+
+  attrs                  = create_attrs(printer);
+  printer->driver_shared = true;
+
+  _papplBlobRelease(printer->driver_blob);
+  printer->driver_blob = NULL;
+
+  pthread_mutex_unlock(&printer->blob_mutex);
+
+  return (attrs);
+}
+
+
+//
+// '_papplPrinterGetDriverAttrsNoLock()' - Get the driver attributes, creating them as needed.
+//
+// The driver attributes are created from the driver data and application
+// driver attributes the first time they are used, and are freed by
+// @link _papplPrinterFlushAttributes@ once the printer is idle.  The printer
+// must be locked.
+//
+
+ipp_t *					// O - Driver attributes
+_papplPrinterGetDriverAttrsNoLock(
+    pappl_printer_t *printer)		// I - Printer
+{
+  ipp_t	*attrs;				// Driver attributes
+
+
+  pthread_mutex_lock(&printer->blob_mutex);
+
+  attrs = create_attrs(printer);
+
+  pthread_mutex_unlock(&printer->blob_mutex);
+
+  return (attrs);
 }
 
 
@@ -141,6 +218,9 @@ papplPrinterSetDriverData(
     pappl_pr_driver_data_t *data,	// I - Driver data
     ipp_t                  *attrs)	// I - Additional capability attributes or `NULL` for none
 {
+  ipp_t	*extra = NULL;			// Copy of additional attributes
+
+
   if (!printer || !data)
     return (false);
 
@@ -148,17 +228,29 @@ papplPrinterSetDriverData(
   if (!validate_defaults(printer, data) || !validate_driver(printer, data) || !validate_ready(printer, data->num_source, data->media_ready))
     return (false);
 
+  // Copy the additional attributes, they are added to the printer (capability)
+  // attributes that are created from the driver data when needed...
+  if (attrs)
+  {
+    if ((extra = ippNew()) == NULL)
+      return (false);
+
+    ippCopyAttributes(extra, attrs, 0, NULL, NULL);
+  }
+
   pthread_rwlock_wrlock(&printer->rwlock);
 
   // Copy driver data to printer
   memcpy(&printer->driver_data, data, sizeof(printer->driver_data));
 
-  // Create printer (capability) attributes based on driver data...
-  ippDelete(printer->driver_attrs);
-  printer->driver_attrs = make_attrs(printer->system, &printer->driver_data);
+  ippDelete(printer->driver_extra);
+  printer->driver_extra = extra;
 
-  if (attrs)
-    ippCopyAttributes(printer->driver_attrs, attrs, 0, NULL, NULL);
+  pthread_mutex_lock(&printer->blob_mutex);
+  printer->driver_shared = false;
+  pthread_mutex_unlock(&printer->blob_mutex);
+
+  _papplPrinterFlushAttributes(printer, 0);
 
   pthread_rwlock_unlock(&printer->rwlock);
 
@@ -218,6 +310,9 @@ papplPrinterSetDriverDefaults(
   printer->driver_data.identify_default       = data->identify_default;
 
   // Copy any vendor-specific xxx-default values...
+  if (!printer->driver_extra)
+    printer->driver_extra = ippNew();
+
   for (i = 0; i < data->num_vendor; i ++)
   {
     if ((value = cupsGetOption(data->vendor[i], num_vendor, vendor)) == NULL)
@@ -226,9 +321,9 @@ papplPrinterSetDriverDefaults(
     snprintf(defname, sizeof(defname), "%s-default", data->vendor[i]);
     snprintf(supname, sizeof(supname), "%s-supported", data->vendor[i]);
 
-    ippDeleteAttribute(printer->driver_attrs, ippFindAttribute(printer->driver_attrs, defname, IPP_TAG_ZERO));
+    ippDeleteAttribute(printer->driver_extra, ippFindAttribute(printer->driver_extra, defname, IPP_TAG_ZERO));
 
-    if ((supported = ippFindAttribute(printer->driver_attrs, supname, IPP_TAG_ZERO)) != NULL)
+    if ((supported = ippFindAttribute(printer->driver_extra, supname, IPP_TAG_ZERO)) != NULL)
     {
       switch (ippGetValueTag(supported))
       {
@@ -236,15 +331,15 @@ papplPrinterSetDriverDefaults(
         case IPP_TAG_RANGE :
             intvalue = (int)strtol(value, &end, 10);
             if (errno != ERANGE && !*end)
-              ippAddInteger(printer->driver_attrs, IPP_TAG_PRINTER, IPP_TAG_INTEGER, defname, intvalue);
+              ippAddInteger(printer->driver_extra, IPP_TAG_PRINTER, IPP_TAG_INTEGER, defname, intvalue);
             break;
 
         case IPP_TAG_BOOLEAN :
-            ippAddBoolean(printer->driver_attrs, IPP_TAG_PRINTER, defname, !strcmp(value, "true") || !strcmp(value, "on"));
+            ippAddBoolean(printer->driver_extra, IPP_TAG_PRINTER, defname, !strcmp(value, "true") || !strcmp(value, "on"));
             break;
 
 	case IPP_TAG_KEYWORD :
-	    ippAddString(printer->driver_attrs, IPP_TAG_PRINTER, IPP_TAG_KEYWORD, defname, NULL, value);
+	    ippAddString(printer->driver_extra, IPP_TAG_PRINTER, IPP_TAG_KEYWORD, defname, NULL, value);
 	    break;
 
         default :
@@ -255,10 +350,14 @@ papplPrinterSetDriverDefaults(
     else
     {
       // Default to simple text values...
-      ippAddString(printer->driver_attrs, IPP_TAG_PRINTER, IPP_TAG_TEXT, defname, NULL, value);
+      ippAddString(printer->driver_extra, IPP_TAG_PRINTER, IPP_TAG_TEXT, defname, NULL, value);
     }
+
+    _papplPrinterCopyDriverDefaultNoLock(printer, defname);
   }
 
+  _papplPrinterFlushAttributes(printer, 0);
+
   printer->config_time = time(NULL);
 
   pthread_rwlock_unlock(&printer->rwlock);
@@ -304,6 +403,29 @@ papplPrinterSetReadyMedia(
 }
 
 
+//
+// 'create_attrs()' - Create the driver attributes as needed.
+//
+// The printer's blob mutex must be held.
+//
+
+static ipp_t *				// O - Driver attributes
+create_attrs(pappl_printer_t *printer)	// I - Printer
+{
+  if (!printer->driver_attrs)
+  {
+    printer->driver_attrs = make_attrs(printer->system, &printer->driver_data);
+
+    if (printer->driver_extra)
+      ippCopyAttributes(printer->driver_attrs, printer->driver_extra, 0, NULL, NULL);
+  }
+
+  printer->blob_time = time(NULL);
+
+  return (printer->driver_attrs);
+}
+
+
 //
 // 'make_attrs()' - Make the capability attributes for the given driver data.
 //
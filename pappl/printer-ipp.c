@@ -56,7 +56,7 @@ void
 _papplPrinterCopyAttributes(
     pappl_client_t  *client,		// I - Client
     pappl_printer_t *printer,		// I - Printer
-    cups_array_t    *ra,		// I - Requested attributes
+    _pappl_ra_t     *ra,		// I - Requested attributes
     const char      *format)		// I - "document-format" value, if any
 {
   int		i,			// Looping var
@@ -66,13 +66,41 @@ _papplPrinterCopyAttributes(
   int		ivalues[100];		// Integer values
   pappl_pr_driver_data_t *data = &printer->driver_data;
 					// Driver data
+  ipp_t		*driver_attrs;		// Driver attributes
+  _pappl_blob_t	*attrs_blob,		// Pre-encoded static attributes
+		*driver_blob;		// Pre-encoded driver attributes
 
 
-  _papplCopyAttributes(client->response, printer->attrs, ra, IPP_TAG_ZERO, IPP_TAG_CUPS_CONST);
-  _papplCopyAttributes(client->response, printer->driver_attrs, ra, IPP_TAG_ZERO, IPP_TAG_CUPS_CONST);
+  // Pre-encode the static and driver attributes on first use.  The driver
+  // attributes are encoded again after papplPrinterGetDriverAttributes is
+  // called in case the application changed them...
+  driver_attrs = _papplPrinterGetDriverAttrsNoLock(printer);
+
+  pthread_mutex_lock(&printer->blob_mutex);
+
+  if (!printer->attrs_blob)
+    printer->attrs_blob = _papplBlobCreate(printer->attrs);
+  if (!printer->driver_blob)
+    printer->driver_blob = _papplBlobCreate(driver_attrs);
+
+  attrs_blob  = _papplBlobRetain(printer->attrs_blob);
+  driver_blob = _papplBlobRetain(printer->driver_blob);
+
+  printer->blob_time = time(NULL);
+
+  pthread_mutex_unlock(&printer->blob_mutex);
+
+  if (!_papplClientCopyBlob(client, attrs_blob, IPP_TAG_PRINTER, ra->array))
+    _papplCopyAttributes(client->response, printer->attrs, ra->array, IPP_TAG_ZERO, IPP_TAG_CUPS_CONST);
+  if (!_papplClientCopyBlob(client, driver_blob, IPP_TAG_PRINTER, ra->array))
+    _papplCopyAttributes(client->response, driver_attrs, ra->array, IPP_TAG_ZERO, IPP_TAG_CUPS_CONST);
+
+  _papplBlobRelease(attrs_blob);
+  _papplBlobRelease(driver_blob);
+
   _papplPrinterCopyState(client->response, printer, ra);
 
-  if (!ra || cupsArrayFind(ra, "copies-supported"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_COPIES_SUPPORTED))
   {
     // Filter copies-supported value based on the document format...
     // (no copy support for streaming raster formats)
@@ -82,7 +110,7 @@ _papplPrinterCopyAttributes(
       ippAddRange(client->response, IPP_TAG_PRINTER, "copies-supported", 1, 999);
   }
 
-  if (!ra || cupsArrayFind(ra, "identify-actions-default"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_IDENTIFY_ACTIONS_DEFAULT))
   {
     for (num_values = 0, bit = PAPPL_IDENTIFY_ACTIONS_DISPLAY; bit <= PAPPL_IDENTIFY_ACTIONS_SPEAK; bit *= 2)
     {
@@ -96,10 +124,10 @@ _papplPrinterCopyAttributes(
       ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "identify-actions-default", NULL, "none");
   }
 
-  if ((!ra || cupsArrayFind(ra, "label-mode-configured")) && data->mode_configured)
+  if ((_PAPPL_REQUESTED(ra, _PAPPL_ATTR_LABEL_MODE_CONFIGURED)) && data->mode_configured)
     ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "label-mode-configured", NULL, _papplLabelModeString(data->mode_configured));
 
-  if ((!ra || cupsArrayFind(ra, "label-tear-offset-configured")) && data->tear_offset_supported[1] > 0)
+  if ((_PAPPL_REQUESTED(ra, _PAPPL_ATTR_LABEL_TEAR_OFFSET_CONFIGURED)) && data->tear_offset_supported[1] > 0)
     ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "label-tear-offset-configured", data->tear_offset_configured);
 
   if (printer->num_supply > 0)
@@ -107,7 +135,7 @@ _papplPrinterCopyAttributes(
     pappl_supply_t *supply = printer->supply;
 					// Supply values...
 
-    if (!ra || cupsArrayFind(ra, "marker-colors"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MARKER_COLORS))
     {
       for (i = 0; i < printer->num_supply; i ++)
         svalues[i] = _papplMarkerColorString(supply[i].color);
@@ -115,7 +143,7 @@ _papplPrinterCopyAttributes(
       ippAddStrings(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_NAME), "marker-colors", printer->num_supply, NULL, svalues);
     }
 
-    if (!ra || cupsArrayFind(ra, "marker-high-levels"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MARKER_HIGH_LEVELS))
     {
       for (i = 0; i < printer->num_supply; i ++)
         ivalues[i] = supply[i].is_consumed ? 100 : 90;
@@ -123,7 +151,7 @@ _papplPrinterCopyAttributes(
       ippAddIntegers(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "marker-high-levels", printer->num_supply, ivalues);
     }
 
-    if (!ra || cupsArrayFind(ra, "marker-levels"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MARKER_LEVELS))
     {
       for (i = 0; i < printer->num_supply; i ++)
         ivalues[i] = supply[i].level;
@@ -131,7 +159,7 @@ _papplPrinterCopyAttributes(
       ippAddIntegers(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "marker-levels", printer->num_supply, ivalues);
     }
 
-    if (!ra || cupsArrayFind(ra, "marker-low-levels"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MARKER_LOW_LEVELS))
     {
       for (i = 0; i < printer->num_supply; i ++)
         ivalues[i] = supply[i].is_consumed ? 10 : 0;
@@ -139,7 +167,7 @@ _papplPrinterCopyAttributes(
       ippAddIntegers(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "marker-low-levels", printer->num_supply, ivalues);
     }
 
-    if (!ra || cupsArrayFind(ra, "marker-names"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MARKER_NAMES))
     {
       for (i = 0; i < printer->num_supply; i ++)
         svalues[i] = supply[i].description;
@@ -147,7 +175,7 @@ _papplPrinterCopyAttributes(
       ippAddStrings(client->response, IPP_TAG_PRINTER, IPP_TAG_NAME, "marker-names", printer->num_supply, NULL, svalues);
     }
 
-    if (!ra || cupsArrayFind(ra, "marker-types"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MARKER_TYPES))
     {
       for (i = 0; i < printer->num_supply; i ++)
         svalues[i] = _papplMarkerTypeString(supply[i].type);
@@ -156,7 +184,7 @@ _papplPrinterCopyAttributes(
     }
   }
 
-  if ((!ra || cupsArrayFind(ra, "media-col-default")) && data->media_default.size_name[0])
+  if ((_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MEDIA_COL_DEFAULT)) && data->media_default.size_name[0])
   {
     ipp_t *col = _papplMediaColExport(&printer->driver_data, &data->media_default, 0);
 					// Collection value
@@ -165,7 +193,7 @@ _papplPrinterCopyAttributes(
     ippDelete(col);
   }
 
-  if (!ra || cupsArrayFind(ra, "media-col-ready"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MEDIA_COL_READY))
   {
     int			j,		// Looping var
 			count;		// Number of values
@@ -219,10 +247,10 @@ _papplPrinterCopyAttributes(
     }
   }
 
-  if ((!ra || cupsArrayFind(ra, "media-default")) && data->media_default.size_name[0])
+  if ((_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MEDIA_DEFAULT)) && data->media_default.size_name[0])
     ippAddString(client->response, IPP_TAG_PRINTER, IPP_TAG_KEYWORD, "media-default", NULL, data->media_default.size_name);
 
-  if (!ra || cupsArrayFind(ra, "media-ready"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MEDIA_READY))
   {
     int			j,		// Looping vars
 			count;		// Number of values
@@ -246,13 +274,13 @@ _papplPrinterCopyAttributes(
     }
   }
 
-  if (!ra || cupsArrayFind(ra, "multiple-document-handling-default"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_MULTIPLE_DOCUMENT_HANDLING_DEFAULT))
     ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "multiple-document-handling-default", NULL, "separate-documents-collated-copies");
 
-  if (!ra || cupsArrayFind(ra, "orientation-requested-default"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_ORIENTATION_REQUESTED_DEFAULT))
     ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_ENUM, "orientation-requested-default", (int)data->orient_default);
 
-  if (!ra || cupsArrayFind(ra, "output-bin-default"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_OUTPUT_BIN_DEFAULT))
   {
     if (data->num_bin > 0)
       ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "output-bin-default", NULL, data->bin[data->bin_default]);
@@ -262,10 +290,10 @@ _papplPrinterCopyAttributes(
       ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "output-bin-default", NULL, "face-down");
   }
 
-  if ((!ra || cupsArrayFind(ra, "print-color-mode-default")) && data->color_default)
+  if ((_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINT_COLOR_MODE_DEFAULT)) && data->color_default)
     ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "print-color-mode-default", NULL, _papplColorModeString(data->color_default));
 
-  if (!ra || cupsArrayFind(ra, "print-content-optimize-default"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINT_CONTENT_OPTIMIZE_DEFAULT))
   {
     if (data->content_default)
       ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "print-content-optimize-default", NULL, _papplContentString(data->content_default));
@@ -273,7 +301,7 @@ _papplPrinterCopyAttributes(
       ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "print-content-optimize-default", NULL, "auto");
   }
 
-  if (!ra || cupsArrayFind(ra, "print-quality-default"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINT_QUALITY_DEFAULT))
   {
     if (data->quality_default)
       ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_ENUM, "print-quality-default", (int)data->quality_default);
@@ -281,7 +309,7 @@ _papplPrinterCopyAttributes(
       ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_ENUM, "print-quality-default", IPP_QUALITY_NORMAL);
   }
 
-  if (!ra || cupsArrayFind(ra, "print-scaling-default"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINT_SCALING_DEFAULT))
   {
     if (data->scaling_default)
       ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "print-scaling-default", NULL, _papplScalingString(data->scaling_default));
@@ -289,31 +317,31 @@ _papplPrinterCopyAttributes(
       ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "print-scaling-default", NULL, "auto");
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-config-change-date-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_CONFIG_CHANGE_DATE_TIME))
     ippAddDate(client->response, IPP_TAG_PRINTER, "printer-config-change-date-time", ippTimeToDate(printer->config_time));
 
-  if (!ra || cupsArrayFind(ra, "printer-config-change-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_CONFIG_CHANGE_TIME))
     ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "printer-config-change-time", (int)(printer->config_time - printer->start_time));
 
-  if (!ra || cupsArrayFind(ra, "printer-contact-col"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_CONTACT_COL))
   {
     ipp_t *col = _papplContactExport(&printer->contact);
     ippAddCollection(client->response, IPP_TAG_PRINTER, "printer-contact-col", col);
     ippDelete(col);
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-current-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_CURRENT_TIME))
     ippAddDate(client->response, IPP_TAG_PRINTER, "printer-current-time", ippTimeToDate(time(NULL)));
 
-  if ((!ra || cupsArrayFind(ra, "printer-darkness-configured")) && data->darkness_supported > 0)
+  if ((_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_DARKNESS_CONFIGURED)) && data->darkness_supported > 0)
     ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "printer-darkness-configured", data->darkness_configured);
 
   _papplSystemExportVersions(client->system, client->response, IPP_TAG_PRINTER, ra);
 
-  if (!ra || cupsArrayFind(ra, "printer-dns-sd-name"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_DNS_SD_NAME))
     ippAddString(client->response, IPP_TAG_PRINTER, IPP_TAG_NAME, "printer-dns-sd-name", NULL, printer->dns_sd_name ? printer->dns_sd_name : "");
 
-  if (!ra || cupsArrayFind(ra, "printer-geo-location"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_GEO_LOCATION))
   {
     if (printer->geo_location)
       ippAddString(client->response, IPP_TAG_PRINTER, IPP_TAG_URI, "printer-geo-location", NULL, printer->geo_location);
@@ -321,7 +349,7 @@ _papplPrinterCopyAttributes(
       ippAddOutOfBand(client->response, IPP_TAG_PRINTER, IPP_TAG_UNKNOWN, "printer-geo-location");
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-icons"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_ICONS))
   {
     char	uris[3][1024];		// Buffers for URIs
     const char	*values[3];		// Values for attribute
@@ -337,10 +365,10 @@ _papplPrinterCopyAttributes(
     ippAddStrings(client->response, IPP_TAG_PRINTER, IPP_TAG_URI, "printer-icons", 3, NULL, values);
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-impressions-completed"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_IMPRESSIONS_COMPLETED))
     ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "printer-impressions-completed", printer->impcompleted);
 
-  if (!ra || cupsArrayFind(ra, "printer-input-tray"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_INPUT_TRAY))
   {
     ipp_attribute_t	*attr = NULL;	// "printer-input-tray" attribute
     char		value[256];	// Value for current tray
@@ -370,13 +398,13 @@ _papplPrinterCopyAttributes(
     ippSetOctetString(client->response, &attr, ippGetCount(attr), value, (int)strlen(value));
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-is-accepting-jobs"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_IS_ACCEPTING_JOBS))
     ippAddBoolean(client->response, IPP_TAG_PRINTER, "printer-is-accepting-jobs", !printer->system->shutdown_time);
 
-  if (!ra || cupsArrayFind(ra, "printer-location"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_LOCATION))
     ippAddString(client->response, IPP_TAG_PRINTER, IPP_TAG_TEXT, "printer-location", NULL, printer->location ? printer->location : "");
 
-  if (!ra || cupsArrayFind(ra, "printer-more-info"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_MORE_INFO))
   {
     char	uri[1024];		// URI value
 
@@ -384,25 +412,25 @@ _papplPrinterCopyAttributes(
     ippAddString(client->response, IPP_TAG_PRINTER, IPP_TAG_URI, "printer-more-info", NULL, uri);
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-organization"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_ORGANIZATION))
     ippAddString(client->response, IPP_TAG_PRINTER, IPP_TAG_TEXT, "printer-organization", NULL, printer->organization ? printer->organization : "");
 
-  if (!ra || cupsArrayFind(ra, "printer-organizational-unit"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_ORGANIZATIONAL_UNIT))
     ippAddString(client->response, IPP_TAG_PRINTER, IPP_TAG_TEXT, "printer-organizational-unit", NULL, printer->org_unit ? printer->org_unit : "");
 
-  if (!ra || cupsArrayFind(ra, "printer-resolution-default"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_RESOLUTION_DEFAULT))
     ippAddResolution(client->response, IPP_TAG_PRINTER, "printer-resolution-default", IPP_RES_PER_INCH, data->x_default, data->y_default);
 
-  if (!ra || cupsArrayFind(ra, "printer-speed-default"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_SPEED_DEFAULT))
     ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "printer-speed-default", data->speed_default);
 
-  if (!ra || cupsArrayFind(ra, "printer-state-change-date-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_STATE_CHANGE_DATE_TIME))
     ippAddDate(client->response, IPP_TAG_PRINTER, "printer-state-change-date-time", ippTimeToDate(printer->state_time));
 
-  if (!ra || cupsArrayFind(ra, "printer-state-change-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_STATE_CHANGE_TIME))
     ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "printer-state-change-time", (int)(printer->state_time - printer->start_time));
 
-  if (!ra || cupsArrayFind(ra, "printer-strings-languages-supported"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_STRINGS_LANGUAGES_SUPPORTED))
   {
     _pappl_resource_t	*r;		// Current resource
 
@@ -415,10 +443,10 @@ _papplPrinterCopyAttributes(
     pthread_rwlock_unlock(&printer->system->rwlock);
 
     if (num_values > 0)
-      ippAddStrings(printer->attrs, IPP_TAG_PRINTER, IPP_TAG_LANGUAGE, "printer-strings-languages-supported", num_values, NULL, svalues);
+      ippAddStrings(client->response, IPP_TAG_PRINTER, IPP_TAG_LANGUAGE, "printer-strings-languages-supported", num_values, NULL, svalues);
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-strings-uri"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_STRINGS_URI))
   {
     const char	*lang = ippGetString(ippFindAttribute(client->request, "attributes-natural-language", IPP_TAG_LANGUAGE), 0, NULL);
 					// Language
@@ -446,7 +474,7 @@ _papplPrinterCopyAttributes(
     pappl_supply_t	 *supply = printer->supply;
 					// Supply values...
 
-    if (!ra || cupsArrayFind(ra, "printer-supply"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_SUPPLY))
     {
       char		value[256];	// "printer-supply" value
       ipp_attribute_t	*attr = NULL;	// "printer-supply" attribute
@@ -462,7 +490,7 @@ _papplPrinterCopyAttributes(
       }
     }
 
-    if (!ra || cupsArrayFind(ra, "printer-supply-description"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_SUPPLY_DESCRIPTION))
     {
       for (i = 0; i < printer->num_supply; i ++)
         svalues[i] = supply[i].description;
@@ -471,7 +499,7 @@ _papplPrinterCopyAttributes(
     }
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-supply-info-uri"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_SUPPLY_INFO_URI))
   {
     char	uri[1024];		// URI value
 
@@ -479,10 +507,10 @@ _papplPrinterCopyAttributes(
     ippAddString(client->response, IPP_TAG_PRINTER, IPP_TAG_URI, "printer-supply-info-uri", NULL, uri);
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-up-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_UP_TIME))
     ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "printer-up-time", (int)(time(NULL) - printer->start_time));
 
-  if (!ra || cupsArrayFind(ra, "printer-uri-supported"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_URI_SUPPORTED))
   {
     char	uris[2][1024];		// Buffers for URIs
     const char	*values[2];		// Values for attribute
@@ -507,13 +535,13 @@ _papplPrinterCopyAttributes(
       ippAddStrings(client->response, IPP_TAG_PRINTER, IPP_TAG_URI, "printer-uri-supported", num_values, NULL, values);
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-xri-supported"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_XRI_SUPPORTED))
     _papplPrinterCopyXRI(client, client->response, printer);
 
-  if (!ra || cupsArrayFind(ra, "queued-job-count"))
-    ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "queued-job-count", cupsArrayCount(printer->active_jobs));
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_QUEUED_JOB_COUNT))
+    ippAddInteger(client->response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "queued-job-count", printer->active_jobs.count);
 
-  if (!ra || cupsArrayFind(ra, "sides-default"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SIDES_DEFAULT))
   {
     if (data->sides_default)
       ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "sides-default", NULL, _papplSidesString(data->sides_default));
@@ -521,7 +549,7 @@ _papplPrinterCopyAttributes(
       ippAddString(client->response, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_KEYWORD), "sides-default", NULL, "one-sided");
   }
 
-  if (!ra || cupsArrayFind(ra, "uri-authentication-supported"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_URI_AUTHENTICATION_SUPPORTED))
   {
     // For each supported printer-uri value, report whether authentication is
     // supported.  Since we only support authentication over a secure (TLS)
@@ -570,19 +598,19 @@ void
 _papplPrinterCopyState(
     ipp_t            *ipp,		// I - IPP message
     pappl_printer_t *printer,		// I - Printer
-    cups_array_t     *ra)		// I - Requested attributes
+    _pappl_ra_t      *ra)		// I - Requested attributes or `NULL` for all
 {
-  if (!ra || cupsArrayFind(ra, "printer-state"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_STATE))
     ippAddInteger(ipp, IPP_TAG_PRINTER, IPP_TAG_ENUM, "printer-state", (int)printer->state);
 
-  if (!ra || cupsArrayFind(ra, "printer-state-message"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_STATE_MESSAGE))
   {
     static const char * const messages[] = { "Idle.", "Printing.", "Stopped." };
 
     ippAddString(ipp, IPP_TAG_PRINTER, IPP_CONST_TAG(IPP_TAG_TEXT), "printer-state-message", NULL, messages[printer->state - IPP_PSTATE_IDLE]);
   }
 
-  if (!ra || cupsArrayFind(ra, "printer-state-reasons"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_PRINTER_STATE_REASONS))
   {
     if (printer->state_reasons == PAPPL_PREASON_NONE)
     {
@@ -677,7 +705,13 @@ void
 _papplPrinterProcessIPP(
     pappl_client_t *client)		// I - Client
 {
-  switch (ippGetOperation(client->request))
+  ipp_op_t	op = ippGetOperation(client->request);
+					// IPP operation
+
+
+  _PAPPL_TRACE(PAPPL_TRACE_IPP_OPERATION, printer__operation, ippOpString(op), client->number, (size_t)op);
+
+  switch (op)
   {
     case IPP_OP_PRINT_JOB :
 	ipp_print_job(client);
@@ -954,12 +988,19 @@ _papplPrinterSetAttributes(
     else
     {
       // Vendor xxx-default attribute, copy it...
-      ippDeleteAttribute(printer->driver_attrs, ippFindAttribute(printer->driver_attrs, name, IPP_TAG_ZERO));
+      if (!printer->driver_extra)
+        printer->driver_extra = ippNew();
 
-      ippCopyAttribute(printer->driver_attrs, rattr, 0);
+      ippDeleteAttribute(printer->driver_extra, ippFindAttribute(printer->driver_extra, name, IPP_TAG_ZERO));
+
+      ippCopyAttribute(printer->driver_extra, rattr, 0);
+
+      _papplPrinterCopyDriverDefaultNoLock(printer, name);
     }
   }
 
+  _papplPrinterFlushAttributes(printer, 0);
+
   printer->config_time = time(NULL);
 
   pthread_rwlock_unlock(&printer->rwlock);
@@ -1077,7 +1118,15 @@ static void
 ipp_create_job(pappl_client_t *client)	// I - Client
 {
   pappl_job_t		*job;		// New job
-  cups_array_t		*ra;		// Attributes to send in response
+  _pappl_ra_t		ra;		// Attributes to send in response
+  static const char * const names[] =
+  {					// Attributes for the new job
+    "job-id",
+    "job-state",
+    "job-state-message",
+    "job-state-reasons",
+    "job-uri"
+  };
 
 
   // Do we have a file to print?
@@ -1102,15 +1151,9 @@ ipp_create_job(pappl_client_t *client)	// I - Client
   // Return the job info...
   papplClientRespondIPP(client, IPP_STATUS_OK, NULL);
 
-  ra = cupsArrayNew((cups_array_func_t)strcmp, NULL);
-  cupsArrayAdd(ra, "job-id");
-  cupsArrayAdd(ra, "job-state");
-  cupsArrayAdd(ra, "job-state-message");
-  cupsArrayAdd(ra, "job-state-reasons");
-  cupsArrayAdd(ra, "job-uri");
-
-  _papplJobCopyAttributes(client, job, ra);
-  cupsArrayDelete(ra);
+  _papplRequestedCreateNames(&ra, sizeof(names) / sizeof(names[0]), names);
+  _papplJobCopyAttributes(client, job, &ra);
+  _papplRequestedDelete(&ra);
 }
 
 
@@ -1121,18 +1164,29 @@ ipp_create_job(pappl_client_t *client)	// I - Client
 static void
 ipp_get_jobs(pappl_client_t *client)	// I - Client
 {
+  pappl_printer_t	*printer = client->printer;
+					// Printer
   ipp_attribute_t	*attr;		// Current attribute
   const char		*which_jobs = NULL;
 					// which-jobs values
   int			job_comparison;	// Job comparison
   ipp_jstate_t		job_state;	// job-state value
   int			i,		// Looping var
+			first_index,	// First job to return (1-based)
 			limit,		// Maximum number of jobs to return
-			count;		// Number of jobs that match
+			count,		// Number of jobs in list
+			num_jobs;	// Number of jobs to return
   const char		*username;	// Username
-  cups_array_t		*list;		// Jobs list
-  pappl_job_t		*job;		// Current job pointer
-  cups_array_t		*ra;		// Requested attributes array
+  _pappl_job_list_t	*jlist;		// List of jobs
+  bool			all = false;	// List all jobs?
+  pappl_job_t		*job,		// Current job pointer
+			**jobs;		// Snapshot of jobs to return
+  _pappl_ra_t		ra;		// Requested attributes
+  static const char * const job_defaults[] =
+  {					// Default attributes
+    "job-id",
+    "job-uri"
+  };
 
 
   // See if the "which-jobs" attribute have been specified...
@@ -1146,19 +1200,20 @@ ipp_get_jobs(pappl_client_t *client)	// I - Client
   {
     job_comparison = -1;
     job_state      = IPP_JSTATE_STOPPED;
-    list           = client->printer->active_jobs;
+    jlist          = &printer->active_jobs;
   }
   else if (!strcmp(which_jobs, "completed"))
   {
     job_comparison = 1;
     job_state      = IPP_JSTATE_CANCELED;
-    list           = client->printer->completed_jobs;
+    jlist          = &printer->completed_jobs;
   }
   else if (!strcmp(which_jobs, "all"))
   {
     job_comparison = 1;
     job_state      = IPP_JSTATE_PENDING;
-    list           = client->printer->all_jobs;
+    jlist          = &printer->all_jobs;
+    all            = true;
   }
   else
   {
@@ -1177,6 +1232,23 @@ ipp_get_jobs(pappl_client_t *client)	// I - Client
   else
     limit = 0;
 
+  // See if they want to start past the first job...
+  if ((attr = ippFindAttribute(client->request, "first-index", IPP_TAG_INTEGER)) != NULL)
+  {
+    first_index = ippGetInteger(attr, 0);
+
+    papplLogClient(client, PAPPL_LOGLEVEL_DEBUG, "Get-Jobs \"first-index\"='%d'", first_index);
+
+    if (first_index < 1)
+    {
+      papplClientRespondIPP(client, IPP_STATUS_ERROR_ATTRIBUTES_OR_VALUES, "The \"first-index\" value %d is not supported.", first_index);
+      ippAddInteger(client->response, IPP_TAG_UNSUPPORTED_GROUP, IPP_TAG_INTEGER, "first-index", first_index);
+      return;
+    }
+  }
+  else
+    first_index = 1;
+
   // See if we only want to see jobs for a specific user...
   username = NULL;
 
@@ -1200,35 +1272,84 @@ ipp_get_jobs(pappl_client_t *client)	// I - Client
     }
   }
 
-  // OK, build a list of jobs for this printer...
-  ra = ippCreateRequestedArray(client->request);
+  // OK, take a snapshot of the matching jobs for this printer.  The user index
+  // holds all of the user's jobs so we only look at those when "my-jobs" is
+  // true.  Each job is retained so that we can copy the attributes after
+  // releasing the printer lock...
+  pthread_rwlock_rdlock(&printer->rwlock);
 
-  papplClientRespondIPP(client, IPP_STATUS_OK, NULL);
+  if (username)
+  {
+    // Use the per-user index...
+    jlist = _papplPrinterFindUserJobs(printer, username);
+  }
 
-  pthread_rwlock_rdlock(&(client->printer->rwlock));
+  if (jlist)
+  {
+    count = jlist->count;
+    job   = jlist->first;
+  }
+  else
+  {
+    count = 0;
+    job   = NULL;
+  }
 
-  count = cupsArrayCount(list);
   if (limit <= 0 || limit > count)
     limit = count;
 
-  for (count = 0, i = 0; i < limit; i ++)
+  if (limit > 0)
   {
-    job = (pappl_job_t *)cupsArrayIndex(list, i);
+    if ((jobs = calloc((size_t)limit, sizeof(pappl_job_t *))) == NULL)
+    {
+      pthread_rwlock_unlock(&printer->rwlock);
+      papplClientRespondIPP(client, IPP_STATUS_ERROR_INTERNAL, "Unable to allocate memory.");
+      return;
+    }
+  }
+  else
+    jobs = NULL;
 
+  for (num_jobs = 0; job && num_jobs < limit; job = username ? job->user_next : all ? job->all_next : job->next)
+  {
     // Filter out jobs that don't match...
-    if ((job_comparison < 0 && job->state > job_state) || /* (job_comparison == 0 && job->state != job_state) || */ (job_comparison > 0 && job->state < job_state) || (username && job->username && strcasecmp(username, job->username)))
+    if ((job_comparison < 0 && job->state > job_state) || (job_comparison > 0 && job->state < job_state))
       continue;
 
-    if (count > 0)
+    if (first_index > 1)
+    {
+      first_index --;
+      continue;
+    }
+
+    jobs[num_jobs ++] = _papplJobRetain(job);
+  }
+
+  pthread_rwlock_unlock(&printer->rwlock);
+
+  // Copy the job attributes to the response, defaulting to "job-id" and
+  // "job-uri"...
+  _papplRequestedCreate(&ra, client->request, sizeof(job_defaults) / sizeof(job_defaults[0]), job_defaults);
+
+  papplClientRespondIPP(client, IPP_STATUS_OK, NULL);
+
+  for (i = 0; i < num_jobs; i ++)
+  {
+    job = jobs[i];
+
+    if (i > 0)
       ippAddSeparator(client->response);
 
-    count ++;
-    _papplJobCopyAttributes(client, job, ra);
+    pthread_rwlock_rdlock(&job->rwlock);
+    _papplJobCopyAttributes(client, job, &ra);
+    pthread_rwlock_unlock(&job->rwlock);
+
+    _papplJobRelease(job);
   }
 
-  cupsArrayDelete(ra);
+  _papplRequestedDelete(&ra);
 
-  pthread_rwlock_unlock(&(client->printer->rwlock));
+  free(jobs);
 }
 
 
@@ -1240,7 +1361,7 @@ static void
 ipp_get_printer_attributes(
     pappl_client_t *client)		// I - Client
 {
-  cups_array_t		*ra;		// Requested attributes array
+  _pappl_ra_t		ra;		// Requested attributes
   pappl_printer_t	*printer = client->printer;
 					// Printer
 
@@ -1253,17 +1374,17 @@ ipp_get_printer_attributes(
   }
 
   // Send the attributes...
-  ra = ippCreateRequestedArray(client->request);
+  _papplRequestedCreate(&ra, client->request, 0, NULL);
 
   papplClientRespondIPP(client, IPP_STATUS_OK, NULL);
 
   pthread_rwlock_rdlock(&(printer->rwlock));
 
-  _papplPrinterCopyAttributes(client, printer, ra, ippGetString(ippFindAttribute(client->request, "document-format", IPP_TAG_MIMETYPE), 0, NULL));
+  _papplPrinterCopyAttributes(client, printer, &ra, ippGetString(ippFindAttribute(client->request, "document-format", IPP_TAG_MIMETYPE), 0, NULL));
 
   pthread_rwlock_unlock(&(printer->rwlock));
 
-  cupsArrayDelete(ra);
+  _papplRequestedDelete(&ra);
 }
 
 
@@ -1532,7 +1653,7 @@ valid_job_attributes(
     }
     else
     {
-      supported = ippFindAttribute(client->printer->driver_attrs, "media-supported", IPP_TAG_KEYWORD);
+      supported = ippFindAttribute(_papplPrinterGetDriverAttrsNoLock(client->printer), "media-supported", IPP_TAG_KEYWORD);
 
       if (!ippContainsString(supported, ippGetString(attr, 0, NULL)))
       {
@@ -1569,7 +1690,7 @@ valid_job_attributes(
       }
       else
       {
-	supported = ippFindAttribute(client->printer->driver_attrs, "media-supported", IPP_TAG_KEYWORD);
+	supported = ippFindAttribute(_papplPrinterGetDriverAttrsNoLock(client->printer), "media-supported", IPP_TAG_KEYWORD);
 
 	if (!ippContainsString(supported, ippGetString(member, 0, NULL)))
 	{
@@ -1598,7 +1719,7 @@ valid_job_attributes(
 	{
 	  x_value   = ippGetInteger(x_dim, 0);
 	  y_value   = ippGetInteger(y_dim, 0);
-	  supported = ippFindAttribute(client->printer->driver_attrs, "media-size-supported", IPP_TAG_BEGIN_COLLECTION);
+	  supported = ippFindAttribute(_papplPrinterGetDriverAttrsNoLock(client->printer), "media-size-supported", IPP_TAG_BEGIN_COLLECTION);
 	  count     = ippGetCount(supported);
 
 	  for (i = 0; i < count ; i ++)
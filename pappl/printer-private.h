@@ -40,12 +40,26 @@
 
 #  include "base-private.h"
 #  include "device.h"
+#  include "job-private.h"
+
+
+//
+// Constants...
+//
+
+#  define _PAPPL_PRINTER_IDLE_TIME	300	// Seconds before unused driver and pre-encoded attributes are freed
 
 
 //
 // Types and structures...
 //
 
+typedef struct _pappl_user_jobs_s	// Jobs for a user
+{
+  char			*username;		// Username
+  _pappl_job_list_t	jobs;			// Jobs, newest first
+} _pappl_user_jobs_t;
+
 struct _pappl_printer_s			// Printer data
 {
   pthread_rwlock_t	rwlock;			// Reader/writer lock
@@ -72,8 +86,14 @@ struct _pappl_printer_s			// Printer data
   bool			device_in_use;		// Is the device in use?
   char			*driver_name;		// Driver name
   pappl_pr_driver_data_t driver_data;	// Driver data
-  ipp_t			*driver_attrs;		// Driver attributes
+  ipp_t			*driver_attrs;		// Driver attributes, created as needed
+  ipp_t			*driver_extra;		// Application driver attributes and vendor defaults
   ipp_t			*attrs;			// Other (static) printer attributes
+  _pappl_blob_t		*attrs_blob,		// Pre-encoded static printer attributes
+			*driver_blob;		// Pre-encoded driver attributes
+  bool			driver_shared;		// Driver attributes given to the app (not freed)?
+  pthread_mutex_t	blob_mutex;		// Mutex for driver and pre-encoded attributes
+  time_t		blob_time;		// Last use of driver and pre-encoded attributes
   time_t		start_time;		// Startup time
   time_t		config_time;		// "printer-config-change-time" value
   time_t		status_time;		// Last time status was updated
@@ -85,9 +105,12 @@ struct _pappl_printer_s			// Printer data
   pappl_job_t		*processing_job;	// Currently printing job, if any
   int			max_active_jobs,	// Maximum number of active jobs to accept
 			max_completed_jobs;	// Maximum number of completed jobs to retain in history
-  cups_array_t		*active_jobs,		// Array of active jobs
-			*all_jobs,		// Array of all jobs
-			*completed_jobs;	// Array of completed jobs
+  _pappl_job_list_t	active_jobs,		// List of active jobs
+			completed_jobs,		// List of completed jobs
+			all_jobs;		// List of all jobs
+  cups_array_t		*user_jobs;		// Array of jobs by user
+  pappl_job_t		**job_hash;		// Hash table of jobs by "job-id"
+  size_t		job_hash_size;		// Size of hash table (power of 2)
   int			next_job_id,		// Next "job-id" value
 			impcompleted;		// "printer-impressions-completed" value
   cups_array_t		*links;			// Web navigation links
@@ -105,6 +128,8 @@ struct _pappl_printer_s			// Printer data
   unsigned char		dns_sd_loc[16];		// DNS-SD LOC record data
   bool			dns_sd_collision;	// Was there a name collision?
   int			dns_sd_serial;		// DNS-SD serial number (for collisions)
+  bool			dns_sd_pending;		// Are DNS-SD updates queued?
+  unsigned		dns_sd_hash;		// Hash of registered DNS-SD services
   int			num_listeners;		// Number of raw socket listeners
   struct pollfd		listeners[2];		// Raw socket listeners
   unsigned short	usb_vendor_id,		// USB vendor ID
@@ -123,15 +148,24 @@ extern void		*_papplPrinterRunRaw(pappl_printer_t *printer) _PAPPL_PRIVATE;
 
 extern void		*_papplPrinterRunUSB(pappl_printer_t *printer) _PAPPL_PRIVATE;
 
+extern void		_papplPrinterAddJob(pappl_printer_t *printer, pappl_job_t *job) _PAPPL_PRIVATE;
 extern void		_papplPrinterCheckJobs(pappl_printer_t *printer) _PAPPL_PRIVATE;
 extern void		_papplPrinterCleanJobs(pappl_printer_t *printer) _PAPPL_PRIVATE;
-extern void		_papplPrinterCopyAttributes(pappl_client_t *client, pappl_printer_t *printer, cups_array_t *ra, const char *format) _PAPPL_PRIVATE;
-extern void		_papplPrinterCopyState(ipp_t *ipp, pappl_printer_t *printer, cups_array_t *ra) _PAPPL_PRIVATE;
+extern void		_papplPrinterCompleteJob(pappl_printer_t *printer, pappl_job_t *job) _PAPPL_PRIVATE;
+extern void		_papplPrinterCopyAttributes(pappl_client_t *client, pappl_printer_t *printer, _pappl_ra_t *ra, const char *format) _PAPPL_PRIVATE;
+extern void		_papplPrinterCopyDriverDefaultNoLock(pappl_printer_t *printer, const char *defname) _PAPPL_PRIVATE;
+extern void		_papplPrinterCopyState(ipp_t *ipp, pappl_printer_t *printer, _pappl_ra_t *ra) _PAPPL_PRIVATE;
 extern void		_papplPrinterCopyXRI(pappl_client_t *client, ipp_t *ipp, pappl_printer_t *printer) _PAPPL_PRIVATE;
 extern void		_papplPrinterDelete(pappl_printer_t *printer) _PAPPL_PRIVATE;
+extern pappl_job_t	*_papplPrinterFindJobNoLock(pappl_printer_t *printer, int job_id) _PAPPL_PRIVATE;
+extern _pappl_job_list_t *_papplPrinterFindUserJobs(pappl_printer_t *printer, const char *username) _PAPPL_PRIVATE;
+extern void		_papplPrinterFlushAttributes(pappl_printer_t *printer, time_t idle_time) _PAPPL_PRIVATE;
+extern ipp_t		*_papplPrinterGetDriverAttrsNoLock(pappl_printer_t *printer) _PAPPL_PRIVATE;
 extern void		_papplPrinterInitDriverData(pappl_pr_driver_data_t *d) _PAPPL_PRIVATE;
 extern void		_papplPrinterProcessIPP(pappl_client_t *client) _PAPPL_PRIVATE;
+extern void		_papplPrinterQueueDNSSDNoLock(pappl_printer_t *printer) _PAPPL_PRIVATE;
 extern bool		_papplPrinterRegisterDNSSDNoLock(pappl_printer_t *printer) _PAPPL_PRIVATE;
+extern void		_papplPrinterRemoveJob(pappl_printer_t *printer, pappl_job_t *job) _PAPPL_PRIVATE;
 extern bool		_papplPrinterSetAttributes(pappl_client_t *client, pappl_printer_t *printer) _PAPPL_PRIVATE;
 extern void		_papplPrinterUnregisterDNSSDNoLock(pappl_printer_t *printer) _PAPPL_PRIVATE;
 
@@ -144,6 +178,7 @@ extern void		_papplPrinterWebDelete(pappl_client_t *client, pappl_printer_t *pri
 extern void		_papplPrinterWebHome(pappl_client_t *client, pappl_printer_t *printer) _PAPPL_PRIVATE;
 extern void		_papplPrinterWebIteratorCallback(pappl_printer_t *printer, pappl_client_t *client) _PAPPL_PRIVATE;
 extern void		_papplPrinterWebJobs(pappl_client_t *client, pappl_printer_t *printer) _PAPPL_PRIVATE;
+extern void		_papplPrinterWebJobsJSON(pappl_client_t *client, pappl_printer_t *printer) _PAPPL_PRIVATE;
 extern void		_papplPrinterWebMedia(pappl_client_t *client, pappl_printer_t *printer) _PAPPL_PRIVATE;
 extern void		_papplPrinterWebSupplies(pappl_client_t *client, pappl_printer_t *printer) _PAPPL_PRIVATE;
 
@@ -88,7 +88,7 @@ _papplPrinterRunRaw(
   while (printer->listeners[0].fd >= 0)
   {
     // Don't accept connections if we can't accept a new job...
-    while (cupsArrayCount(printer->active_jobs) >= printer->max_active_jobs && printer->listeners[0].fd >= 0)
+    while (printer->active_jobs.count >= printer->max_active_jobs && printer->listeners[0].fd >= 0)
       sleep(1);
 
     if (printer->listeners[0].fd < 0)
@@ -187,8 +187,7 @@ _papplPrinterRunRaw(
 
 	  pthread_rwlock_wrlock(&printer->rwlock);
 
-	  cupsArrayRemove(printer->active_jobs, job);
-	  cupsArrayAdd(printer->completed_jobs, job);
+	  _papplPrinterCompleteJob(printer, job);
 
 	  if (!printer->system->clean_time)
 	    printer->system->clean_time = time(NULL) + 60;
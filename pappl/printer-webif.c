@@ -15,16 +15,38 @@
 #include "pappl-private.h"
 
 
+//
+// Local types...
+//
+
+typedef struct _pappl_jsnap_s		// Job list snapshot entry
+{
+  int		job_id;			// "job-id" value
+  ipp_jstate_t	state;			// "job-state" value
+  bool		is_canceled;		// Has this job been canceled?
+  char		name[256],		// "job-name" value
+		username[256];		// "job-originating-user-name" value
+  int		impcompleted;		// "job-impressions-completed" value
+  time_t	created,		// "time-at-creation" value
+		processing,		// "time-at-processing" value
+		completed;		// "time-at-completed" value
+  double	wait_msecs,		// Time waiting to print
+		print_msecs;		// Time spent printing
+} _pappl_jsnap_t;
+
+
 //
 // Local functions...
 //
 
-static void	job_cb(pappl_job_t *job, pappl_client_t *client);
+static _pappl_jsnap_t *copy_jobs(pappl_printer_t *printer, bool active, int job_index, int before, int limit, int *num_jobs, int *total);
+static void	job_row(pappl_client_t *client, pappl_printer_t *printer, _pappl_jsnap_t *job);
+static void	json_string(http_t *http, const char *s);
 static char	*localize_keyword(const char *attrname, const char *keyword, char *buffer, size_t bufsize);
 static char	*localize_media(pappl_media_col_t *media, bool include_source, char *buffer, size_t bufsize);
 static void	media_chooser(pappl_client_t *client, pappl_pr_driver_data_t *driver_data, const char *title, const char *name, pappl_media_col_t *media);
 static char	*time_string(time_t tv, char *buffer, size_t bufsize);
-static void	job_pager(pappl_client_t *client, pappl_printer_t *printer, int job_index, int limit);
+static void	job_pager(pappl_client_t *client, pappl_printer_t *printer, int num_jobs, int job_index, int limit);
 
 
 //
@@ -37,6 +59,10 @@ _papplPrinterWebCancelAllJobs(
     pappl_printer_t *printer)		// I - Printer
 {
   const char	*status = NULL;		// Status message, if any
+  _pappl_jsnap_t *jobs;			// Active jobs
+  int		i,			// Looping var
+		num_jobs,		// Number of active jobs
+		total;			// Total number of jobs
 
 
   if (!papplClientHTMLAuthorize(client))
@@ -77,7 +103,9 @@ _papplPrinterWebCancelAllJobs(
   papplClientHTMLStartForm(client, client->uri, false);
   papplClientHTMLPuts(client, "           <input type=\"submit\" value=\"Confirm Cancel All\"></form>");
 
-  if (papplPrinterGetNumberOfActiveJobs(printer) > 0)
+  jobs = copy_jobs(printer, true, 1, 0, 0, &num_jobs, &total);
+
+  if (num_jobs > 0)
   {
     papplClientHTMLPuts(client,
 			"          <table class=\"list\" summary=\"Jobs\">\n"
@@ -86,7 +114,8 @@ _papplPrinterWebCancelAllJobs(
 			"            </thead>\n"
 			"            <tbody>\n");
 
-    papplPrinterIterateActiveJobs(printer, (pappl_job_cb_t)job_cb, client, 1, 0);
+    for (i = 0; i < num_jobs; i ++)
+      job_row(client, printer, jobs + i);
 
     papplClientHTMLPuts(client,
 			"            </tbody>\n"
@@ -95,6 +124,8 @@ _papplPrinterWebCancelAllJobs(
   else
     papplClientHTMLPuts(client, "        <p>No jobs in history.</p>\n");
 
+  free(jobs);
+
   papplClientHTMLFooter(client);
 }
 
@@ -333,6 +364,7 @@ _papplPrinterWebDefaults(
 {
   int			i, j;		// Looping vars
   pappl_pr_driver_data_t data;		// Driver data
+  ipp_t			*driver_attrs;	// Driver attributes
   const char		*keyword;	// Current keyword
   char			text[256];	// Localized text for keyword
   const char		*status = NULL;	// Status message, if any
@@ -450,6 +482,8 @@ _papplPrinterWebDefaults(
 	}
       }
 
+      pthread_rwlock_rdlock(&printer->rwlock);
+
       for (i = 0; i < data.num_vendor; i ++)
       {
         char	supattr[128];		// xxx-supported
@@ -458,10 +492,12 @@ _papplPrinterWebDefaults(
 
         if ((value = cupsGetOption(data.vendor[i], num_form, form)) != NULL)
 	  num_vendor = cupsAddOption(data.vendor[i], value, num_vendor, &vendor);
-	else if (ippFindAttribute(printer->driver_attrs, supattr, IPP_TAG_BOOLEAN))
+	else if (ippFindAttribute(_papplPrinterGetDriverAttrsNoLock(printer), supattr, IPP_TAG_BOOLEAN))
 	  num_vendor = cupsAddOption(data.vendor[i], "false", num_vendor, &vendor);
       }
 
+      pthread_rwlock_unlock(&printer->rwlock);
+
       papplPrinterSetDriverDefaults(printer, &data, num_vendor, vendor);
 
       cupsFreeOptions(num_vendor, vendor);
@@ -650,6 +686,8 @@ _papplPrinterWebDefaults(
   // Vendor options
   pthread_rwlock_rdlock(&printer->rwlock);
 
+  driver_attrs = _papplPrinterGetDriverAttrsNoLock(printer);
+
   for (i = 0; i < data.num_vendor; i ++)
   {
     char	defname[128],		// xxx-default name
@@ -661,12 +699,12 @@ _papplPrinterWebDefaults(
     snprintf(defname, sizeof(defname), "%s-default", data.vendor[i]);
     snprintf(supname, sizeof(defname), "%s-supported", data.vendor[i]);
 
-    if ((attr = ippFindAttribute(printer->driver_attrs, defname, IPP_TAG_ZERO)) != NULL)
+    if ((attr = ippFindAttribute(driver_attrs, defname, IPP_TAG_ZERO)) != NULL)
       ippAttributeString(attr, defvalue, sizeof(defvalue));
     else
       defvalue[0] = '\0';
 
-    if ((attr = ippFindAttribute(printer->driver_attrs, supname, IPP_TAG_ZERO)) != NULL)
+    if ((attr = ippFindAttribute(driver_attrs, supname, IPP_TAG_ZERO)) != NULL)
     {
       count = ippGetCount(attr);
 
@@ -805,6 +843,10 @@ _papplPrinterWebHome(
   char		edit_path[1024];	// Edit configuration URL
   const int	limit = 20;		// Jobs per page
   int		job_index = 1;		// Job index
+  _pappl_jsnap_t *jobs;			// Job snapshot
+  int		i,			// Looping var
+		num_jobs,		// Number of jobs in snapshot
+		total;			// Total number of jobs
 
 
   // Save current printer state...
@@ -919,16 +961,18 @@ _papplPrinterWebHome(
 			"        <div class=\"col-6\">\n"
 			"          <h1 class=\"title\"><a href=\"%s/jobs\">Jobs</a>", printer->uriname);
 
-  if (papplPrinterGetNumberOfJobs(printer) > 0)
+  jobs = copy_jobs(printer, false, job_index, 0, limit, &num_jobs, &total);
+
+  if (total > 0)
   {
-    if (cupsArrayCount(printer->active_jobs) > 0)
+    if (printer->active_jobs.count > 0)
       papplClientHTMLPrintf(client, " <a class=\"btn\" href=\"https://%s:%d%s/cancelall\">Cancel All Jobs</a></h1>\n", client->host_field, client->host_port, printer->uriname);
     else
       papplClientHTMLPuts(client, "</h1>\n");
 
     _papplClientHTMLPutLinks(client, printer->links, PAPPL_LOPTIONS_JOB);
 
-    job_pager(client, printer, job_index, limit);
+    job_pager(client, printer, total, job_index, limit);
 
     papplClientHTMLPuts(client,
 			"          <table class=\"list\" summary=\"Jobs\">\n"
@@ -937,13 +981,14 @@ _papplPrinterWebHome(
 			"            </thead>\n"
 			"            <tbody>\n");
 
-    papplPrinterIterateAllJobs(printer, (pappl_job_cb_t)job_cb, client, job_index, limit);
+    for (i = 0; i < num_jobs; i ++)
+      job_row(client, printer, jobs + i);
 
     papplClientHTMLPuts(client,
 			"            </tbody>\n"
 			"          </table>\n");
 
-    job_pager(client, printer, job_index, limit);
+    job_pager(client, printer, total, job_index, limit);
   }
   else
   {
@@ -952,6 +997,8 @@ _papplPrinterWebHome(
     papplClientHTMLPuts(client, "        <p>No jobs in history.</p>\n");
   }
 
+  free(jobs);
+
   papplClientHTMLPrinterFooter(client);
 }
 
@@ -1057,6 +1104,10 @@ _papplPrinterWebJobs(
   ipp_pstate_t	printer_state;		// Printer state
   int		job_index = 1,		// Job index
 		limit = 20;		// Jobs per page
+  _pappl_jsnap_t *jobs;			// Job snapshot
+  int		i,			// Looping var
+		num_jobs,		// Number of jobs in snapshot
+		total;			// Total number of jobs
 
 
   if (!papplClientHTMLAuthorize(client))
@@ -1077,7 +1128,7 @@ _papplPrinterWebJobs(
     cupsFreeOptions(num_form, form);
   }
 
-  if (cupsArrayCount(printer->active_jobs) > 0)
+  if (printer->active_jobs.count > 0)
   {
     char	url[1024];		// URL for Cancel All Jobs
 
@@ -1090,9 +1141,11 @@ _papplPrinterWebJobs(
     papplClientHTMLPrinterHeader(client, printer, "Jobs", printer_state == IPP_PSTATE_PROCESSING ? 10 : 0, NULL, NULL);
   }
 
-  if (papplPrinterGetNumberOfJobs(printer) > 0)
+  jobs = copy_jobs(printer, false, job_index, 0, limit, &num_jobs, &total);
+
+  if (total > 0)
   {
-    job_pager(client, printer, job_index, limit);
+    job_pager(client, printer, total, job_index, limit);
 
     papplClientHTMLPuts(client,
 			"          <table class=\"list\" summary=\"Jobs\">\n"
@@ -1101,21 +1154,114 @@ _papplPrinterWebJobs(
 			"            </thead>\n"
 			"            <tbody>\n");
 
-    papplPrinterIterateAllJobs(printer, (pappl_job_cb_t)job_cb, client, job_index, limit);
+    for (i = 0; i < num_jobs; i ++)
+      job_row(client, printer, jobs + i);
 
     papplClientHTMLPuts(client,
 			"            </tbody>\n"
 			"          </table>\n");
 
-    job_pager(client, printer, job_index, limit);
+    job_pager(client, printer, total, job_index, limit);
   }
   else
     papplClientHTMLPuts(client, "        <p>No jobs in history.</p>\n");
 
+  free(jobs);
+
   papplClientHTMLPrinterFooter(client);
 }
 
 
+//
+// '_papplPrinterWebJobsJSON()' - Return a page of the job history as JSON.
+//
+// The "cursor" form variable specifies the job ID returned in "next-cursor" by
+// the previous request, and "limit" specifies the maximum number of jobs to
+// return (default 100, maximum 1000).  Because the cursor is a job ID rather
+// than an index, new jobs do not shift the following pages.
+//
+
+void
+_papplPrinterWebJobsJSON(
+    pappl_client_t  *client,		// I - Client
+    pappl_printer_t *printer)		// I - Printer
+{
+  int		cursor = 0,		// Job ID cursor
+		limit = 100;		// Jobs per page
+  _pappl_jsnap_t *jobs,			// Job snapshot
+		*job;			// Current job
+  int		i,			// Looping var
+		num_jobs,		// Number of jobs in snapshot
+		total;			// Total number of jobs
+  const char	*state;			// Job state keyword
+
+
+  if (!papplClientHTMLAuthorize(client))
+    return;
+
+  if (client->operation != HTTP_STATE_GET)
+  {
+    papplClientRespond(client, HTTP_STATUS_BAD_REQUEST, NULL, NULL, 0, 0);
+    return;
+  }
+  else
+  {
+    cups_option_t	*form = NULL;	// Form variables
+    int			num_form = papplClientGetForm(client, &form);
+					// Number of form variables
+    const char		*value = NULL;	// Value of form variable
+
+    if ((value = cupsGetOption("cursor", num_form, form)) != NULL)
+      cursor = (int)strtol(value, NULL, 10);
+
+    if ((value = cupsGetOption("limit", num_form, form)) != NULL)
+      limit = (int)strtol(value, NULL, 10);
+
+    cupsFreeOptions(num_form, form);
+  }
+
+  if (limit < 1)
+    limit = 1;
+  else if (limit > 1000)
+    limit = 1000;
+
+  // Copy the jobs so the printer is not locked while writing to the client...
+  jobs = copy_jobs(printer, false, 1, cursor, limit, &num_jobs, &total);
+
+  if (!papplClientRespond(client, HTTP_STATUS_OK, NULL, "application/json", 0, 0))
+  {
+    free(jobs);
+    return;
+  }
+
+  httpPrintf(client->http, "{\"printer\":");
+  json_string(client->http, printer->name);
+  httpPrintf(client->http, ",\"total\":%d,\"jobs\":[", total);
+
+  for (i = 0, job = jobs; i < num_jobs; i ++, job ++)
+  {
+    if ((state = ippEnumString("job-state", (int)job->state)) == NULL)
+      state = "unknown";
+
+    httpPrintf(client->http, "%s{\"job-id\":%d,\"job-name\":", i ? "," : "", job->job_id);
+    json_string(client->http, job->name);
+    httpPrintf(client->http, ",\"job-originating-user-name\":");
+    json_string(client->http, job->username);
+    httpPrintf(client->http, ",\"job-state\":\"%s\",\"job-canceled\":%s,\"job-impressions-completed\":%d,\"time-at-creation\":%ld,\"time-at-processing\":%ld,\"time-at-completed\":%ld,\"wait-msecs\":%.0f,\"print-msecs\":%.0f}", state, job->is_canceled ? "true" : "false", job->impcompleted, (long)job->created, (long)job->processing, (long)job->completed, job->wait_msecs, job->print_msecs);
+  }
+
+  // Only provide a cursor when there may be more jobs...
+  if (num_jobs == limit)
+    httpPrintf(client->http, "],\"next-cursor\":%d}\n", jobs[num_jobs - 1].job_id);
+  else
+    httpPrintf(client->http, "],\"next-cursor\":null}\n");
+
+  httpWrite2(client->http, "", 0);
+
+  free(jobs);
+}
+
+
 //
 // '_papplPrinterWebMedia()' - Show the printer media web page.
 //
@@ -1333,103 +1479,251 @@ _papplPrinterWebSupplies(
 
 
 //
-// 'job_cb()' - Job iterator callback.
+// 'copy_jobs()' - Copy a snapshot of the jobs for display.
+//
+// The printer is locked only while the job values are copied, so that slow
+// clients do not block job processing while the list is written.  When
+// "before" is non-zero, the snapshot starts with the newest job whose ID is
+// less than "before", otherwise it starts at the 1-based "job_index".  A
+// "limit" of `0` copies all of the remaining jobs.
+//
+
+static _pappl_jsnap_t *			// O - Job snapshot or `NULL` if none
+copy_jobs(pappl_printer_t *printer,	// I - Printer
+          bool            active,	// I - Only copy active jobs?
+          int             job_index,	// I - First job to copy (1-based)
+          int             before,	// I - Copy jobs with lower IDs than this or `0`
+          int             limit,	// I - Maximum number of jobs or `0` for no limit
+          int             *num_jobs,	// O - Number of jobs copied
+          int             *total)	// O - Total number of jobs
+{
+  _pappl_jsnap_t	*jobs = NULL,	// Job snapshot
+			*snap;		// Current snapshot entry
+  pappl_job_t		*job;		// Current job
+  pappl_jmetrics_t	metrics;	// Job timing metrics
+  int			count;		// Number of jobs available
+
+
+  *num_jobs = 0;
+
+  if (job_index < 1)
+    job_index = 1;
+
+  pthread_rwlock_rdlock(&printer->rwlock);
+
+  if (active)
+  {
+    *total = printer->active_jobs.count;
+
+    for (job = printer->active_jobs.first; job && job_index > 1; job = job->next, job_index --);
+
+    count = printer->active_jobs.count;
+  }
+  else
+  {
+    *total = printer->all_jobs.count;
+
+    if (before > 0)
+    {
+      // The job history is sorted newest first, so start after the cursor job
+      // or, if it is gone, at the first job older than the cursor...
+      if ((job = _papplPrinterFindJobNoLock(printer, before)) != NULL)
+        job = job->all_next;
+      else
+        for (job = printer->all_jobs.first; job && job->job_id >= before; job = job->all_next);
+    }
+    else
+      for (job = printer->all_jobs.first; job && job_index > 1; job = job->all_next, job_index --);
+
+    count = *total;
+  }
+
+  if (limit > 0 && count > limit)
+    count = limit;
+
+  if (count > 0 && (jobs = (_pappl_jsnap_t *)calloc((size_t)count, sizeof(_pappl_jsnap_t))) != NULL)
+  {
+    for (snap = jobs; job && *num_jobs < count; snap ++, (*num_jobs) ++)
+    {
+      pthread_rwlock_rdlock(&job->rwlock);
+
+      snap->job_id       = job->job_id;
+      snap->state        = job->state;
+      snap->is_canceled  = job->is_canceled;
+      snap->impcompleted = job->impcompleted;
+      snap->created      = job->created;
+      snap->processing   = job->processing;
+      snap->completed    = job->completed;
+
+      strlcpy(snap->name, job->name ? job->name : "", sizeof(snap->name));
+      strlcpy(snap->username, job->username ? job->username : "", sizeof(snap->username));
+
+      _papplJobGetMetricsNoLock(job, &metrics);
+
+      if (metrics.process_msecs > 0.0)
+      {
+        snap->wait_msecs  = metrics.wait_msecs;
+        snap->print_msecs = metrics.device_msecs + metrics.process_msecs + metrics.finish_msecs;
+      }
+
+      pthread_rwlock_unlock(&job->rwlock);
+
+      if (active)
+        job = job->next;
+      else
+        job = job->all_next;
+    }
+  }
+
+  pthread_rwlock_unlock(&printer->rwlock);
+
+  return (jobs);
+}
+
+
+//
+// 'job_pager()' - Show the job paging links.
+//
+
+static void
+job_pager(pappl_client_t  *client,	// I - Client
+	  pappl_printer_t *printer,	// I - Printer
+	  int             num_jobs,	// I - Number of jobs
+	  int             job_index,	// I - First job shown (1-based)
+	  int             limit)	// I - Maximum jobs shown
+{
+  int	num_pages = 0,			// Number of pages
+	i,				// Looping var
+	page = 0;			// Current page
+  char	path[1024];			// resource path
+
+
+  if (num_jobs <= limit)
+    return;
+
+  num_pages = (num_jobs + limit - 1) / limit;
+  page      = (job_index - 1) / limit;
+
+  snprintf(path, sizeof(path), "%s/jobs", printer->uriname);
+
+  papplClientHTMLPuts(client, "          <div class=\"pager\">");
+
+  if (page > 0)
+    papplClientHTMLPrintf(client, "<a class=\"btn\" href=\"%s?job-index=%d\">&laquo;</a>", path, (page - 1) * limit + 1);
+
+  for (i = 0; i < num_pages; i ++)
+  {
+    if (i == page)
+      papplClientHTMLPrintf(client, " %d", i + 1);
+    else
+      papplClientHTMLPrintf(client, " <a class=\"btn\" href=\"%s?job-index=%d\">%d</a>", path, i * limit + 1, i + 1);
+  }
+
+  if (page < (num_pages - 1))
+    papplClientHTMLPrintf(client, " <a class=\"btn\" href=\"%s?job-index=%d\">&raquo;</a>", path, (page + 1) * limit + 1);
+
+  papplClientHTMLPuts(client, "</div>\n");
+}
+
+
+//
+// 'job_row()' - Show a job in the job list.
 //
 
 static void
-job_cb(pappl_job_t    *job,		// I - Job
-       pappl_client_t *client)		// I - Client
+job_row(pappl_client_t  *client,	// I - Client
+        pappl_printer_t *printer,	// I - Printer
+        _pappl_jsnap_t  *job)		// I - Job snapshot
 {
   bool	show_cancel = false;		// Show the "cancel" button?
   char	when[256],			// When job queued/started/finished
       	hhmmss[64];			// Time HH:MM:SS
 
 
-  switch (papplJobGetState(job))
+  switch (job->state)
   {
     case IPP_JSTATE_PENDING :
     case IPP_JSTATE_HELD :
 	show_cancel = true;
-	snprintf(when, sizeof(when), "Queued at %s", time_string(papplJobGetTimeCreated(job), hhmmss, sizeof(hhmmss)));
+	snprintf(when, sizeof(when), "Queued at %s", time_string(job->created, hhmmss, sizeof(hhmmss)));
 	break;
 
     case IPP_JSTATE_PROCESSING :
     case IPP_JSTATE_STOPPED :
-	if (papplJobIsCanceled(job))
+	if (job->is_canceled)
 	{
 	  strlcpy(when, "Canceling", sizeof(when));
 	}
 	else
 	{
 	  show_cancel = true;
-	  snprintf(when, sizeof(when), "Started at %s", time_string(papplJobGetTimeProcessed(job), hhmmss, sizeof(hhmmss)));
+	  snprintf(when, sizeof(when), "Started at %s", time_string(job->processing, hhmmss, sizeof(hhmmss)));
 	}
 	break;
 
     case IPP_JSTATE_ABORTED :
-	snprintf(when, sizeof(when), "Aborted at %s", time_string(papplJobGetTimeCompleted(job), hhmmss, sizeof(hhmmss)));
+	snprintf(when, sizeof(when), "Aborted at %s", time_string(job->completed, hhmmss, sizeof(hhmmss)));
 	break;
 
     case IPP_JSTATE_CANCELED :
-	snprintf(when, sizeof(when), "Canceled at %s", time_string(papplJobGetTimeCompleted(job), hhmmss, sizeof(hhmmss)));
+	snprintf(when, sizeof(when), "Canceled at %s", time_string(job->completed, hhmmss, sizeof(hhmmss)));
 	break;
 
     case IPP_JSTATE_COMPLETED :
-	snprintf(when, sizeof(when), "Completed at %s", time_string(papplJobGetTimeCompleted(job), hhmmss, sizeof(hhmmss)));
+	snprintf(when, sizeof(when), "Completed at %s", time_string(job->completed, hhmmss, sizeof(hhmmss)));
 	break;
   }
 
-  papplClientHTMLPrintf(client, "              <tr><td>%d</td><td>%s</td><td>%s</td><td>%d</td><td>%s</td>", papplJobGetID(job), papplJobGetName(job), papplJobGetUsername(job), papplJobGetImpressionsCompleted(job), when);
+  // Show where the time went for jobs that have been processed...
+  if (job->print_msecs > 0.0)
+  {
+    size_t whenlen = strlen(when);	// Length of "when" string
+
+    snprintf(when + whenlen, sizeof(when) - whenlen, " (waited %.1fs, printing %.1fs)", 0.001 * job->wait_msecs, 0.001 * job->print_msecs);
+  }
+
+  papplClientHTMLPrintf(client, "              <tr><td>%d</td><td>%s</td><td>%s</td><td>%d</td><td>%s</td>", job->job_id, job->name, job->username, job->impcompleted, when);
 
   if (show_cancel)
-    papplClientHTMLPrintf(client, "          <td><a class=\"btn\" href=\"%s/cancel?job-id=%d\">Cancel Job</a></td></tr>\n", job->printer->uriname, papplJobGetID(job));
+    papplClientHTMLPrintf(client, "          <td><a class=\"btn\" href=\"%s/cancel?job-id=%d\">Cancel Job</a></td></tr>\n", printer->uriname, job->job_id);
   else
     papplClientHTMLPuts(client, "<td></td></tr>\n");
 }
 
 
 //
-// 'job_pager()' - Show the job paging links.
+// 'json_string()' - Write a JSON string value.
 //
 
 static void
-job_pager(pappl_client_t  *client,	// I - Client
-	  pappl_printer_t *printer,	// I - Printer
-	  int             job_index,	// I - First job shown (1-based)
-	  int             limit)	// I - Maximum jobs shown
+json_string(http_t     *http,		// I - HTTP connection
+            const char *s)		// I - String
 {
-  int	num_jobs = 0,			// Number of jobs
-	num_pages = 0,			// Number of pages
-	i,				// Looping var
-	page = 0;			// Current page
-  char	path[1024];			// resource path
-
-
-  if ((num_jobs = papplPrinterGetNumberOfJobs(printer)) <= limit)
-    return;
+  const char	*start;			// Start of current fragment
 
-  num_pages = (num_jobs + limit - 1) / limit;
-  page      = (job_index - 1) / limit;
 
-  snprintf(path, sizeof(path), "%s/jobs", printer->uriname);
+  httpWrite2(http, "\"", 1);
 
-  papplClientHTMLPuts(client, "          <div class=\"pager\">");
+  for (start = s; *s; s ++)
+  {
+    if (*s == '"' || *s == '\\' || (*s & 255) < ' ')
+    {
+      if (s > start)
+        httpWrite2(http, start, (size_t)(s - start));
 
-  if (page > 0)
-    papplClientHTMLPrintf(client, "<a class=\"btn\" href=\"%s?job-index=%d\">&laquo;</a>", path, (page - 1) * limit + 1);
+      if (*s == '"' || *s == '\\')
+        httpPrintf(http, "\\%c", *s);
+      else
+        httpPrintf(http, "\\u%04x", *s & 255);
 
-  for (i = 0; i < num_pages; i ++)
-  {
-    if (i == page)
-      papplClientHTMLPrintf(client, " %d", i + 1);
-    else
-      papplClientHTMLPrintf(client, " <a class=\"btn\" href=\"%s?job-index=%d\">%d</a>", path, i * limit + 1, i + 1);
+      start = s + 1;
+    }
   }
 
-  if (page < (num_pages - 1))
-    papplClientHTMLPrintf(client, " <a class=\"btn\" href=\"%s?job-index=%d\">&raquo;</a>", path, (page + 1) * limit + 1);
+  if (s > start)
+    httpWrite2(http, start, (size_t)(s - start));
 
-  papplClientHTMLPuts(client, "</div>\n");
+  httpWrite2(http, "\"", 1);
 }
 
 
@@ -19,9 +19,62 @@
 // Local functions...
 //
 
-static int	compare_active_jobs(pappl_job_t *a, pappl_job_t *b);
-static int	compare_all_jobs(pappl_job_t *a, pappl_job_t *b);
-static int	compare_completed_jobs(pappl_job_t *a, pappl_job_t *b);
+static void	add_user_job(pappl_printer_t *printer, pappl_job_t *job);
+static int	compare_user_jobs(_pappl_user_jobs_t *a, _pappl_user_jobs_t *b);
+static void	free_user_jobs(_pappl_user_jobs_t *ujobs);
+static void	link_job(_pappl_job_list_t *list, pappl_job_t *job, bool user);
+static void	remove_user_job(pappl_printer_t *printer, pappl_job_t *job);
+static void	unlink_job(_pappl_job_list_t *list, pappl_job_t *job, bool user);
+
+
+//
+// '_papplPrinterAddJob()' - Add a job to the printer's job indexes.
+//
+// The job is added to the list of all jobs, the "job-id" hash table, and the
+// per-user index.  The caller adds the job to the active or completed list.
+// The printer write lock must be held by the caller.
+//
+
+void
+_papplPrinterAddJob(
+    pappl_printer_t *printer,		// I - Printer
+    pappl_job_t     *job)		// I - Job
+{
+  size_t	bucket,			// Hash bucket
+		hash_size = printer->job_hash_size ? 2 * printer->job_hash_size : 64;
+					// New size of hash table
+  pappl_job_t	**hash,			// New hash table
+		*current;		// Current job
+
+
+  link_job(&printer->all_jobs, job, false);
+
+  // Grow the hash table as needed to keep the chains short.  The new table is
+  // built from the list of all jobs so that it is complete even if an earlier
+  // allocation failed...
+  if ((size_t)printer->all_jobs.count > printer->job_hash_size && (hash = calloc(hash_size, sizeof(pappl_job_t *))) != NULL)
+  {
+    for (current = printer->all_jobs.first; current; current = current->all_next)
+    {
+      bucket             = (size_t)current->job_id & (hash_size - 1);
+      current->hash_next = hash[bucket];
+      hash[bucket]       = current;
+    }
+
+    free(printer->job_hash);
+
+    printer->job_hash      = hash;
+    printer->job_hash_size = hash_size;
+  }
+  else if (printer->job_hash)
+  {
+    bucket                    = (size_t)job->job_id & (printer->job_hash_size - 1);
+    job->hash_next            = printer->job_hash[bucket];
+    printer->job_hash[bucket] = job;
+  }
+
+  add_user_job(printer, job);
+}
 
 
 //
@@ -36,14 +89,17 @@ void
 papplPrinterCancelAllJobs(
     pappl_printer_t *printer)		// I - Printer
 {
-  pappl_job_t	*job;			// Job information
+  pappl_job_t	*job,			// Job information
+		*next;			// Next job
 
 
   // Loop through all jobs and cancel them...
   pthread_rwlock_wrlock(&printer->rwlock);
 
-  for (job = (pappl_job_t *)cupsArrayFirst(printer->active_jobs); job; job = (pappl_job_t *)cupsArrayNext(printer->active_jobs))
+  for (job = printer->active_jobs.first; job; job = next)
   {
+    next = job->next;
+
     // Cancel this job...
     if (job->state == IPP_JSTATE_PROCESSING || (job->state == IPP_JSTATE_HELD && job->fd >= 0))
     {
@@ -56,8 +112,7 @@ papplPrinterCancelAllJobs(
 
       _papplJobRemoveFile(job);
 
-      cupsArrayRemove(printer->active_jobs, job);
-      cupsArrayAdd(printer->completed_jobs, job);
+      _papplPrinterCompleteJob(printer, job);
     }
   }
 
@@ -68,6 +123,22 @@ papplPrinterCancelAllJobs(
 }
 
 
+//
+// '_papplPrinterCompleteJob()' - Move a job from the active to completed list.
+//
+// The printer write lock must be held by the caller.
+//
+
+void
+_papplPrinterCompleteJob(
+    pappl_printer_t *printer,		// I - Printer
+    pappl_job_t     *job)		// I - Job
+{
+  _papplJobListRemove(&printer->active_jobs, job);
+  _papplJobListAdd(&printer->completed_jobs, job);
+}
+
+
 //
 // 'papplPrinterCreate()' - Create a new printer.
 //
@@ -254,6 +325,7 @@ papplPrinterCreate(
 
   // Initialize printer structure and attributes...
   pthread_rwlock_init(&printer->rwlock, NULL);
+  pthread_mutex_init(&printer->blob_mutex, NULL);
 
   printer->system             = system;
   printer->name               = strdup(printer_name);
@@ -270,9 +342,7 @@ papplPrinterCreate(
   printer->state              = IPP_PSTATE_IDLE;
   printer->state_reasons      = PAPPL_PREASON_NONE;
   printer->state_time         = printer->start_time;
-  printer->all_jobs           = cupsArrayNew3((cups_array_func_t)compare_all_jobs, NULL, NULL, 0, NULL, (cups_afree_func_t)_papplJobDelete);
-  printer->active_jobs        = cupsArrayNew((cups_array_func_t)compare_active_jobs, NULL);
-  printer->completed_jobs     = cupsArrayNew((cups_array_func_t)compare_completed_jobs, NULL);
+  printer->user_jobs          = cupsArrayNew3((cups_array_func_t)compare_user_jobs, NULL, NULL, 0, NULL, (cups_afree_func_t)free_user_jobs);
   printer->next_job_id        = 1;
   printer->max_active_jobs    = (system->options & PAPPL_SOPTIONS_MULTI_QUEUE) ? 0 : 1;
   printer->max_completed_jobs = 100;
@@ -333,7 +403,7 @@ papplPrinterCreate(
     else
       mdl = mfg;			// No separator, so assume the make and model are the same
 
-    formats = ippFindAttribute(printer->driver_attrs, "document-format-supported", IPP_TAG_MIMETYPE);
+    formats = ippFindAttribute(_papplPrinterGetDriverAttrsNoLock(printer), "document-format-supported", IPP_TAG_MIMETYPE);
     count   = ippGetCount(formats);
     for (i = 0, ptr = cmd; i < count; i ++)
     {
@@ -584,6 +654,9 @@ papplPrinterCreate(
     snprintf(path, sizeof(path), "%s/jobs", printer->uriname);
     papplSystemAddResourceCallback(system, path, "text/html", (pappl_resource_cb_t)_papplPrinterWebJobs, printer);
 
+    snprintf(path, sizeof(path), "%s/jobs.json", printer->uriname);
+    papplSystemAddResourceCallback(system, path, "application/json", (pappl_resource_cb_t)_papplPrinterWebJobsJSON, printer);
+
     snprintf(path, sizeof(path), "%s/media", printer->uriname);
     papplSystemAddResourceCallback(system, path, "text/html", (pappl_resource_cb_t)_papplPrinterWebMedia, printer);
     papplPrinterAddLink(printer, "Media", path, PAPPL_LOPTIONS_NAVIGATION | PAPPL_LOPTIONS_STATUS);
@@ -615,6 +688,10 @@ void
 _papplPrinterDelete(
     pappl_printer_t *printer)		// I - Printer
 {
+  pappl_job_t	*job,			// Current job
+		*next;			// Next job
+
+
   // Remove DNS-SD registrations...
   _papplPrinterUnregisterDNSSDNoLock(printer);
 
@@ -623,9 +700,15 @@ _papplPrinterDelete(
     (printer->driver_data.delete_cb)(printer, &printer->driver_data);
 
   // Delete jobs...
-  cupsArrayDelete(printer->active_jobs);
-  cupsArrayDelete(printer->completed_jobs);
-  cupsArrayDelete(printer->all_jobs);
+  cupsArrayDelete(printer->user_jobs);
+
+  for (job = printer->all_jobs.first; job; job = next)
+  {
+    next = job->all_next;
+    _papplJobDelete(job);
+  }
+
+  free(printer->job_hash);
 
   // Free memory...
   free(printer->name);
@@ -641,8 +724,13 @@ _papplPrinterDelete(
   free(printer->usb_storage);
 
   ippDelete(printer->driver_attrs);
+  ippDelete(printer->driver_extra);
   ippDelete(printer->attrs);
 
+  _papplBlobRelease(printer->driver_blob);
+  _papplBlobRelease(printer->attrs_blob);
+  pthread_mutex_destroy(&printer->blob_mutex);
+
   cupsArrayDelete(printer->links);
 
   free(printer);
@@ -672,37 +760,334 @@ papplPrinterDelete(
 }
 
 
+
+//
+// '_papplPrinterFindJobNoLock()' - Find a job without locking the printer.
 //
-// 'compare_active_jobs()' - Compare two active jobs.
+// The "job-id" hash table is used when available, otherwise the list of all
+// jobs is searched.  The printer lock must be held by the caller.
 //
 
-static int				// O - Result of comparison
-compare_active_jobs(pappl_job_t *a,	// I - First job
-                    pappl_job_t *b)	// I - Second job
+pappl_job_t *				// O - Job or `NULL` if not found
+_papplPrinterFindJobNoLock(
+    pappl_printer_t *printer,		// I - Printer
+    int             job_id)		// I - Job ID
 {
-  return (b->job_id - a->job_id);
+  pappl_job_t	*job;			// Matching job, if any
+
+
+  if (printer->job_hash)
+  {
+    for (job = printer->job_hash[(size_t)job_id & (printer->job_hash_size - 1)]; job; job = job->hash_next)
+    {
+      if (job->job_id == job_id)
+        break;
+    }
+  }
+  else
+  {
+    // No hash table (allocation failed), do a linear search...
+    for (job = printer->all_jobs.first; job; job = job->all_next)
+    {
+      if (job->job_id == job_id)
+        break;
+    }
+  }
+
+  return (job);
 }
 
 
 //
-// 'compare_jobs()' - Compare two jobs.
+// '_papplPrinterFindUserJobs()' - Find the jobs submitted by a user.
+//
+// The printer lock must be held by the caller.
 //
 
-static int				// O - Result of comparison
-compare_all_jobs(pappl_job_t *a,	// I - First job
-                 pappl_job_t *b)	// I - Second job
+_pappl_job_list_t *			// O - Jobs, newest first, or `NULL` if none
+_papplPrinterFindUserJobs(
+    pappl_printer_t *printer,		// I - Printer
+    const char      *username)		// I - Username
+{
+  _pappl_user_jobs_t	key,		// Search key
+			*ujobs;		// Jobs for user
+
+
+  key.username = (char *)username;
+
+  if ((ujobs = (_pappl_user_jobs_t *)cupsArrayFind(printer->user_jobs, &key)) != NULL)
+    return (&ujobs->jobs);
+  else
+    return (NULL);
+}
+
+
+//
+// '_papplPrinterFlushAttributes()' - Free the driver and pre-encoded printer attributes.
+//
+// The attributes are created again the next time they are needed.  If
+// "idle_time" is non-zero, the attributes are only freed when they have not
+// been used since that time.  Driver attributes that have been given to the
+// application are not freed.  The printer must be locked for writing.
+//
+
+void
+_papplPrinterFlushAttributes(
+    pappl_printer_t *printer,		// I - Printer
+    time_t          idle_time)		// I - Idle time or `0` to always free
+{
+  pthread_mutex_lock(&printer->blob_mutex);
+
+  if (!idle_time || printer->blob_time < idle_time)
+  {
+    _papplBlobRelease(printer->attrs_blob);
+    _papplBlobRelease(printer->driver_blob);
+
+    printer->attrs_blob  = NULL;
+    printer->driver_blob = NULL;
+
+    if (!printer->driver_shared)
+    {
+      ippDelete(printer->driver_attrs);
+      printer->driver_attrs = NULL;
+    }
+  }
+
+  pthread_mutex_unlock(&printer->blob_mutex);
+}
+
+
+//
+// '_papplPrinterRemoveJob()' - Remove a completed job from the printer.
+//
+// The job is removed from the completed list and all of the job indexes, and
+// its reference from the history is released.  The printer write lock must
+// be held by the caller.
+//
+
+void
+_papplPrinterRemoveJob(
+    pappl_printer_t *printer,		// I - Printer
+    pappl_job_t     *job)		// I - Job
+{
+  pappl_job_t	**ptr;			// Pointer into hash chain
+
+
+  _papplJobListRemove(&printer->completed_jobs, job);
+
+  if (printer->job_hash)
+  {
+    for (ptr = printer->job_hash + ((size_t)job->job_id & (printer->job_hash_size - 1)); *ptr; ptr = &(*ptr)->hash_next)
+    {
+      if (*ptr == job)
+      {
+        *ptr = job->hash_next;
+        break;
+      }
+    }
+  }
+
+  remove_user_job(printer, job);
+
+  unlink_job(&printer->all_jobs, job, false);
+
+  // Release the history's reference to the job...
+  _papplJobDelete(job);
+}
+
+
+//
+// 'add_user_job()' - Add a job to the per-user job index.
+//
+// The printer write lock must be held by the caller.
+//
+
+static void
+add_user_job(pappl_printer_t *printer,	// I - Printer
+             pappl_job_t     *job)	// I - Job
 {
-  return (b->job_id - a->job_id);
+  _pappl_user_jobs_t	key,		// Search key
+			*ujobs;		// Jobs for user
+
+
+  if (!job->username)
+    return;
+
+  key.username = (char *)job->username;
+
+  if ((ujobs = (_pappl_user_jobs_t *)cupsArrayFind(printer->user_jobs, &key)) == NULL)
+  {
+    if ((ujobs = calloc(1, sizeof(_pappl_user_jobs_t))) == NULL)
+      return;
+
+    if ((ujobs->username = strdup(job->username)) == NULL)
+    {
+      free_user_jobs(ujobs);
+      return;
+    }
+
+    cupsArrayAdd(printer->user_jobs, ujobs);
+  }
+
+  link_job(&ujobs->jobs, job, true);
 }
 
 
 //
-// 'compare_completed_jobs()' - Compare two completed jobs.
+// 'compare_user_jobs()' - Compare the jobs for two users.
 //
 
 static int				// O - Result of comparison
-compare_completed_jobs(pappl_job_t *a,	// I - First job
-                       pappl_job_t *b)	// I - Second job
+compare_user_jobs(
+    _pappl_user_jobs_t *a,		// I - First user
+    _pappl_user_jobs_t *b)		// I - Second user
+{
+  return (strcmp(a->username, b->username));
+}
+
+
+//
+// 'free_user_jobs()' - Free the jobs for a user.
+//
+
+static void
+free_user_jobs(
+    _pappl_user_jobs_t *ujobs)		// I - Jobs for user
 {
-  return (b->job_id - a->job_id);
+  free(ujobs->username);
+  free(ujobs);
+}
+
+
+//
+// 'link_job()' - Add a job to the list of all jobs or a user's jobs.
+//
+// These lists are sorted newest first by "job-id".  New jobs have the highest
+// "job-id" and are added to the front of the list, and jobs loaded from the
+// state file are found starting from the end, so both cases take constant
+// time.
+//
+
+static void
+link_job(_pappl_job_list_t *list,	// I - List of jobs
+         pappl_job_t       *job,	// I - Job
+         bool              user)	// I - `true` for a user's jobs, `false` for all jobs
+{
+  pappl_job_t	*current,		// Job before new job, if any
+		*next;			// Job after new job, if any
+
+
+  if (!list->first || job->job_id > list->first->job_id)
+  {
+    current = NULL;
+    next    = list->first;
+  }
+  else
+  {
+    for (current = list->last; current && current->job_id < job->job_id; current = user ? current->user_prev : current->all_prev);
+
+    next = user ? current->user_next : current->all_next;
+  }
+
+  if (user)
+  {
+    job->user_prev = current;
+    job->user_next = next;
+
+    if (current)
+      current->user_next = job;
+    if (next)
+      next->user_prev = job;
+  }
+  else
+  {
+    job->all_prev = current;
+    job->all_next = next;
+
+    if (current)
+      current->all_next = job;
+    if (next)
+      next->all_prev = job;
+  }
+
+  if (!current)
+    list->first = job;
+  if (!next)
+    list->last = job;
+
+  list->count ++;
+}
+
+
+//
+// 'remove_user_job()' - Remove a job from the per-user job index.
+//
+// The printer write lock must be held by the caller.
+//
+
+static void
+remove_user_job(
+    pappl_printer_t *printer,		// I - Printer
+    pappl_job_t     *job)		// I - Job
+{
+  _pappl_user_jobs_t	key,		// Search key
+			*ujobs;		// Jobs for user
+
+
+  if (!job->username)
+    return;
+
+  key.username = (char *)job->username;
+
+  if ((ujobs = (_pappl_user_jobs_t *)cupsArrayFind(printer->user_jobs, &key)) == NULL)
+    return;
+
+  unlink_job(&ujobs->jobs, job, true);
+
+  if (ujobs->jobs.count == 0)
+    cupsArrayRemove(printer->user_jobs, ujobs);
+}
+
+
+//
+// 'unlink_job()' - Remove a job from the list of all jobs or a user's jobs.
+//
+
+static void
+unlink_job(_pappl_job_list_t *list,	// I - List of jobs
+           pappl_job_t       *job,	// I - Job
+           bool              user)	// I - `true` for a user's jobs, `false` for all jobs
+{
+  pappl_job_t	*prev = user ? job->user_prev : job->all_prev,
+					// Previous job
+		*next = user ? job->user_next : job->all_next;
+					// Next job
+
+
+  if (prev)
+  {
+    if (user)
+      prev->user_next = next;
+    else
+      prev->all_next = next;
+  }
+  else
+    list->first = next;
+
+  if (next)
+  {
+    if (user)
+      next->user_prev = prev;
+    else
+      next->all_prev = prev;
+  }
+  else
+    list->last = prev;
+
+  if (user)
+    job->user_prev = job->user_next = NULL;
+  else
+    job->all_prev = job->all_next = NULL;
+
+  list->count --;
 }
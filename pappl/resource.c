@@ -16,6 +16,14 @@
 #include <cups/dir.h>
 
 
+//
+// Local constants...
+//
+
+#define _PAPPL_RESOURCE_CACHE_MAX	262144
+					// Maximum size of cached resource files
+
+
 //
 // Local functions...
 //
@@ -23,7 +31,10 @@
 static void		add_resource(pappl_system_t *system, _pappl_resource_t *r);
 static int		compare_resources(_pappl_resource_t *a, _pappl_resource_t *b);
 static _pappl_resource_t *copy_resource(_pappl_resource_t *r);
+static _pappl_resource_t *find_resource(pappl_system_t *system, const char *path);
 static void		free_resource(_pappl_resource_t *r);
+static void		hash_resource(pappl_system_t *system, _pappl_resource_t *r);
+static void		unhash_resource(pappl_system_t *system, _pappl_resource_t *r);
 
 
 //
@@ -335,6 +346,73 @@ papplSystemAddStringsFile(
 }
 
 
+//
+// '_papplSystemCacheResource()' - Get the cached contents of a resource file.
+//
+// Small resource files are loaded into memory the first time they are
+// requested, provided the file still has the size and modification time that
+// were recorded when the resource was added.  The cached data is kept for the
+// lifetime of the resource.  `NULL` is returned for files that are too large
+// or have changed, in which case the file needs to be read directly.
+//
+
+const void *				// O - Cached data or `NULL` if not cached
+_papplSystemCacheResource(
+    pappl_system_t    *system,		// I - System object
+    _pappl_resource_t *r,		// I - Resource
+    size_t            *length)		// O - Length of cached data
+{
+  const void	*data;			// Cached data
+  int		fd;			// File descriptor
+  struct stat	fileinfo;		// File information
+  char		*buffer;		// File buffer
+  size_t	total;			// Total bytes read
+  ssize_t	bytes;			// Bytes read
+
+
+  *length = 0;
+
+  if (!r->filename || r->length > _PAPPL_RESOURCE_CACHE_MAX)
+    return (NULL);
+
+  pthread_mutex_lock(&r->cache_mutex);
+
+  if (!r->cache_loaded)
+  {
+    r->cache_loaded = true;
+
+    if ((fd = open(r->filename, O_RDONLY)) >= 0)
+    {
+      if (!fstat(fd, &fileinfo) && fileinfo.st_mtime == r->last_modified && (size_t)fileinfo.st_size == r->length && (buffer = malloc(r->length + 1)) != NULL)
+      {
+        for (total = 0; total < r->length; total += (size_t)bytes)
+        {
+          if ((bytes = read(fd, buffer + total, r->length - total)) <= 0)
+            break;
+        }
+
+        if (total == r->length)
+        {
+          papplLog(system, PAPPL_LOGLEVEL_DEBUG, "Cached %u bytes for resource '%s'.", (unsigned)total, r->path);
+          r->cache = buffer;
+	}
+	else
+	  free(buffer);
+      }
+
+      close(fd);
+    }
+  }
+
+  if ((data = r->cache) != NULL)
+    *length = r->length;
+
+  pthread_mutex_unlock(&r->cache_mutex);
+
+  return (data);
+}
+
+
 //
 // '_papplSystemFindResource()' - Find a resource at a path.
 //
@@ -344,23 +422,19 @@ _papplSystemFindResource(
     pappl_system_t *system,		// I - System object
     const char     *path)		// I - Resource path
 {
-  _pappl_resource_t	key,		// Search key
-			*match;		// Matching resource, if any
+  _pappl_resource_t	*match;		// Matching resource, if any
   char			altpath[1024];	// Alternate path
 
 
   if (!system || !system->resources || !path)
     return (NULL);
 
-  key.path = (char *)path;
-
   pthread_rwlock_rdlock(&system->rwlock);
 
-  if ((match = (_pappl_resource_t *)cupsArrayFind(system->resources, &key)) == NULL)
+  if ((match = find_resource(system, path)) == NULL)
   {
     snprintf(altpath, sizeof(altpath), "%s/", path);
-    key.path = altpath;
-    match = (_pappl_resource_t *)cupsArrayFind(system->resources, &key);
+    match = find_resource(system, altpath);
   }
 
   pthread_rwlock_unlock(&system->rwlock);
@@ -380,20 +454,18 @@ papplSystemRemoveResource(
     pappl_system_t *system,		// I - System object
     const char     *path)		// I - Resource path
 {
-  _pappl_resource_t	key,		// Search key
-			*match;		// Matching resource, if any
+  _pappl_resource_t	*match;		// Matching resource, if any
 
 
   if (!system || !system->resources || !path)
     return;
 
-  key.path = (char *)path;
-
   pthread_rwlock_wrlock(&system->rwlock);
 
-  if ((match = (_pappl_resource_t *)cupsArrayFind(system->resources, &key)) != NULL)
+  if ((match = find_resource(system, path)) != NULL)
   {
     papplLog(system, PAPPL_LOGLEVEL_DEBUG, "Removing resource for '%s'.", path);
+    unhash_resource(system, match);
     cupsArrayRemove(system->resources, match);
   }
 
@@ -419,6 +491,7 @@ add_resource(pappl_system_t    *system,	// I - System object
       system->resources = cupsArrayNew3((cups_array_func_t)compare_resources, NULL, NULL, 0, (cups_acopy_func_t)copy_resource, (cups_afree_func_t)free_resource);
 
     cupsArrayAdd(system->resources, r);
+    hash_resource(system, (_pappl_resource_t *)cupsArrayFind(system->resources, r));
   }
 
   pthread_rwlock_unlock(&system->rwlock);
@@ -457,6 +530,8 @@ copy_resource(_pappl_resource_t *r)	// I - Resource to copy
     newr->cb            = r->cb;
     newr->cbdata        = r->cbdata;
 
+    pthread_mutex_init(&newr->cache_mutex, NULL);
+
     if (r->filename)
       newr->filename = strdup(r->filename);
     if (r->language)
@@ -473,6 +548,42 @@ copy_resource(_pappl_resource_t *r)	// I - Resource to copy
 }
 
 
+//
+// 'find_resource()' - Find a resource using the path hash table.
+//
+// The caller must hold the system lock.
+//
+
+static _pappl_resource_t *		// O - Matching resource or `NULL`
+find_resource(pappl_system_t *system,	// I - System object
+              const char     *path)	// I - Resource path
+{
+  unsigned		hash;		// Hash of path
+  _pappl_resource_t	*r;		// Current resource
+
+
+  if (!system->resource_hash)
+  {
+    // Fall back to a binary search if the hash table could not be allocated...
+    _pappl_resource_t	key;		// Search key
+
+    key.path = (char *)path;
+
+    return ((_pappl_resource_t *)cupsArrayFind(system->resources, &key));
+  }
+
+  hash = _papplHashString(path, _PAPPL_HASH_INIT);
+
+  for (r = system->resource_hash[hash & (system->resource_hash_size - 1)]; r; r = r->hash_next)
+  {
+    if (r->hash == hash && !strcmp(r->path, path))
+      break;
+  }
+
+  return (r);
+}
+
+
 //
 // 'free_resource()' - Free the memory used for a resource.
 //
@@ -484,6 +595,88 @@ free_resource(_pappl_resource_t *r)	// I - Resource
   free(r->format);
   free(r->filename);
   free(r->language);
+  free(r->cache);
+
+  pthread_mutex_destroy(&r->cache_mutex);
 
   free(r);
 }
+
+
+//
+// 'hash_resource()' - Add a resource to the path hash table.
+//
+// The caller must hold the system write lock.
+//
+
+static void
+hash_resource(pappl_system_t    *system,// I - System object
+              _pappl_resource_t *r)	// I - Resource
+{
+  size_t		bucket;		// Hash bucket
+
+
+  if (!r)
+    return;
+
+  r->hash = _papplHashString(r->path, _PAPPL_HASH_INIT);
+
+  // Grow the hash table as needed to keep the chains short...
+  if ((size_t)cupsArrayCount(system->resources) > system->resource_hash_size)
+  {
+    size_t		hash_size = system->resource_hash_size ? 2 * system->resource_hash_size : 128;
+					// New size of hash table
+    _pappl_resource_t	**hash,		// New hash table
+			*current;	// Current resource
+
+    if ((hash = calloc(hash_size, sizeof(_pappl_resource_t *))) != NULL)
+    {
+      // Rehash all of the resources, including the new one...
+      for (current = (_pappl_resource_t *)cupsArrayFirst(system->resources); current; current = (_pappl_resource_t *)cupsArrayNext(system->resources))
+      {
+        bucket             = current->hash & (hash_size - 1);
+        current->hash_next = hash[bucket];
+        hash[bucket]       = current;
+      }
+
+      free(system->resource_hash);
+
+      system->resource_hash      = hash;
+      system->resource_hash_size = hash_size;
+      return;
+    }
+    else if (!system->resource_hash)
+      return;
+  }
+
+  bucket                        = r->hash & (system->resource_hash_size - 1);
+  r->hash_next                  = system->resource_hash[bucket];
+  system->resource_hash[bucket] = r;
+}
+
+
+//
+// 'unhash_resource()' - Remove a resource from the path hash table.
+//
+// The caller must hold the system write lock.
+//
+
+static void
+unhash_resource(pappl_system_t    *system,// I - System object
+                _pappl_resource_t *r)	// I - Resource
+{
+  _pappl_resource_t	**ptr;		// Pointer into hash chain
+
+
+  if (!system->resource_hash)
+    return;
+
+  for (ptr = system->resource_hash + (r->hash & (system->resource_hash_size - 1)); *ptr; ptr = &((*ptr)->hash_next))
+  {
+    if (*ptr == r)
+    {
+      *ptr = r->hash_next;
+      break;
+    }
+  }
+}
@@ -31,6 +31,56 @@
 static bool		add_listeners(pappl_system_t *system, const char *name, int port, int family);
 static int		compare_filters(_pappl_mime_filter_t *a, _pappl_mime_filter_t *b);
 static _pappl_mime_filter_t *copy_filter(_pappl_mime_filter_t *f);
+static unsigned		hash_filter(const char *srctype, const char *dsttype);
+
+
+//
+// '_papplSystemAddListenerFd()' - Add an existing listener socket to a system.
+//
+// This function adds a listening socket that was opened by another process,
+// for example the command that started the server.  The "name" parameter is
+// only used for logging.
+//
+
+bool					// O - `true` on success, `false` on failure
+_papplSystemAddListenerFd(
+    pappl_system_t *system,		// I - System
+    int            fd,			// I - Listener socket
+    const char     *name)		// I - Listener address
+{
+  int		listening = 0;		// Is the socket listening?
+  socklen_t	len = sizeof(listening);// Length of value
+
+
+  if (!system || fd < 0)
+  {
+    return (false);
+  }
+  else if (system->is_running)
+  {
+    papplLog(system, PAPPL_LOGLEVEL_FATAL, "Tried to add listeners while system is running.");
+    return (false);
+  }
+  else if (system->num_listeners >= _PAPPL_MAX_LISTENERS)
+  {
+    return (false);
+  }
+
+  if (getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &len) || !listening)
+  {
+    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Inherited file descriptor %d for '%s' is not a listener socket.", fd, name);
+    return (false);
+  }
+
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+  system->listeners[system->num_listeners].fd        = fd;
+  system->listeners[system->num_listeners ++].events = POLLIN;
+
+  papplLog(system, PAPPL_LOGLEVEL_INFO, "Listening for connections on '%s' (inherited).", name);
+
+  return (true);
+}
 
 
 //
@@ -184,8 +234,39 @@ papplSystemAddMIMEFilter(
 
   if (!cupsArrayFind(system->filters, &key))
   {
+    _pappl_mime_filter_t *f;		// New filter
+    unsigned		bucket;		// Hash bucket
+
     papplLog(system, PAPPL_LOGLEVEL_DEBUG, "Adding '%s' to '%s' filter.", srctype, dsttype);
     cupsArrayAdd(system->filters, &key);
+
+    if ((f = (_pappl_mime_filter_t *)cupsArrayFind(system->filters, &key)) != NULL)
+    {
+      bucket                      = hash_filter(srctype, dsttype);
+      f->hash_next                = system->filter_hash[bucket];
+      system->filter_hash[bucket] = f;
+    }
+  }
+}
+
+
+//
+// 'papplSystemClearAuthCache()' - Clear the cached authentication results.
+//
+// This function discards all cached PAM authentication results so that the
+// next request from each user is authenticated again.  Call it after changing
+// user passwords or group memberships that must take effect immediately.
+//
+
+void
+papplSystemClearAuthCache(
+    pappl_system_t *system)		// I - System
+{
+  if (system)
+  {
+    pthread_mutex_lock(&system->auth_mutex);
+    system->num_auth_cache = 0;
+    pthread_mutex_unlock(&system->auth_mutex);
   }
 }
 
@@ -199,12 +280,14 @@ _papplSystemExportVersions(
     pappl_system_t *system,		// I - System
     ipp_t          *ipp,		// I - IPP message
     ipp_tag_t      group_tag,		// I - Group (`IPP_TAG_PRINTER` or `IPP_TAG_SYSTEM`)
-    cups_array_t   *ra)			// I - Requested attributes or `NULL` for all
+    _pappl_ra_t    *ra)			// I - Requested attributes or `NULL` for all
 {
   int		i;			// Looping var
+  bool		is_printer = (group_tag == IPP_TAG_PRINTER);
+					// Exporting printer attributes?
   ipp_attribute_t *attr;		// Attribute
   char		name[128];		// Attribute name
-  const char	*name_prefix = (group_tag == IPP_TAG_PRINTER) ? "printer" : "system";
+  const char	*name_prefix = is_printer ? "printer" : "system";
   const char	*values[20];		// String values
   char		cups_sversion[32];	// String version of libcups
 #ifdef HAVE_LIBJPEG
@@ -215,7 +298,7 @@ _papplSystemExportVersions(
 
   // "xxx-firmware-name"
   snprintf(name, sizeof(name), "%s-firmware-name", name_prefix);
-  if (!ra || cupsArrayFind(ra, name))
+  if (_PAPPL_REQUESTED(ra, is_printer ? _PAPPL_ATTR_PRINTER_FIRMWARE_NAME : _PAPPL_ATTR_SYSTEM_FIRMWARE_NAME))
   {
     for (i = 0; i < system->num_versions; i ++)
       values[i] = system->versions[i].name;
@@ -237,7 +320,7 @@ _papplSystemExportVersions(
 
   // "xxx-firmware-patches"
   snprintf(name, sizeof(name), "%s-firmware-patches", name_prefix);
-  if (!ra || cupsArrayFind(ra, name))
+  if (_PAPPL_REQUESTED(ra, is_printer ? _PAPPL_ATTR_PRINTER_FIRMWARE_PATCHES : _PAPPL_ATTR_SYSTEM_FIRMWARE_PATCHES))
   {
     for (i = 0; i < system->num_versions; i ++)
       values[i] = system->versions[i].patches;
@@ -259,7 +342,7 @@ _papplSystemExportVersions(
 
   // "xxx-firmware-string-version"
   snprintf(name, sizeof(name), "%s-firmware-string-version", name_prefix);
-  if (!ra || cupsArrayFind(ra, name))
+  if (_PAPPL_REQUESTED(ra, is_printer ? _PAPPL_ATTR_PRINTER_FIRMWARE_STRING_VERSION : _PAPPL_ATTR_SYSTEM_FIRMWARE_STRING_VERSION))
   {
     for (i = 0; i < system->num_versions; i ++)
       values[i] = system->versions[i].sversion;
@@ -283,7 +366,7 @@ _papplSystemExportVersions(
 
   // "xxx-firmware-version"
   snprintf(name, sizeof(name), "%s-firmware-version", name_prefix);
-  if (!ra || cupsArrayFind(ra, name))
+  if (_PAPPL_REQUESTED(ra, is_printer ? _PAPPL_ATTR_PRINTER_FIRMWARE_VERSION : _PAPPL_ATTR_SYSTEM_FIRMWARE_VERSION))
   {
     for (i = 0, attr = NULL; i < system->num_versions; i ++)
     {
@@ -331,8 +414,7 @@ _papplSystemFindMIMEFilter(
     const char     *srctype,		// I - Source MIME media type string
     const char     *dsttype)		// I - Destination MIME media type string
 {
-  _pappl_mime_filter_t	key,		// Search key
-			*match;		// Matching filter
+  _pappl_mime_filter_t	*match;		// Matching filter
 
 
   if (!system || !srctype || !dsttype)
@@ -340,10 +422,11 @@ _papplSystemFindMIMEFilter(
 
   pthread_rwlock_rdlock(&system->rwlock);
 
-  key.src = srctype;
-  key.dst = dsttype;
-
-  match = (_pappl_mime_filter_t *)cupsArrayFind(system->filters, &key);
+  for (match = system->filter_hash[hash_filter(srctype, dsttype)]; match; match = match->hash_next)
+  {
+    if (!strcmp(match->src, srctype) && !strcmp(match->dst, dsttype))
+      break;
+  }
 
   pthread_rwlock_unlock(&system->rwlock);
 
@@ -388,6 +471,52 @@ papplSystemGetAdminGroup(
 }
 
 
+//
+// '_papplSystemGetAuthCookie()' - Get the authorization cookie value.
+//
+// The cookie value is the SHA2-256 hash of the current session key and access
+// password hash.  It is computed once per session key and password.
+//
+
+char *					// O - Cookie value
+_papplSystemGetAuthCookie(
+    pappl_system_t *system,		// I - System
+    char           *buffer,		// I - String buffer
+    size_t         bufsize)		// I - Size of string buffer
+{
+  char		session_key[65],	// Current session key
+		password_hash[100],	// Password hash
+		auth_text[256];		// Authorization string
+  unsigned char	auth_hash[32];		// Authorization hash
+
+
+  // Make sure the session key is current...
+  papplSystemGetSessionKey(system, session_key, sizeof(session_key));
+
+  pthread_rwlock_rdlock(&system->session_rwlock);
+
+  if (!system->session_auth[0])
+  {
+    // Compute the cookie value for this session key...
+    pthread_rwlock_unlock(&system->session_rwlock);
+    pthread_rwlock_wrlock(&system->session_rwlock);
+
+    if (!system->session_auth[0])
+    {
+      snprintf(auth_text, sizeof(auth_text), "%s:%s", system->session_key, papplSystemGetPassword(system, password_hash, sizeof(password_hash)));
+      cupsHashData("sha2-256", (unsigned char *)auth_text, strlen(auth_text), auth_hash, sizeof(auth_hash));
+      cupsHashString(auth_hash, sizeof(auth_hash), system->session_auth, sizeof(system->session_auth));
+    }
+  }
+
+  strlcpy(buffer, system->session_auth, bufsize);
+
+  pthread_rwlock_unlock(&system->session_rwlock);
+
+  return (buffer);
+}
+
+
 //
 // 'papplSystemGetAuthService()' - Get the PAM authorization service, if any.
 //
@@ -880,6 +1009,27 @@ papplSystemGetServerHeader(
 }
 
 
+//
+// '_papplSystemGetSessionEpoch()' - Get the current session key generation.
+//
+// The generation changes whenever a new session key is created, allowing
+// values derived from the session key to be cached.
+//
+
+size_t					// O - Session key generation
+_papplSystemGetSessionEpoch(
+    pappl_system_t *system)		// I - System
+{
+  char	session_key[65];		// Current session key
+
+
+  if ((time(NULL) - system->session_time) > 86400)
+    papplSystemGetSessionKey(system, session_key, sizeof(session_key));
+
+  return (system->session_epoch);
+}
+
+
 //
 // 'papplSystemGetSessionKey()' - Get the current session key.
 //
@@ -904,8 +1054,13 @@ papplSystemGetSessionKey(
       // Lock for updating the session key with random data...
       pthread_rwlock_wrlock(&system->session_rwlock);
 
-      snprintf(system->session_key, sizeof(system->session_key), "%08x%08x%08x%08x%08x%08x%08x%08x", _papplGetRand(), _papplGetRand(), _papplGetRand(), _papplGetRand(), _papplGetRand(), _papplGetRand(), _papplGetRand(), _papplGetRand());
-      system->session_time = curtime;
+      if ((curtime - system->session_time) > 86400)
+      {
+	snprintf(system->session_key, sizeof(system->session_key), "%08x%08x%08x%08x%08x%08x%08x%08x", _papplGetRand(), _papplGetRand(), _papplGetRand(), _papplGetRand(), _papplGetRand(), _papplGetRand(), _papplGetRand(), _papplGetRand());
+	system->session_time    = curtime;
+	system->session_epoch ++;
+	system->session_auth[0] = '\0';
+      }
     }
     else
     {
@@ -1216,6 +1371,34 @@ papplSystemSetAdminGroup(
     system->config_changes ++;
 
     pthread_rwlock_unlock(&system->rwlock);
+
+    papplSystemClearAuthCache(system);
+  }
+}
+
+
+//
+// 'papplSystemSetAuthCacheTime()' - Set how long to cache authentications.
+//
+// This function sets the number of seconds that a successful PAM
+// authentication of a username and password is remembered.  Repeated requests
+// with the same credentials from the same client within that time skip the
+// PAM service.  A value of `0` disables the cache.
+//
+// The default is 60 seconds.
+//
+
+void
+papplSystemSetAuthCacheTime(
+    pappl_system_t *system,		// I - System
+    int            seconds)		// I - Seconds to cache or `0` to disable
+{
+  if (system && seconds >= 0)
+  {
+    pthread_mutex_lock(&system->auth_mutex);
+    system->auth_cache_time = seconds;
+    system->num_auth_cache  = 0;
+    pthread_mutex_unlock(&system->auth_mutex);
   }
 }
 
@@ -1719,6 +1902,11 @@ papplSystemSetPassword(
     system->config_changes ++;
 
     pthread_rwlock_unlock(&system->rwlock);
+
+    // Clear the cached authorization cookie...
+    pthread_rwlock_wrlock(&system->session_rwlock);
+    system->session_auth[0] = '\0';
+    pthread_rwlock_unlock(&system->session_rwlock);
   }
 }
 
@@ -1805,6 +1993,37 @@ papplSystemSetSaveCallback(
 }
 
 
+//
+// 'papplSystemSetSaveDelay()' - Set how long to wait before saving changes.
+//
+// This function sets how long the system waits before calling the save
+// callback after a configuration or job change.  The "delay" argument
+// specifies the number of seconds without further changes, so that a burst of
+// changes results in a single save.  The "max_delay" argument specifies the
+// maximum number of seconds a save can be delayed by continuing changes.
+//
+// The default is to wait 1 second after the last change and at most 10 seconds
+// after the first unsaved change.
+//
+// > Note: This function can only be called before @link papplSystemRun@.
+//
+
+void
+papplSystemSetSaveDelay(
+    pappl_system_t *system,		// I - System
+    int            delay,		// I - Seconds to wait for more changes
+    int            max_delay)		// I - Maximum seconds to delay a save
+{
+  if (system && !system->is_running && delay >= 0 && max_delay >= delay)
+  {
+    pthread_rwlock_wrlock(&system->rwlock);
+    system->save_delay     = delay;
+    system->save_max_delay = max_delay;
+    pthread_rwlock_unlock(&system->rwlock);
+  }
+}
+
+
 //
 // 'papplSystemSetUUID()' - Set the system UUID.
 //
@@ -1976,3 +2195,22 @@ copy_filter(_pappl_mime_filter_t *f)	// I - Filter definition
 
   return (newf);
 }
+
+
+//
+// 'hash_filter()' - Compute the hash bucket for a pair of MIME media types.
+//
+
+static unsigned				// O - Hash bucket
+hash_filter(const char *srctype,	// I - Source MIME media type
+            const char *dsttype)	// I - Destination MIME media type
+{
+  unsigned	hash;			// Hash value
+
+
+  hash = _papplHashString(srctype, _PAPPL_HASH_INIT);
+  hash = _papplHashString("/", hash);
+  hash = _papplHashString(dsttype, hash);
+
+  return ((hash ^ (hash >> 16)) % _PAPPL_MAX_FILTER_HASH);
+}
@@ -47,7 +47,13 @@ void
 _papplSystemProcessIPP(
     pappl_client_t *client)		// I - Client
 {
-  switch (ippGetOperation(client->request))
+  ipp_op_t	op = ippGetOperation(client->request);
+					// IPP operation
+
+
+  _PAPPL_TRACE(PAPPL_TRACE_IPP_OPERATION, system__operation, ippOpString(op), client->number, (size_t)op);
+
+  switch (op)
   {
     case IPP_OP_CREATE_PRINTER :
 	ipp_create_printer(client);
@@ -104,8 +110,17 @@ ipp_create_printer(
 		*driver_name;		// Name of driver
   ipp_attribute_t *attr;		// Current attribute
   pappl_printer_t *printer;		// Printer
-  cups_array_t	*ra;			// Requested attributes
+  _pappl_ra_t	ra;			// Requested attributes
   http_status_t	auth_status;		// Authorization status
+  static const char * const names[] =
+  {					// Attributes for the new printer
+    "printer-id",
+    "printer-is-accepting-jobs",
+    "printer-state",
+    "printer-state-reasons",
+    "printer-uuid",
+    "printer-xri-supported"
+  };
 
 
   // Verify the connection is authorized...
@@ -218,16 +233,11 @@ ipp_create_printer(
   // Return the printer
   papplClientRespondIPP(client, IPP_STATUS_OK, NULL);
 
-  ra = cupsArrayNew((cups_array_func_t)strcmp, NULL);
-  cupsArrayAdd(ra, "printer-id");
-  cupsArrayAdd(ra, "printer-is-accepting-jobs");
-  cupsArrayAdd(ra, "printer-state");
-  cupsArrayAdd(ra, "printer-state-reasons");
-  cupsArrayAdd(ra, "printer-uuid");
-  cupsArrayAdd(ra, "printer-xri-supported");
-
-  _papplPrinterCopyAttributes(client, printer, ra, NULL);
-  cupsArrayDelete(ra);
+  _papplRequestedCreateNames(&ra, sizeof(names) / sizeof(names[0]), names);
+  pthread_rwlock_rdlock(&printer->rwlock);
+  _papplPrinterCopyAttributes(client, printer, &ra, NULL);
+  pthread_rwlock_unlock(&printer->rwlock);
+  _papplRequestedDelete(&ra);
 }
 
 
@@ -274,7 +284,7 @@ ipp_get_printers(
 {
   pappl_system_t	*system = client->system;
 					// System
-  cups_array_t		*ra;		// Requested attributes array
+  _pappl_ra_t		ra;		// Requested attributes
   int			i,		// Looping var
 			count,		// Number of printers
 			limit;		// Maximum number to return
@@ -283,8 +293,9 @@ ipp_get_printers(
 
 
   // Get request attributes...
+  _papplRequestedCreate(&ra, client->request, 0, NULL);
+
   limit  = ippGetInteger(ippFindAttribute(client->request, "limit", IPP_TAG_INTEGER), 0);
-  ra     = ippCreateRequestedArray(client->request);
   format = ippGetString(ippFindAttribute(client->request, "document-format", IPP_TAG_MIMETYPE), 0, NULL);
 
   papplClientRespondIPP(client, IPP_STATUS_OK, NULL);
@@ -308,13 +319,13 @@ ipp_get_printers(
       ippAddSeparator(client->response);
 
     pthread_rwlock_rdlock(&printer->rwlock);
-    _papplPrinterCopyAttributes(client, printer, ra, format);
+    _papplPrinterCopyAttributes(client, printer, &ra, format);
     pthread_rwlock_unlock(&printer->rwlock);
   }
 
   pthread_rwlock_unlock(&system->rwlock);
 
-  cupsArrayDelete(ra);
+  _papplRequestedDelete(&ra);
 }
 
 
@@ -328,7 +339,9 @@ ipp_get_system_attributes(
 {
   pappl_system_t	*system = client->system;
 					// System
-  cups_array_t		*ra;		// Requested attributes array
+  _pappl_ra_t		requested,	// Requested attributes
+			*ra = &requested;
+					// Pointer to requested attributes
   int			i,		// Looping var
 			count;		// Count of values
   pappl_printer_t	*printer;	// Current printer
@@ -339,15 +352,16 @@ ipp_get_system_attributes(
   time_t		state_time = 0;	// system-state-change-[date-]time value
 
 
-  ra = ippCreateRequestedArray(client->request);
+  _papplRequestedCreate(ra, client->request, 0, NULL);
 
   papplClientRespondIPP(client, IPP_STATUS_OK, NULL);
 
   pthread_rwlock_rdlock(&system->rwlock);
 
-  _papplCopyAttributes(client->response, system->attrs, ra, IPP_TAG_ZERO, IPP_TAG_CUPS_CONST);
+  if (!_papplClientCopyBlob(client, system->attrs_blob, IPP_TAG_SYSTEM, ra->array))
+    _papplCopyAttributes(client->response, system->attrs, ra->array, IPP_TAG_ZERO, IPP_TAG_CUPS_CONST);
 
-  if (!ra || cupsArrayFind(ra, "system-config-change-date-time") || cupsArrayFind(ra, "system-config-change-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_CONFIG_CHANGE_DATE_TIME) || _PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_CONFIG_CHANGE_TIME))
   {
     for (i = 0, count = cupsArrayCount(system->printers); i < count; i ++)
     {
@@ -357,14 +371,14 @@ ipp_get_system_attributes(
         config_time = printer->config_time;
     }
 
-    if (!ra || cupsArrayFind(ra, "system-config-change-date-time"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_CONFIG_CHANGE_DATE_TIME))
       ippAddDate(client->response, IPP_TAG_SYSTEM, "system-config-change-date-time", ippTimeToDate(config_time));
 
-    if (!ra || cupsArrayFind(ra, "system-config-change-time"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_CONFIG_CHANGE_TIME))
       ippAddInteger(client->response, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, "system-config-change-time", (int)(config_time - system->start_time));
   }
 
-  if (!ra || cupsArrayFind(ra, "system-configured-printers"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_CONFIGURED_PRINTERS))
   {
     attr = ippAddCollections(client->response, IPP_TAG_SYSTEM, "system-configured-printers", cupsArrayCount(system->printers), NULL);
 
@@ -391,22 +405,22 @@ ipp_get_system_attributes(
     }
   }
 
-  if (!ra || cupsArrayFind(ra, "system-contact-col"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_CONTACT_COL))
   {
     col = _papplContactExport(&system->contact);
     ippAddCollection(client->response, IPP_TAG_SYSTEM, "system-contact-col", col);
     ippDelete(col);
   }
 
-  if (!ra || cupsArrayFind(ra, "system-current-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_CURRENT_TIME))
     ippAddDate(client->response, IPP_TAG_SYSTEM, "system-current-time", ippTimeToDate(time(NULL)));
 
-  if (!ra || cupsArrayFind(ra, "system-default-printer-id"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_DEFAULT_PRINTER_ID))
     ippAddInteger(client->response, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, "system-default-printer-id", system->default_printer_id);
 
   _papplSystemExportVersions(system, client->response, IPP_TAG_SYSTEM, ra);
 
-  if (!ra || cupsArrayFind(ra, "system-geo-location"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_GEO_LOCATION))
   {
     if (system->geo_location)
       ippAddString(client->response, IPP_TAG_SYSTEM, IPP_TAG_URI, "system-geo-location", NULL, system->geo_location);
@@ -414,19 +428,19 @@ ipp_get_system_attributes(
       ippAddOutOfBand(client->response, IPP_TAG_SYSTEM, IPP_TAG_UNKNOWN, "system-geo-location");
   }
 
-  if (!ra || cupsArrayFind(ra, "system-location"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_LOCATION))
     ippAddString(client->response, IPP_TAG_SYSTEM, IPP_TAG_TEXT, "system-location", NULL, system->location ? system->location : "");
 
-  if (!ra || cupsArrayFind(ra, "system-name"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_NAME))
     ippAddString(client->response, IPP_TAG_SYSTEM, IPP_TAG_NAME, "system-name", NULL, system->name);
 
-  if (!ra || cupsArrayFind(ra, "system-organization"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_ORGANIZATION))
     ippAddString(client->response, IPP_TAG_SYSTEM, IPP_TAG_TEXT, "system-organization", NULL, system->organization ? system->organization : "");
 
-  if (!ra || cupsArrayFind(ra, "system-organizational-unit"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_ORGANIZATIONAL_UNIT))
     ippAddString(client->response, IPP_TAG_SYSTEM, IPP_TAG_TEXT, "system-organizational-unit", NULL, system->org_unit ? system->org_unit : "");
 
-  if (!ra || cupsArrayFind(ra, "system-state"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_STATE))
   {
     int	state = IPP_PSTATE_IDLE;	// System state
 
@@ -444,7 +458,7 @@ ipp_get_system_attributes(
     ippAddInteger(client->response, IPP_TAG_SYSTEM, IPP_TAG_ENUM, "system-state", state);
   }
 
-  if (!ra || cupsArrayFind(ra, "system-state-change-date-time") || cupsArrayFind(ra, "system-state-change-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_STATE_CHANGE_DATE_TIME) || _PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_STATE_CHANGE_TIME))
   {
     for (i = 0, count = cupsArrayCount(system->printers); i < count; i ++)
     {
@@ -454,14 +468,14 @@ ipp_get_system_attributes(
         state_time = printer->state_time;
     }
 
-    if (!ra || cupsArrayFind(ra, "system-state-change-date-time"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_STATE_CHANGE_DATE_TIME))
       ippAddDate(client->response, IPP_TAG_SYSTEM, "system-state-change-date-time", ippTimeToDate(state_time));
 
-    if (!ra || cupsArrayFind(ra, "system-state-change-time"))
+    if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_STATE_CHANGE_TIME))
       ippAddInteger(client->response, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, "system-state-change-time", (int)(state_time - system->start_time));
   }
 
-  if (!ra || cupsArrayFind(ra, "system-state-reasons"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_STATE_REASONS))
   {
     pappl_preason_t	state_reasons = PAPPL_PREASON_NONE;
 
@@ -493,13 +507,13 @@ ipp_get_system_attributes(
     }
   }
 
-  if (!ra || cupsArrayFind(ra, "system-up-time"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_UP_TIME))
     ippAddInteger(client->response, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, "system-up-time", (int)(time(NULL) - system->start_time));
 
-  if (system->uuid && (!ra || cupsArrayFind(ra, "system-uuid")))
+  if (system->uuid && (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_UUID)))
     ippAddString(client->response, IPP_TAG_SYSTEM, IPP_TAG_URI, "system-uuid", NULL, system->uuid);
 
-  if (!ra || cupsArrayFind(ra, "system-xri-supported"))
+  if (_PAPPL_REQUESTED(ra, _PAPPL_ATTR_SYSTEM_XRI_SUPPORTED))
   {
     char	uri[1024];		// URI value
 
@@ -515,7 +529,11 @@ ipp_get_system_attributes(
 
   pthread_rwlock_unlock(&system->rwlock);
 
-  cupsArrayDelete(ra);
+  // Metrics are only returned when explicitly requested...
+  if (ra->array && cupsArrayFind(ra->array, "smi2699-system-metrics-col"))
+    _papplSystemCopyMetrics(system, client->response);
+
+  _papplRequestedDelete(ra);
 }
 
 
@@ -14,24 +14,172 @@
 #include "pappl-private.h"
 
 
+//
+// Local constants...
+//
+
+#define _PAPPL_MAX_JOURNAL	1000	// Maximum journal records before compaction
+#define _PAPPL_MAX_LOAD_THREADS	8	// Maximum threads for creating printers
+
+
+//
+// Local types...
+//
+
+typedef struct _pappl_load_line_s	// Line from a state file
+{
+  int			linenum;		// Line number
+  char			*line,			// Directive
+			*value;			// Value or `NULL`
+} _pappl_load_line_t;
+
+typedef struct _pappl_load_printer_s	// Printer definition from a state file
+{
+  int			num_options;		// Number of "<Printer" options
+  cups_option_t		*options;		// "<Printer" options
+  int			printer_id;		// Printer ID
+  const char		*name,			// Printer name
+			*device_id,		// Device ID
+			*device_uri,		// Device URI
+			*driver_name;		// Driver name
+  pappl_printer_t	*printer;		// Printer, if created
+  int			error;			// Error from creating printer
+  size_t		num_lines,		// Number of lines
+			alloc_lines;		// Allocated lines
+  _pappl_load_line_t	*lines;			// Lines in printer definition
+} _pappl_load_printer_t;
+
+typedef struct _pappl_load_s		// State file being loaded
+{
+  pappl_system_t	*system;		// System
+  const char		*filename;		// State file
+  pthread_mutex_t	mutex;			// Mutex for next_printer
+  size_t		num_printers,		// Number of printers
+			alloc_printers,		// Allocated printers
+			next_printer;		// Next printer to create
+  _pappl_load_printer_t	*printers;		// Printers
+  size_t		num_records,		// Number of appended job records
+			alloc_records;		// Allocated job records
+  _pappl_load_line_t	*records;		// Appended job records
+} _pappl_load_t;
+
+
 //
 // Local functions...
 //
 
+static bool	add_line(size_t *num_lines, size_t *alloc_lines, _pappl_load_line_t **lines, const char *line, const char *value, int linenum);
+static bool	append_journal(pappl_system_t *system, const char *filename, _pappl_journal_t *journal, size_t num_journal);
+static void	free_lines(size_t num_lines, _pappl_load_line_t *lines);
+static bool	load_job(pappl_system_t *system, pappl_printer_t *printer, char *value, const char *filename, int linenum);
+static void	load_printer(pappl_system_t *system, _pappl_load_printer_t *lp, const char *filename);
+static void	*load_printers(_pappl_load_t *load);
+
 static void	parse_contact(char *value, pappl_contact_t *contact);
 static void	parse_media_col(char *value, pappl_media_col_t *media);
 static char	*read_line(cups_file_t *fp, char *line, size_t linesize, char **value, int *linenum);
 static void	write_contact(cups_file_t *fp, pappl_contact_t *contact);
+static void	write_job(pappl_system_t *system, cups_file_t *fp, pappl_job_t *job, int printer_id);
 static void	write_media_col(cups_file_t *fp, const char *name, pappl_media_col_t *media);
 static void	write_options(cups_file_t *fp, const char *name, int num_options, cups_option_t *options);
 
 
+//
+// '_papplSystemClearJournal()' - Discard any pending state journal entries.
+//
+
+void
+_papplSystemClearJournal(
+    pappl_system_t *system)		// I - System
+{
+  size_t		i,		// Looping var
+			num_journal;	// Number of journal entries
+  _pappl_journal_t	*journal;	// Journal entries
+
+
+  pthread_rwlock_wrlock(&system->rwlock);
+
+  journal     = system->journal;
+  num_journal = system->num_journal;
+
+  system->journal       = NULL;
+  system->num_journal   = 0;
+  system->alloc_journal = 0;
+
+  for (i = 0; i < num_journal; i ++)
+    journal[i].job->is_journaled = false;
+
+  pthread_rwlock_unlock(&system->rwlock);
+
+  for (i = 0; i < num_journal; i ++)
+    _papplJobRelease(journal[i].job);
+
+  free(journal);
+}
+
+
+//
+// '_papplSystemJournalJob()' - Record a job change in the state journal.
+//
+// Job changes are saved by appending the job's record to the state file
+// instead of rewriting it.  The configuration is still marked as changed so
+// that the save callback gets called.
+//
+
+void
+_papplSystemJournalJob(
+    pappl_system_t *system,		// I - System
+    pappl_job_t    *job)		// I - Job
+{
+  pthread_rwlock_wrlock(&system->rwlock);
+
+  if (system->is_running)
+  {
+    system->config_changes ++;
+
+    if (!job->is_journaled)
+    {
+      if (system->num_journal >= system->alloc_journal)
+      {
+        size_t		alloc_journal = system->alloc_journal ? 2 * system->alloc_journal : 32;
+					// New allocation
+        _pappl_journal_t *journal;	// New journal
+
+        if ((journal = realloc(system->journal, alloc_journal * sizeof(_pappl_journal_t))) == NULL)
+        {
+          // Force a full save if we can't journal the change...
+          pthread_rwlock_unlock(&system->rwlock);
+          return;
+	}
+
+        system->journal       = journal;
+        system->alloc_journal = alloc_journal;
+      }
+
+      _papplJobRetain(job);
+
+      system->journal[system->num_journal].job        = job;
+      system->journal[system->num_journal].printer_id = job->printer->printer_id;
+      system->num_journal ++;
+
+      job->is_journaled = true;
+    }
+
+    system->journal_changes ++;
+  }
+
+  pthread_rwlock_unlock(&system->rwlock);
+}
+
+
 //
 // 'papplSystemLoadState()' - Load the previous system state.
 //
 // This function loads the previous system state from a file created by the
 // @link papplSystemSaveState@ function.  The system state contains all of the
 // system object values, the list of printers, and the jobs for each printer.
+// Any job records that were appended to the file after it was last written are
+// applied after the printers have been loaded.
 //
 // When loading a printer definition, if the printer cannot be created (e.g.,
 // because the driver name is no longer valid) then that printer and all of its
@@ -40,6 +188,11 @@ static void	write_options(cups_file_t *fp, const char *name, int num_options, cu
 // name, including the use its auto-add callback to find a compatible new
 // driver.
 //
+// Printers are created and their job history is loaded on up to 8 threads, so
+// the driver, creation, and status callbacks may be called concurrently for
+// different printers and must be thread-safe.  If the state file does not
+// specify a default printer, the first printer in the file is the default.
+//
 // > Note: This function must be called prior to @link papplSystemRun@.
 //
 
@@ -48,12 +201,22 @@ papplSystemLoadState(
     pappl_system_t *system,		// I - System
     const char     *filename)		// I - File to load
 {
-  int			i;		// Looping var
+  size_t		i,		// Looping var
+			num_threads,	// Number of printer threads
+			num_jobs = 0;	// Number of jobs loaded
+  bool			ret = true,	// Return value
+			have_default;	// Default printer in state file?
   cups_file_t		*fp;		// Output file
   int			linenum;	// Line number
   char			line[2048],	// Line from file
-			*ptr,		// Pointer into line/value
 			*value;		// Value from line
+  _pappl_load_t		load;		// Loaded state
+  _pappl_load_printer_t	*lp = NULL;	// Current printer definition
+  pappl_printer_t	*printer;	// Loaded printer
+  pthread_t		tids[_PAPPL_MAX_LOAD_THREADS];
+					// Printer threads
+  struct timeval	starttime,	// Start time
+			endtime;	// End time
 
 
   // Range check input...
@@ -76,12 +239,37 @@ papplSystemLoadState(
     return (false);
   }
 
-  // Read lines from the state file...
+  // Read lines from the state file.  System values are set as they are read,
+  // while printer definitions and appended job records are kept until the
+  // whole file has been read...
   papplLog(system, PAPPL_LOGLEVEL_INFO, "Loading system state from '%s'.", filename);
 
+  gettimeofday(&starttime, NULL);
+
+  memset(&load, 0, sizeof(load));
+  load.system   = system;
+  load.filename = filename;
+  pthread_mutex_init(&load.mutex, NULL);
+
   linenum = 0;
   while (read_line(fp, line, sizeof(line), &value, &linenum))
   {
+    if (lp)
+    {
+      // Collect the lines in a printer definition...
+      if (!strcasecmp(line, "</Printer>"))
+      {
+        lp = NULL;
+      }
+      else if (!add_line(&lp->num_lines, &lp->alloc_lines, &lp->lines, line, value, linenum))
+      {
+        papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to allocate memory for system state.");
+        ret = false;
+        break;
+      }
+      continue;
+    }
+
     if (!strcasecmp(line, "DNSSDName"))
       papplSystemSetDNSSDName(system, value);
     else if (!strcasecmp(line, "Location"))
@@ -114,248 +302,64 @@ papplSystemLoadState(
       if ((system->uuid = strdup(value)) == NULL)
       {
         papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to allocate memory for system UUID.");
-        return (false);
+        ret = false;
+        break;
       }
     }
     else if (!strcasecmp(line, "<Printer") && value)
     {
       // Read a printer...
-      int		num_options;	// Number of options
-      cups_option_t	*options = NULL;// Options
-      const char	*printer_id,	// Printer ID
-			*printer_name,	// Printer name
-			*device_id,	// Device ID
-			*device_uri,	// Device URI
-			*driver_name;	// Driver name
-      pappl_printer_t	*printer;	// Current printer
+      const char	*printer_id;	// Printer ID
+
+      if (load.num_printers >= load.alloc_printers)
+      {
+        size_t			alloc_printers = load.alloc_printers + 16;
+					// New allocation
+        _pappl_load_printer_t	*printers;
+					// New printers
+
+        if ((printers = realloc(load.printers, alloc_printers * sizeof(_pappl_load_printer_t))) == NULL)
+        {
+	  papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to allocate memory for system state.");
+	  ret = false;
+	  break;
+        }
+
+        load.printers       = printers;
+        load.alloc_printers = alloc_printers;
+      }
 
+      lp = load.printers + load.num_printers;
+      memset(lp, 0, sizeof(_pappl_load_printer_t));
 
-      if ((num_options = cupsParseOptions(value, 0, &options)) != 5 || (printer_id = cupsGetOption("id", num_options, options)) == NULL || strtol(printer_id, NULL, 10) <= 0 || (printer_name = cupsGetOption("name", num_options, options)) == NULL || (device_id = cupsGetOption("did", num_options, options)) == NULL || (device_uri = cupsGetOption("uri", num_options, options)) == NULL || (driver_name = cupsGetOption("driver", num_options, options)) == NULL)
+      if ((lp->num_options = cupsParseOptions(value, 0, &lp->options)) != 5 || (printer_id = cupsGetOption("id", lp->num_options, lp->options)) == NULL || (lp->printer_id = (int)strtol(printer_id, NULL, 10)) <= 0 || (lp->name = cupsGetOption("name", lp->num_options, lp->options)) == NULL || (lp->device_id = cupsGetOption("did", lp->num_options, lp->options)) == NULL || (lp->device_uri = cupsGetOption("uri", lp->num_options, lp->options)) == NULL || (lp->driver_name = cupsGetOption("driver", lp->num_options, lp->options)) == NULL)
       {
         papplLog(system, PAPPL_LOGLEVEL_ERROR, "Bad printer definition on line %d of '%s'.", linenum, filename);
+        cupsFreeOptions(lp->num_options, lp->options);
         break;
       }
 
-      if ((printer = papplPrinterCreate(system, (int)strtol(printer_id, NULL, 10), printer_name, driver_name, device_id, device_uri)) == NULL)
-      {
-	if (errno == EEXIST)
-	  papplLog(system, PAPPL_LOGLEVEL_ERROR, "Printer '%s' already exists, dropping duplicate printer and job history in state file.", printer_name);
-	else if (errno == EIO)
-	  papplLog(system, PAPPL_LOGLEVEL_ERROR, "Dropping printer '%s' and its job history because the driver ('%s') is no longer supported.", printer_name, driver_name);
-	else
-	  papplLog(system, PAPPL_LOGLEVEL_ERROR, "Dropping printer '%s' and its job history because an error occurred: %s", printer_name, strerror(errno));
-      }
+      load.num_printers ++;
 
-      while (read_line(fp, line, sizeof(line), &value, &linenum))
+      // Printers are created in parallel, so check for duplicates now...
+      for (i = 0; i < (load.num_printers - 1); i ++)
       {
-        if (!strcasecmp(line, "</Printer>"))
-          break;
-	else if (!printer)
-	  continue;
-	else if (!strcasecmp(line, "DNSSDName"))
-	  papplPrinterSetDNSSDName(printer, value);
-	else if (!strcasecmp(line, "Location"))
-	  papplPrinterSetLocation(printer, value);
-	else if (!strcasecmp(line, "GeoLocation"))
-	  papplPrinterSetGeoLocation(printer, value);
-	else if (!strcasecmp(line, "Organization"))
-	  papplPrinterSetOrganization(printer, value);
-	else if (!strcasecmp(line, "OrganizationalUnit"))
-	  papplPrinterSetOrganizationalUnit(printer, value);
-	else if (!strcasecmp(line, "Contact"))
-	{
-	  pappl_contact_t	contact;// "printer-contact" value
-
-	  parse_contact(value, &contact);
-	  papplPrinterSetContact(printer, &contact);
-	}
-	else if (!strcasecmp(line, "PrintGroup"))
-	  papplPrinterSetPrintGroup(printer, value);
-	else if (!strcasecmp(line, "MaxActiveJobs"))
-	  papplPrinterSetMaxActiveJobs(printer, (int)strtol(value, NULL, 10));
-	else if (!strcasecmp(line, "MaxCompletedJobs"))
-	  papplPrinterSetMaxCompletedJobs(printer, (int)strtol(value, NULL, 10));
-	else if (!strcasecmp(line, "NextJobId"))
-	  papplPrinterSetNextJobID(printer, (int)strtol(value, NULL, 10));
-	else if (!strcasecmp(line, "ImpressionsCompleted"))
-	  papplPrinterSetImpressionsCompleted(printer, (int)strtol(value, NULL, 10));
-	else if (!strcasecmp(line, "identify-actions-default"))
-	  printer->driver_data.identify_default = _papplIdentifyActionsValue(value);
-	else if (!strcasecmp(line, "label-mode-configured"))
-	  printer->driver_data.mode_configured = _papplLabelModeValue(value);
-	else if (!strcasecmp(line, "label-tear-offset-configured"))
-	  printer->driver_data.tear_offset_configured = (int)strtol(value, NULL, 10);
-	else if (!strcasecmp(line, "media-col-default"))
-	  parse_media_col(value, &printer->driver_data.media_default);
-	else if (!strncasecmp(line, "media-col-ready", 15))
-	{
-	  if ((i = (int)strtol(line + 15, NULL, 10)) >= 0 && i < PAPPL_MAX_SOURCE)
-	    parse_media_col(value, printer->driver_data.media_ready + i);
-	}
-	else if (!strcasecmp(line, "orientation-requested-default"))
-	  printer->driver_data.orient_default = (ipp_orient_t)ippEnumValue("orientation-requested", value);
-	else if (!strcasecmp(line, "output-bin-default") && value)
-	{
-	  for (i = 0; i < printer->driver_data.num_bin; i ++)
-	  {
-	    if (!strcmp(value, printer->driver_data.bin[i]))
-	    {
-	      printer->driver_data.bin_default = i;
-	      break;
-	    }
-	  }
-	}
-	else if (!strcasecmp(line, "print-color-mode-default"))
-	  printer->driver_data.color_default = _papplColorModeValue(value);
-	else if (!strcasecmp(line, "print-content-optimize-default"))
-	  printer->driver_data.content_default = _papplContentValue(value);
-	else if (!strcasecmp(line, "print-darkness-default") && value)
-	  printer->driver_data.darkness_default = (int)strtol(value, NULL, 10);
-	else if (!strcasecmp(line, "print-quality-default"))
-	  printer->driver_data.quality_default = (ipp_quality_t)ippEnumValue("print-quality", value);
-	else if (!strcasecmp(line, "print-scaling-default"))
-	  printer->driver_data.scaling_default = _papplScalingValue(value);
-	else if (!strcasecmp(line, "print-speed-default") && value)
-	  printer->driver_data.speed_default = (int)strtol(value, NULL, 10);
-	else if (!strcasecmp(line, "printer-darkness-configured") && value)
-	  printer->driver_data.darkness_configured = (int)strtol(value, NULL, 10);
-	else if (!strcasecmp(line, "printer-resolution-default") && value)
-	  sscanf(value, "%dx%ddpi", &printer->driver_data.x_default, &printer->driver_data.y_default);
-	else if (!strcasecmp(line, "sides-default"))
-	  printer->driver_data.sides_default = _papplSidesValue(value);
-        else if ((ptr = strstr(line, "-default")) != NULL)
+        if (load.printers[i].printer_id == lp->printer_id || !strcmp(load.printers[i].name, lp->name))
         {
-          char	defname[128],		// xxx-default name
-	      	supname[128];		// xxx-supported name
-	  ipp_attribute_t *attr;	// Attribute
-
-          *ptr = '\0';
-
-          snprintf(defname, sizeof(defname), "%s-default", line);
-          snprintf(supname, sizeof(supname), "%s-supported", line);
-
-          if (!value)
-            value = ptr;
-
-	  ippDeleteAttribute(printer->driver_attrs, ippFindAttribute(printer->driver_attrs, defname, IPP_TAG_ZERO));
-
-          if ((attr = ippFindAttribute(printer->driver_attrs, supname, IPP_TAG_ZERO)) != NULL)
-          {
-            switch (ippGetValueTag(attr))
-            {
-              case IPP_TAG_BOOLEAN :
-                  ippAddBoolean(printer->driver_attrs, IPP_TAG_PRINTER, defname, !strcmp(value, "true"));
-                  break;
-
-              case IPP_TAG_INTEGER :
-              case IPP_TAG_RANGE :
-                  ippAddInteger(printer->driver_attrs, IPP_TAG_PRINTER, IPP_TAG_INTEGER, defname, (int)strtol(value, NULL, 10));
-                  break;
-
-              case IPP_TAG_KEYWORD :
-		  ippAddString(printer->driver_attrs, IPP_TAG_PRINTER, IPP_TAG_KEYWORD, defname, NULL, value);
-                  break;
-
-              default :
-                  break;
-            }
-	  }
-          else
-          {
-            ippAddString(printer->driver_attrs, IPP_TAG_PRINTER, IPP_TAG_TEXT, defname, NULL, value);
-          }
-        }
-	else if (!strcasecmp(line, "Job") && value)
-	{
-	  // Read printer job
-	  pappl_job_t	*job;		// Current Job
-	  struct stat	jobbuf;		// Job file buffer
-	  const char	*job_name,	// Job name
-			*job_id,	// Job ID
-			*job_username,	// Job username
-			*job_format,	// Job format
-			*job_value;	// Job option value
-
-	  num_options = cupsParseOptions(value, 0, &options);
-
-	  if ((job_id = cupsGetOption("id", num_options, options)) == NULL || strtol(job_id, NULL, 10) <= 0 || (job_name = cupsGetOption("name", num_options, options)) == NULL || (job_username = cupsGetOption("username", num_options, options)) == NULL || (job_format = cupsGetOption("format", num_options, options)) == NULL)
-	  {
-	    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Bad Job definition on line %d of '%s'.", linenum, filename);
-	    break;
-	  }
-
-	  if ((job = _papplJobCreate(printer, (int)strtol(job_id, NULL, 10), job_username, job_format, job_name, NULL)) == NULL)
-	  {
-	    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Error creating job %s for printer %s", job_name, printer->name);
-	    break;
-	  }
-
-	  if ((job_value = cupsGetOption("filename", num_options, options)) != NULL)
-	  {
-	    if ((job->filename = strdup(job_value)) == NULL)
-	    {
-	      papplLog(system, PAPPL_LOGLEVEL_ERROR, "Error creating job %s for printer %s", job_name, printer->name);
-	      break;
-	    }
-	  }
-
-	  if ((job_value = cupsGetOption("state", num_options, options)) != NULL)
-	    job->state = (ipp_jstate_t)strtol(job_value, NULL, 10);
-	  if ((job_value = cupsGetOption("state_reasons", num_options, options)) != NULL)
-	    job->state_reasons = (ipp_jstate_t)strtol(job_value, NULL, 10);
-	  if ((job_value = cupsGetOption("created", num_options, options)) != NULL)
-	    job->created = strtol(job_value, NULL, 10);
-	  if ((job_value = cupsGetOption("processing", num_options, options)) != NULL)
-	    job->processing = strtol(job_value, NULL, 10);
-	  if ((job_value = cupsGetOption("completed", num_options, options)) != NULL)
-	    job->completed = strtol(job_value, NULL, 10);
-	  if ((job_value = cupsGetOption("impressions", num_options, options)) != NULL)
-	    job->impressions = (int)strtol(job_value, NULL, 10);
-	  if ((job_value = cupsGetOption("imcompleted", num_options, options)) != NULL)
-	    job->impcompleted = (int)strtol(job_value, NULL, 10);
-
-	  // Add the job to printer completed jobs array...
-	  if (job->state < IPP_JSTATE_STOPPED)
-	  {
-	    // Load the file attributes from the spool directory...
-	    int		attr_fd;	// Attribute file descriptor
-	    char	job_attr_filename[256];
-					// Attribute filename
-
-	    if ((attr_fd = papplJobOpenFile(job, job_attr_filename, sizeof(job_attr_filename), system->directory, "ipp", "r")) < 0)
-	    {
-	      papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to open file for job attributes: '%s'.", job_attr_filename);
-	      continue;
-	    }
-
-	    ippReadFile(attr_fd, job->attrs);
-	    close(attr_fd);
-
-	    if (!job->filename || stat(job->filename, &jobbuf))
-	    {
-	      // If file removed, then set job state to aborted...
-	      job->state = IPP_JSTATE_ABORTED;
-	    }
-	    else
-	    {
-	      // Add the job to printer active jobs array...
-	      cupsArrayAdd(printer->active_jobs, job);
-	    }
-	  }
-	  else
-	  {
-	    // Add job to printer completed jobs...
-	    cupsArrayAdd(printer->completed_jobs, job);
-	  }
+          lp->error = EEXIST;
+          break;
 	}
-	else
-	  papplLog(system, PAPPL_LOGLEVEL_WARN, "Unknown printer directive '%s' on line %d of '%s'.", line, linenum, filename);
       }
-
-      // Loaded all printer attributes, call the status callback (if any) to
-      // update the current printer state...
-      if (printer && printer->driver_data.status_cb)
-        (printer->driver_data.status_cb)(printer);
+    }
+    else if (!strcasecmp(line, "Job") && value)
+    {
+      // Job records appended after the printers are applied last...
+      if (!add_line(&load.num_records, &load.alloc_records, &load.records, line, value, linenum))
+      {
+        papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to allocate memory for system state.");
+        ret = false;
+        break;
+      }
     }
     else
     {
@@ -365,7 +369,78 @@ papplSystemLoadState(
 
   cupsFileClose(fp);
 
-  return (true);
+  if (ret && load.num_printers > 0)
+  {
+    // Create the printers and load their values and job history in parallel,
+    // since the driver callbacks may need to query the printer and large job
+    // histories take a while to parse...
+    have_default = system->default_printer_id != 0;
+
+    if ((num_threads = load.num_printers) > _PAPPL_MAX_LOAD_THREADS)
+      num_threads = _PAPPL_MAX_LOAD_THREADS;
+
+    for (i = 1; i < num_threads; i ++)
+    {
+      if (pthread_create(tids + i, NULL, (void *(*)(void *))load_printers, &load))
+        break;
+    }
+
+    num_threads = i;
+
+    load_printers(&load);
+
+    for (i = 1; i < num_threads; i ++)
+      pthread_join(tids[i], NULL);
+
+    // Printers are added as they are created, so choose the default printer in
+    // file order rather than using whichever printer was created first...
+    if (!have_default)
+    {
+      for (i = 0; i < load.num_printers; i ++)
+      {
+        if (load.printers[i].printer)
+        {
+          papplSystemSetDefaultPrinterID(system, load.printers[i].printer->printer_id);
+          break;
+        }
+      }
+    }
+
+    // Then apply any job records appended to the state file, in order...
+    for (i = 0; i < load.num_records; i ++)
+      load_job(system, NULL, load.records[i].value, filename, load.records[i].linenum);
+
+    // Count the loaded jobs and clean out old jobs once the system is
+    // running...
+    for (i = 0; i < load.num_printers; i ++)
+    {
+      if ((printer = load.printers[i].printer) == NULL)
+        continue;
+
+      num_jobs += (size_t)printer->all_jobs.count;
+
+      if (printer->completed_jobs.count > 0 && !system->clean_time)
+        system->clean_time = time(NULL) + 60;
+    }
+  }
+
+  gettimeofday(&endtime, NULL);
+
+  papplLog(system, PAPPL_LOGLEVEL_INFO, "Loaded %u printer(s) and %u job(s) from '%s' in %.3f seconds.", (unsigned)load.num_printers, (unsigned)num_jobs, filename, endtime.tv_sec - starttime.tv_sec + 0.000001 * (endtime.tv_usec - starttime.tv_usec));
+
+  // Free memory and return...
+  for (i = 0; i < load.num_printers; i ++)
+  {
+    cupsFreeOptions(load.printers[i].num_options, load.printers[i].options);
+    free_lines(load.printers[i].num_lines, load.printers[i].lines);
+  }
+
+  free(load.printers);
+  free_lines(load.num_records, load.records);
+
+  pthread_mutex_destroy(&load.mutex);
+
+  return (ret);
 }
 
 
@@ -381,6 +456,10 @@ papplSystemLoadState(
 // |    (void *)filename);
 // ```
 //
+// When only jobs have changed since the file was last written, the changed
+// jobs are appended to the file.  Otherwise a new file is written and then
+// renamed over the old one so that the previous state is never lost.
+//
 
 bool					// O - `true` on success, `false` on failure
 papplSystemSaveState(
@@ -388,14 +467,77 @@ papplSystemSaveState(
     const char     *filename)		// I - File to save
 {
   int			i;		// Looping var
+  size_t		j,		// Looping var
+			num_journal;	// Number of journal entries
+  _pappl_journal_t	*journal;	// Journal entries
+  bool			append,		// Append to the existing state file?
+			ret;		// Return value
   cups_file_t		*fp;		// Output file
+  char			tempfile[1024];	// Temporary state file
   pappl_printer_t	*printer;	// Current printer
   pappl_job_t		*job;		// Current Job
 
 
-  if ((fp = cupsFileOpen(filename, "w")) == NULL)
+  // Take the pending journal entries...
+  pthread_rwlock_wrlock(&system->rwlock);
+
+  journal     = system->journal;
+  num_journal = system->num_journal;
+
+  system->journal       = NULL;
+  system->num_journal   = 0;
+  system->alloc_journal = 0;
+
+  for (j = 0; j < num_journal; j ++)
+    journal[j].job->is_journaled = false;
+
+  // If only jobs have changed since the state file was last written, append
+  // the changed jobs to it.  Otherwise write a new state file, which also
+  // compacts any previously appended job records...
+  append = system->state_file && !strcmp(system->state_file, filename) && (system->config_changes - system->journal_changes) == system->state_changes && (system->journal_records + num_journal) <= _PAPPL_MAX_JOURNAL;
+
+  if (append)
+  {
+    system->journal_records += num_journal;
+  }
+  else
+  {
+    free(system->state_file);
+
+    system->state_file      = NULL;
+    system->state_changes   = system->config_changes - system->journal_changes;
+    system->journal_records = 0;
+  }
+
+  pthread_rwlock_unlock(&system->rwlock);
+
+  ret = !append || append_journal(system, filename, journal, num_journal);
+
+  for (j = 0; j < num_journal; j ++)
+    _papplJobRelease(journal[j].job);
+
+  free(journal);
+
+  if (append)
   {
-    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to create system state file '%s': %s", filename, cupsLastErrorString());
+    if (!ret)
+    {
+      // Write a new state file next time...
+      pthread_rwlock_wrlock(&system->rwlock);
+      free(system->state_file);
+      system->state_file = NULL;
+      pthread_rwlock_unlock(&system->rwlock);
+    }
+
+    return (ret);
+  }
+
+  // Write a new state file, which includes any journaled jobs...
+  snprintf(tempfile, sizeof(tempfile), "%s.N", filename);
+
+  if ((fp = cupsFileOpen(tempfile, "w")) == NULL)
+  {
+    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to create system state file '%s': %s", tempfile, cupsLastErrorString());
     return (false);
   }
 
@@ -429,8 +571,15 @@ papplSystemSaveState(
     int			num_options = 0;// Number of options
     cups_option_t	*options = NULL;// Options
 
+    // Lock the printer so that its settings and job history don't change
+    // while they are written...
+    pthread_rwlock_rdlock(&printer->rwlock);
+
     if (printer->is_deleted)
+    {
+      pthread_rwlock_unlock(&printer->rwlock);
       continue;
+    }
 
     num_options = cupsAddIntegerOption("id", printer->printer_id, num_options, &options);
     num_options = cupsAddOption("name", printer->name, num_options, &options);
@@ -505,76 +654,591 @@ papplSystemSaveState(
 	      	defvalue[1024];		// xxx-default value
 
       snprintf(defname, sizeof(defname), "%s-default", printer->driver_data.vendor[i]);
-      ippAttributeString(ippFindAttribute(printer->driver_attrs, defname, IPP_TAG_ZERO), defvalue, sizeof(defvalue));
+
+      // Use the current driver attributes, which the application may have
+      // changed, if they have been created...
+      pthread_mutex_lock(&printer->blob_mutex);
+      ippAttributeString(ippFindAttribute(printer->driver_attrs ? printer->driver_attrs : printer->driver_extra, defname, IPP_TAG_ZERO), defvalue, sizeof(defvalue));
+      pthread_mutex_unlock(&printer->blob_mutex);
 
       cupsFilePutConf(fp, defname, defvalue);
     }
 
-    for (job = (pappl_job_t *)cupsArrayFirst(printer->all_jobs); job; job = (pappl_job_t *)cupsArrayNext(printer->all_jobs))
-    {
-      // Add basic job attributes...
-      num_options = 0;
-      num_options = cupsAddIntegerOption("id", job->job_id, num_options, &options);
-      num_options = cupsAddOption("name", job->name, num_options, &options);
-      num_options = cupsAddOption("username", job->username, num_options, &options);
-      num_options = cupsAddOption("format", job->format, num_options, &options);
-
-      if (job->filename)
-        num_options = cupsAddOption("filename", job->filename, num_options, &options);
-      if (job->state)
-        num_options = cupsAddIntegerOption("state", (int)job->state, num_options, &options);
-      if (job->state_reasons)
-        num_options = cupsAddIntegerOption("state_reasons", (int)job->state_reasons, num_options, &options);
-      if (job->created)
-        num_options = cupsAddIntegerOption("created", (int)job->created, num_options, &options);
-      if (job->processing)
-        num_options = cupsAddIntegerOption("processing", (int)job->processing, num_options, &options);
-      if (job->completed)
-        num_options = cupsAddIntegerOption("completed", (int)job->completed, num_options, &options);
-      if (job->impressions)
-        num_options = cupsAddIntegerOption("impressions", job->impressions, num_options, &options);
-      if (job->impcompleted)
-        num_options = cupsAddIntegerOption("imcompleted", job->impcompleted, num_options, &options);
-
-      if (job->attrs)
-      {
-	int	attr_fd;		// Attribute file descriptor
-	char	job_attr_filename[1024];// Attribute filename
+    for (job = printer->all_jobs.first; job; job = job->all_next)
+      write_job(system, fp, job, 0);
 
-        // Save job attributes to file in spool directory...
-        if (job->state < IPP_JSTATE_STOPPED)
-        {
-          if ((attr_fd = papplJobOpenFile(job, job_attr_filename, sizeof(job_attr_filename), system->directory, "ipp", "w")) < 0)
-          {
-            papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to create file for job attributes: '%s'.", job_attr_filename);
-            continue;
-          }
-
-          ippWriteFile(attr_fd, job->attrs);
-          close(attr_fd);
-        }
-        else
-        {
-          // If job completed or aborted, remove job-attributes file...
-          papplJobOpenFile(job, job_attr_filename, sizeof(job_attr_filename), system->directory, "ipp", "x");
-        }
+    pthread_rwlock_unlock(&printer->rwlock);
+
+    cupsFilePuts(fp, "</Printer>\n");
+  }
+
+  pthread_rwlock_unlock(&system->rwlock);
+
+  // Make sure the new state file is on disk before replacing the old one...
+  cupsFileFlush(fp);
+  fsync(cupsFileNumber(fp));
+
+  system->save_bytes += (size_t)cupsFileTell(fp);
+
+  if (cupsFileClose(fp))
+  {
+    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to write system state file '%s': %s", tempfile, strerror(errno));
+    unlink(tempfile);
+    return (false);
+  }
+
+  if (rename(tempfile, filename))
+  {
+    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to replace system state file '%s': %s", filename, strerror(errno));
+    unlink(tempfile);
+    return (false);
+  }
+
+  pthread_rwlock_wrlock(&system->rwlock);
+  system->state_file = strdup(filename);
+  pthread_rwlock_unlock(&system->rwlock);
+
+  return (true);
+}
+
+
+//
+// 'add_line()' - Add a line to a list of state file lines.
+//
+
+static bool				// O  - `true` on success, `false` on error
+add_line(size_t             *num_lines,	// IO - Number of lines
+         size_t             *alloc_lines,
+					// IO - Allocated lines
+         _pappl_load_line_t **lines,	// IO - Lines
+         const char         *line,	// I  - Directive
+         const char         *value,	// I  - Value or `NULL`
+         int                linenum)	// I  - Line number
+{
+  _pappl_load_line_t	*l;		// New line
+  size_t		linelen = strlen(line) + 1,
+					// Length of directive
+			valuelen = value ? strlen(value) + 1 : 0;
+					// Length of value
+
+
+  if (*num_lines >= *alloc_lines)
+  {
+    size_t		alloc = *alloc_lines ? 2 * *alloc_lines : 32;
+					// New allocation
+
+    if ((l = realloc(*lines, alloc * sizeof(_pappl_load_line_t))) == NULL)
+      return (false);
+
+    *lines       = l;
+    *alloc_lines = alloc;
+  }
+
+  // Copy the directive and value into a single string buffer...
+  l = *lines + *num_lines;
+
+  if ((l->line = malloc(linelen + valuelen)) == NULL)
+    return (false);
+
+  memcpy(l->line, line, linelen);
+
+  if (value)
+  {
+    l->value = l->line + linelen;
+    memcpy(l->value, value, valuelen);
+  }
+  else
+    l->value = NULL;
+
+  l->linenum = linenum;
+
+  (*num_lines) ++;
+
+  return (true);
+}
+
+
+//
+// 'append_journal()' - Append changed jobs to the state file.
+//
+
+static bool				// O - `true` on success, `false` on failure
+append_journal(
+    pappl_system_t   *system,		// I - System
+    const char       *filename,		// I - State file
+    _pappl_journal_t *journal,		// I - Journal entries
+    size_t           num_journal)	// I - Number of journal entries
+{
+  size_t	i;			// Looping var
+  int		j,			// Looping var
+		count;			// Number of printers
+  pappl_printer_t *printer;		// Job's printer
+  cups_file_t	*fp;			// Output file
+  off_t		start;			// Starting offset in file
+  bool		ret;			// Return value
+
+
+  if (num_journal == 0)
+    return (true);
+
+  if ((fp = cupsFileOpen(filename, "a")) == NULL)
+  {
+    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to append to system state file '%s': %s", filename, cupsLastErrorString());
+    return (false);
+  }
+
+  papplLog(system, PAPPL_LOGLEVEL_DEBUG, "Appending %u job record(s) to '%s'.", (unsigned)num_journal, filename);
+
+  start = cupsFileTell(fp);
+
+  pthread_rwlock_rdlock(&system->rwlock);
+
+  for (i = 0; i < num_journal; i ++)
+  {
+    // Find the job's printer, which might have been deleted, and lock it while
+    // the job is written...
+    for (j = 0, count = cupsArrayCount(system->printers); j < count; j ++)
+    {
+      if ((printer = (pappl_printer_t *)cupsArrayIndex(system->printers, j)) == journal[i].job->printer)
+        break;
+    }
+
+    if (j >= count)
+      continue;
+
+    pthread_rwlock_rdlock(&printer->rwlock);
+    write_job(system, fp, journal[i].job, journal[i].printer_id);
+    pthread_rwlock_unlock(&printer->rwlock);
+  }
+
+  pthread_rwlock_unlock(&system->rwlock);
+
+  cupsFileFlush(fp);
+  fsync(cupsFileNumber(fp));
+
+  system->save_bytes += (size_t)(cupsFileTell(fp) - start);
+
+  if ((ret = !cupsFileClose(fp)) == false)
+    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to append to system state file '%s': %s", filename, strerror(errno));
+
+  return (ret);
+}
+
+
+//
+// 'free_lines()' - Free a list of state file lines.
+//
+
+static void
+free_lines(size_t             num_lines,// I - Number of lines
+           _pappl_load_line_t *lines)	// I - Lines
+{
+  size_t	i;			// Looping var
+
+
+  for (i = 0; i < num_lines; i ++)
+    free(lines[i].line);
+
+  free(lines);
+}
+
+
+//
+// 'load_job()' - Load a job from the state file.
+//
+// Jobs inside a printer definition are added to that printer.  Job records
+// that were appended to the state file ("printer" is `NULL`) name their
+// printer and replace any earlier record for the same job.
+//
+
+static bool				// O - `true` to continue, `false` on error
+load_job(pappl_system_t  *system,	// I - System
+         pappl_printer_t *printer,	// I - Printer or `NULL` for appended record
+         char            *value,	// I - Job options
+         const char      *filename,	// I - State file
+         int             linenum)	// I - Line number in state file
+{
+  bool		journal = !printer,	// Appended job record?
+		update = false,		// Updating an existing job?
+		attrs_loaded = false;	// Job attributes loaded from spool file?
+  int		num_options;		// Number of options
+  cups_option_t	*options = NULL;	// Options
+  pappl_job_t	*job = NULL;		// Current Job
+  struct stat	jobbuf;			// Job file buffer
+  ipp_jstate_t	old_state = IPP_JSTATE_PENDING;
+					// Previous job state
+  const char	*job_name,		// Job name
+		*job_id,		// Job ID
+		*job_username,		// Job username
+		*job_format,		// Job format
+		*job_value;		// Job option value
+
+
+  num_options = cupsParseOptions(value, 0, &options);
+
+  if ((job_id = cupsGetOption("id", num_options, options)) == NULL || strtol(job_id, NULL, 10) <= 0 || (job_name = cupsGetOption("name", num_options, options)) == NULL || (job_username = cupsGetOption("username", num_options, options)) == NULL || (job_format = cupsGetOption("format", num_options, options)) == NULL)
+  {
+    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Bad Job definition on line %d of '%s'.", linenum, filename);
+    cupsFreeOptions(num_options, options);
+    return (false);
+  }
+
+  if (journal)
+  {
+    // Find the printer, skipping records for printers that have been
+    // deleted...
+    if ((job_value = cupsGetOption("printer", num_options, options)) == NULL || (printer = papplSystemFindPrinter(system, NULL, (int)strtol(job_value, NULL, 10), NULL)) == NULL)
+    {
+      cupsFreeOptions(num_options, options);
+      return (true);
+    }
+
+    if ((job = papplPrinterFindJob(printer, (int)strtol(job_id, NULL, 10))) != NULL)
+    {
+      // Update an existing job, unless it has already stopped (e.g. it was
+      // aborted because its document file is missing)...
+      if ((old_state = job->state) >= IPP_JSTATE_STOPPED)
+      {
+        cupsFreeOptions(num_options, options);
+        return (true);
       }
 
-      write_options(fp, "Job", num_options, options);
+      update = true;
+
+      free(job->filename);
+      job->filename = NULL;
+    }
+    else if (strtol(job_id, NULL, 10) >= printer->next_job_id)
+    {
+      printer->next_job_id = (int)strtol(job_id, NULL, 10) + 1;
+    }
+  }
+
+  if (!job && (job = _papplJobCreate(printer, (int)strtol(job_id, NULL, 10), job_username, job_format, job_name, NULL)) == NULL)
+  {
+    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Error creating job %s for printer %s", job_name, printer->name);
+    cupsFreeOptions(num_options, options);
+    return (false);
+  }
+
+  if ((job_value = cupsGetOption("filename", num_options, options)) != NULL)
+  {
+    if ((job->filename = strdup(job_value)) == NULL)
+    {
+      papplLog(system, PAPPL_LOGLEVEL_ERROR, "Error creating job %s for printer %s", job_name, printer->name);
       cupsFreeOptions(num_options, options);
+      return (false);
     }
+  }
 
-    cupsFilePuts(fp, "</Printer>\n");
+  if ((job_value = cupsGetOption("state", num_options, options)) != NULL)
+    job->state = (ipp_jstate_t)strtol(job_value, NULL, 10);
+  if ((job_value = cupsGetOption("state_reasons", num_options, options)) != NULL)
+    job->state_reasons = (ipp_jstate_t)strtol(job_value, NULL, 10);
+  if ((job_value = cupsGetOption("created", num_options, options)) != NULL)
+    job->created = strtol(job_value, NULL, 10);
+  if ((job_value = cupsGetOption("processing", num_options, options)) != NULL)
+    job->processing = strtol(job_value, NULL, 10);
+  if ((job_value = cupsGetOption("completed", num_options, options)) != NULL)
+    job->completed = strtol(job_value, NULL, 10);
+  if ((job_value = cupsGetOption("impressions", num_options, options)) != NULL)
+    job->impressions = (int)strtol(job_value, NULL, 10);
+  if ((job_value = cupsGetOption("imcompleted", num_options, options)) != NULL)
+    job->impcompleted = (int)strtol(job_value, NULL, 10);
+
+  if (update)
+  {
+    // Move an updated job to the completed jobs list as needed...
+    if (job->state >= IPP_JSTATE_STOPPED)
+    {
+      _papplJobListRemove(&printer->active_jobs, job);
+      _papplJobListAdd(&printer->completed_jobs, job);
+
+      printer->impcompleted += job->impcompleted;
+    }
   }
+  else if (job->state < IPP_JSTATE_STOPPED)
+  {
+    // Load the file attributes from the spool directory...
+    int		attr_fd;		// Attribute file descriptor
+    char	job_attr_filename[256];	// Attribute filename
 
-  pthread_rwlock_unlock(&system->rwlock);
+    if ((attr_fd = papplJobOpenFile(job, job_attr_filename, sizeof(job_attr_filename), system->directory, "ipp", "r")) < 0)
+    {
+      papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to open file for job attributes: '%s'.", job_attr_filename);
+    }
+    else
+    {
+      ippReadFile(attr_fd, job->attrs);
+      close(attr_fd);
 
-  cupsFileClose(fp);
+      attrs_loaded = true;
+    }
+
+    if (!job->filename || stat(job->filename, &jobbuf))
+    {
+      // If file removed, then set job state to aborted...
+      job->state     = IPP_JSTATE_ABORTED;
+      job->completed = time(NULL);
+
+      _papplJobListAdd(&printer->completed_jobs, job);
+    }
+    else
+    {
+      // Add the job to printer active jobs array...
+      _papplJobListAdd(&printer->active_jobs, job);
+    }
+  }
+  else
+  {
+    // Add job to printer completed jobs...
+    _papplJobListAdd(&printer->completed_jobs, job);
+
+    // Jobs in appended records were completed after the printer's impression
+    // count was saved...
+    if (journal)
+      printer->impcompleted += job->impcompleted;
+  }
+
+  if (!update)
+  {
+    // The job format points into the options, so use the job's copy of the
+    // document format instead...
+    ipp_attribute_t	*attr;		// "document-format-xxx" attribute
+
+    if (((attr = ippFindAttribute(job->attrs, "document-format-detected", IPP_TAG_MIMETYPE)) == NULL || strcmp(ippGetString(attr, 0, NULL), job_format)) && ((attr = ippFindAttribute(job->attrs, "document-format-supplied", IPP_TAG_MIMETYPE)) == NULL || strcmp(ippGetString(attr, 0, NULL), job_format)))
+    {
+      ippDeleteAttribute(job->attrs, ippFindAttribute(job->attrs, "document-format-detected", IPP_TAG_MIMETYPE));
+      attr = ippAddString(job->attrs, IPP_TAG_JOB, IPP_TAG_MIMETYPE, "document-format-detected", NULL, job_format);
+
+      // The attributes no longer match the spool file...
+      attrs_loaded = false;
+    }
+
+    job->format = ippGetString(attr, 0, NULL);
+  }
+
+  // Only mark the attributes as saved once they are no longer changed...
+  if (attrs_loaded)
+    job->attrs_saved = true;
+
+  cupsFreeOptions(num_options, options);
 
   return (true);
 }
 
 
+//
+// 'load_printer()' - Apply the values and jobs for a printer.
+//
+
+static void
+load_printer(
+    pappl_system_t        *system,	// I - System
+    _pappl_load_printer_t *lp,		// I - Printer definition
+    const char            *filename)	// I - State file
+{
+  int			i;		// Looping var
+  size_t		j;		// Looping var
+  pappl_printer_t	*printer = lp->printer;
+					// Printer
+  int			linenum;	// Line number
+  char			*line,		// Directive
+			*ptr,		// Pointer into line/value
+			*value;		// Value
+
+
+  if (!printer)
+  {
+    if (lp->error == EEXIST)
+      papplLog(system, PAPPL_LOGLEVEL_ERROR, "Printer '%s' already exists, dropping duplicate printer and job history in state file.", lp->name);
+    else if (lp->error == EIO)
+      papplLog(system, PAPPL_LOGLEVEL_ERROR, "Dropping printer '%s' and its job history because the driver ('%s') is no longer supported.", lp->name, lp->driver_name);
+    else
+      papplLog(system, PAPPL_LOGLEVEL_ERROR, "Dropping printer '%s' and its job history because an error occurred: %s", lp->name, strerror(lp->error));
+
+    return;
+  }
+
+  for (j = 0; j < lp->num_lines; j ++)
+  {
+    line    = lp->lines[j].line;
+    value   = lp->lines[j].value;
+    linenum = lp->lines[j].linenum;
+
+    if (!strcasecmp(line, "DNSSDName"))
+      papplPrinterSetDNSSDName(printer, value);
+    else if (!strcasecmp(line, "Location"))
+      papplPrinterSetLocation(printer, value);
+    else if (!strcasecmp(line, "GeoLocation"))
+      papplPrinterSetGeoLocation(printer, value);
+    else if (!strcasecmp(line, "Organization"))
+      papplPrinterSetOrganization(printer, value);
+    else if (!strcasecmp(line, "OrganizationalUnit"))
+      papplPrinterSetOrganizationalUnit(printer, value);
+    else if (!strcasecmp(line, "Contact"))
+    {
+      pappl_contact_t       contact;// "printer-contact" value
+
+      parse_contact(value, &contact);
+      papplPrinterSetContact(printer, &contact);
+    }
+    else if (!strcasecmp(line, "PrintGroup"))
+      papplPrinterSetPrintGroup(printer, value);
+    else if (!strcasecmp(line, "MaxActiveJobs"))
+      papplPrinterSetMaxActiveJobs(printer, (int)strtol(value, NULL, 10));
+    else if (!strcasecmp(line, "MaxCompletedJobs"))
+      papplPrinterSetMaxCompletedJobs(printer, (int)strtol(value, NULL, 10));
+    else if (!strcasecmp(line, "NextJobId"))
+      papplPrinterSetNextJobID(printer, (int)strtol(value, NULL, 10));
+    else if (!strcasecmp(line, "ImpressionsCompleted"))
+      papplPrinterSetImpressionsCompleted(printer, (int)strtol(value, NULL, 10));
+    else if (!strcasecmp(line, "identify-actions-default"))
+      printer->driver_data.identify_default = _papplIdentifyActionsValue(value);
+    else if (!strcasecmp(line, "label-mode-configured"))
+      printer->driver_data.mode_configured = _papplLabelModeValue(value);
+    else if (!strcasecmp(line, "label-tear-offset-configured"))
+      printer->driver_data.tear_offset_configured = (int)strtol(value, NULL, 10);
+    else if (!strcasecmp(line, "media-col-default"))
+      parse_media_col(value, &printer->driver_data.media_default);
+    else if (!strncasecmp(line, "media-col-ready", 15))
+    {
+      if ((i = (int)strtol(line + 15, NULL, 10)) >= 0 && i < PAPPL_MAX_SOURCE)
+	parse_media_col(value, printer->driver_data.media_ready + i);
+    }
+    else if (!strcasecmp(line, "orientation-requested-default"))
+      printer->driver_data.orient_default = (ipp_orient_t)ippEnumValue("orientation-requested", value);
+    else if (!strcasecmp(line, "output-bin-default") && value)
+    {
+      for (i = 0; i < printer->driver_data.num_bin; i ++)
+      {
+	if (!strcmp(value, printer->driver_data.bin[i]))
+	{
+	  printer->driver_data.bin_default = i;
+	  break;
+	}
+      }
+    }
+    else if (!strcasecmp(line, "print-color-mode-default"))
+      printer->driver_data.color_default = _papplColorModeValue(value);
+    else if (!strcasecmp(line, "print-content-optimize-default"))
+      printer->driver_data.content_default = _papplContentValue(value);
+    else if (!strcasecmp(line, "print-darkness-default") && value)
+      printer->driver_data.darkness_default = (int)strtol(value, NULL, 10);
+    else if (!strcasecmp(line, "print-quality-default"))
+      printer->driver_data.quality_default = (ipp_quality_t)ippEnumValue("print-quality", value);
+    else if (!strcasecmp(line, "print-scaling-default"))
+      printer->driver_data.scaling_default = _papplScalingValue(value);
+    else if (!strcasecmp(line, "print-speed-default") && value)
+      printer->driver_data.speed_default = (int)strtol(value, NULL, 10);
+    else if (!strcasecmp(line, "printer-darkness-configured") && value)
+      printer->driver_data.darkness_configured = (int)strtol(value, NULL, 10);
+    else if (!strcasecmp(line, "printer-resolution-default") && value)
+      sscanf(value, "%dx%ddpi", &printer->driver_data.x_default, &printer->driver_data.y_default);
+    else if (!strcasecmp(line, "sides-default"))
+      printer->driver_data.sides_default = _papplSidesValue(value);
+    else if ((ptr = strstr(line, "-default")) != NULL)
+    {
+      char  defname[128],           // xxx-default name
+	    supname[128];           // xxx-supported name
+      ipp_attribute_t *attr;        // Attribute
+
+      *ptr = '\0';
+
+      snprintf(defname, sizeof(defname), "%s-default", line);
+      snprintf(supname, sizeof(supname), "%s-supported", line);
+
+      if (!value)
+	value = ptr;
+
+      if (!printer->driver_extra)
+        printer->driver_extra = ippNew();
+
+      ippDeleteAttribute(printer->driver_extra, ippFindAttribute(printer->driver_extra, defname, IPP_TAG_ZERO));
+
+      if ((attr = ippFindAttribute(printer->driver_extra, supname, IPP_TAG_ZERO)) != NULL)
+      {
+	switch (ippGetValueTag(attr))
+	{
+	  case IPP_TAG_BOOLEAN :
+	      ippAddBoolean(printer->driver_extra, IPP_TAG_PRINTER, defname, !strcmp(value, "true"));
+	      break;
+
+	  case IPP_TAG_INTEGER :
+	  case IPP_TAG_RANGE :
+	      ippAddInteger(printer->driver_extra, IPP_TAG_PRINTER, IPP_TAG_INTEGER, defname, (int)strtol(value, NULL, 10));
+	      break;
+
+	  case IPP_TAG_KEYWORD :
+	      ippAddString(printer->driver_extra, IPP_TAG_PRINTER, IPP_TAG_KEYWORD, defname, NULL, value);
+	      break;
+
+	  default :
+	      break;
+	}
+      }
+      else
+      {
+	ippAddString(printer->driver_extra, IPP_TAG_PRINTER, IPP_TAG_TEXT, defname, NULL, value);
+      }
+
+      _papplPrinterCopyDriverDefaultNoLock(printer, defname);
+    }
+    else if (!strcasecmp(line, "Job") && value)
+    {
+      // Read printer job
+      if (!load_job(system, printer, value, filename, linenum))
+	break;
+    }
+    else
+      papplLog(system, PAPPL_LOGLEVEL_WARN, "Unknown printer directive '%s' on line %d of '%s'.", line, linenum, filename);
+  }
+
+  // Re-encode the driver attributes with any vendor defaults when next used...
+  _papplPrinterFlushAttributes(printer, 0);
+
+  // Loaded all printer attributes, call the status callback (if any) to
+  // update the current printer state...
+  if (printer->driver_data.status_cb)
+    (printer->driver_data.status_cb)(printer);
+}
+
+
+//
+// 'load_printers()' - Create printers and load their values and jobs.
+//
+// This function is run by multiple threads, each creating and loading the next
+// available printer until all of the printers have been loaded.
+//
+
+static void *				// O - Thread exit status
+load_printers(_pappl_load_t *load)	// I - Loaded state
+{
+  _pappl_load_printer_t	*lp;		// Current printer definition
+
+
+  for (;;)
+  {
+    pthread_mutex_lock(&load->mutex);
+    if (load->next_printer < load->num_printers)
+      lp = load->printers + load->next_printer ++;
+    else
+      lp = NULL;
+    pthread_mutex_unlock(&load->mutex);
+
+    if (!lp)
+      break;
+
+    if (!lp->error && (lp->printer = papplPrinterCreate(load->system, lp->printer_id, lp->name, lp->driver_name, lp->device_id, lp->device_uri)) == NULL)
+      lp->error = errno;
+
+    load_printer(load->system, lp, load->filename);
+  }
+
+  return (NULL);
+}
+
+
 //
 // 'parse_contact()' - Parse a contact value.
 //
@@ -720,6 +1384,82 @@ write_contact(cups_file_t     *fp,	// I - File
 }
 
 
+//
+// 'write_job()' - Write a job record.
+//
+
+static void
+write_job(pappl_system_t *system,	// I - System
+          cups_file_t    *fp,		// I - File
+          pappl_job_t    *job,		// I - Job
+          int            printer_id)	// I - Printer ID for appended records or `0`
+{
+  int		num_options = 0;	// Number of options
+  cups_option_t	*options = NULL;	// Options
+
+
+  // Add basic job attributes...
+  if (printer_id)
+    num_options = cupsAddIntegerOption("printer", printer_id, num_options, &options);
+
+  num_options = cupsAddIntegerOption("id", job->job_id, num_options, &options);
+  num_options = cupsAddOption("name", job->name, num_options, &options);
+  num_options = cupsAddOption("username", job->username, num_options, &options);
+  num_options = cupsAddOption("format", job->format, num_options, &options);
+
+  if (job->filename)
+    num_options = cupsAddOption("filename", job->filename, num_options, &options);
+  if (job->state)
+    num_options = cupsAddIntegerOption("state", (int)job->state, num_options, &options);
+  if (job->state_reasons)
+    num_options = cupsAddIntegerOption("state_reasons", (int)job->state_reasons, num_options, &options);
+  if (job->created)
+    num_options = cupsAddIntegerOption("created", (int)job->created, num_options, &options);
+  if (job->processing)
+    num_options = cupsAddIntegerOption("processing", (int)job->processing, num_options, &options);
+  if (job->completed)
+    num_options = cupsAddIntegerOption("completed", (int)job->completed, num_options, &options);
+  if (job->impressions)
+    num_options = cupsAddIntegerOption("impressions", job->impressions, num_options, &options);
+  if (job->impcompleted)
+    num_options = cupsAddIntegerOption("imcompleted", job->impcompleted, num_options, &options);
+
+  if (job->attrs)
+  {
+    int		attr_fd;		// Attribute file descriptor
+    char	job_attr_filename[1024];// Attribute filename
+
+    // Save job attributes to file in spool directory, but only if they have
+    // changed since the last save...
+    if (job->state < IPP_JSTATE_STOPPED)
+    {
+      if (!job->attrs_saved)
+      {
+	if ((attr_fd = papplJobOpenFile(job, job_attr_filename, sizeof(job_attr_filename), system->directory, "ipp", "w")) < 0)
+	{
+	  papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to create file for job attributes: '%s'.", job_attr_filename);
+	  cupsFreeOptions(num_options, options);
+	  return;
+	}
+
+	ippWriteFile(attr_fd, job->attrs);
+	close(attr_fd);
+
+	job->attrs_saved = true;
+      }
+    }
+    else
+    {
+      // If job completed or aborted, remove job-attributes file...
+      papplJobOpenFile(job, job_attr_filename, sizeof(job_attr_filename), system->directory, "ipp", "x");
+    }
+  }
+
+  write_options(fp, "Job", num_options, options);
+  cupsFreeOptions(num_options, options);
+}
+
+
 //
 // 'write_media_col()' - Write a media-col value...
 //
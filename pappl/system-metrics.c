@@ -0,0 +1,531 @@
+//
+// System metrics functions for the Printer Application Framework
+//
+// Copyright © 2021 by Michael R Sweet.
+//
+// Licensed under Apache License v2.0.  See the file "LICENSE" for more
+// information.
+//
+
+//
+// Include necessary headers...
+//
+
+#include "pappl-private.h"
+
+
+//
+// Local constants...
+//
+
+#define _PAPPL_METRICS_MIN	0.0001	// Upper bound of first histogram bucket in seconds
+
+
+//
+// Local types...
+//
+
+typedef struct _pappl_metrics_s	// Snapshot of system metrics
+{
+  size_t		counters[_PAPPL_COUNTER_MAX];
+					// Counters
+  _pappl_histogram_t	timers[_PAPPL_TIMER_MAX],
+					// Timers
+			http_timers[_PAPPL_METRICS_HTTP],
+					// HTTP request timers
+			ipp_timers[_PAPPL_METRICS_IPP];
+					// IPP request timers
+  size_t		save_count,	// Number of state saves
+			save_msecs,	// Total time saving state
+			save_last_msecs,// Time of last save
+			save_bytes;	// Bytes written to state files
+  int			num_printers;	// Number of printers
+  time_t		start_time;	// Startup time
+} _pappl_metrics_t;
+
+
+//
+// Local globals...
+//
+
+static const struct
+{
+  const char	*name,			// Prometheus metric name
+		*help,			// Prometheus help text
+		*keyword;		// IPP member attribute name
+  double	scale;			// Scale for Prometheus value
+  size_t	divisor;		// Divisor for IPP value
+} pappl_counters[_PAPPL_COUNTER_MAX] =
+{					// Counter names
+  { "pappl_auth_cache_hits_total", "Authentications answered from the cache.", "auth-cache-hits", 1.0, 1 },
+  { "pappl_auth_cache_misses_total", "Authentications not found in the cache.", "auth-cache-misses", 1.0, 1 },
+  { "pappl_device_read_bytes_total", "Bytes read from devices.", "device-read-kbytes", 1.0, 1024 },
+  { "pappl_device_read_seconds_total", "Time spent reading from devices.", "device-read-msecs", 0.001, 1 },
+  { "pappl_device_read_requests_total", "Read requests sent to devices.", "device-read-requests", 1.0, 1 },
+  { "pappl_device_write_bytes_total", "Bytes written to devices.", "device-write-kbytes", 1.0, 1024 },
+  { "pappl_device_write_seconds_total", "Time spent writing to devices.", "device-write-msecs", 0.001, 1 },
+  { "pappl_device_write_requests_total", "Write requests sent to devices.", "device-write-requests", 1.0, 1 },
+  { "pappl_dnssd_registrations_total", "DNS-SD service registrations.", "dns-sd-registrations", 1.0, 1 },
+  { "pappl_dnssd_unchanged_total", "DNS-SD registrations skipped because nothing changed.", "dns-sd-unchanged", 1.0, 1 },
+  { "pappl_jobs_aborted_total", "Jobs aborted.", "jobs-aborted", 1.0, 1 },
+  { "pappl_jobs_canceled_total", "Jobs canceled.", "jobs-canceled", 1.0, 1 },
+  { "pappl_jobs_completed_total", "Jobs completed.", "jobs-completed", 1.0, 1 },
+  { "pappl_log_dropped_total", "Log messages that could not be written.", "log-dropped", 1.0, 1 },
+  { "pappl_spool_bytes_total", "Bytes written to spool files.", "spool-kbytes", 1.0, 1024 }
+};
+
+static const struct
+{
+  const char	*name,			// Prometheus metric name
+		*help,			// Prometheus help text
+		*keyword;		// IPP member attribute prefix
+} pappl_timers[_PAPPL_TIMER_MAX] =
+{					// Timer names
+  { "pappl_job_device_open_seconds", "Time to open the output device for a job.", "job-device-open" },
+  { "pappl_job_finish_seconds", "Time to finish a job after processing.", "job-finish" },
+  { "pappl_job_processing_seconds", "Time to filter or rasterize a job.", "job-processing" },
+  { "pappl_job_wait_seconds", "Time a job waits in the queue before processing.", "job-wait" }
+};
+
+static const char * const pappl_http_methods[_PAPPL_METRICS_HTTP] =
+{					// HTTP method names
+  "WAITING",
+  "OPTIONS",
+  "GET",
+  "GET_SEND",
+  "HEAD",
+  "POST",
+  "POST_RECV",
+  "POST_SEND",
+  "PUT",
+  "PUT_RECV",
+  "DELETE",
+  "TRACE",
+  "CONNECT",
+  "STATUS",
+  "UNKNOWN_METHOD",
+  "UNKNOWN_VERSION"
+};
+
+
+//
+// Local functions...
+//
+
+static void	add_histogram(_pappl_histogram_t *h, double secs);
+static void	copy_histogram(ipp_t *col, const char *keyword, _pappl_histogram_t *h);
+static void	copy_metrics(pappl_system_t *system, _pappl_metrics_t *m);
+static int	get_msecs(_pappl_histogram_t *h, double q);
+static void	merge_histogram(_pappl_histogram_t *dst, _pappl_histogram_t *src);
+static void	write_histogram(http_t *http, const char *name, const char *label, const char *value, _pappl_histogram_t *h);
+
+
+//
+// '_papplSystemAddMetricCount()' - Add to a metrics counter.
+//
+
+void
+_papplSystemAddMetricCount(
+    pappl_system_t   *system,		// I - System
+    _pappl_counter_t counter,		// I - Counter
+    size_t           value)		// I - Value to add
+{
+  if (!system || counter >= _PAPPL_COUNTER_MAX)
+    return;
+
+  pthread_mutex_lock(&system->metrics_mutex);
+  system->counters[counter] += value;
+  pthread_mutex_unlock(&system->metrics_mutex);
+}
+
+
+//
+// '_papplSystemAddMetricHTTP()' - Add the time for a HTTP request.
+//
+
+void
+_papplSystemAddMetricHTTP(
+    pappl_system_t *system,		// I - System
+    http_state_t   state,		// I - HTTP method/state
+    double         secs)		// I - Elapsed time in seconds
+{
+  if (!system || state <= HTTP_STATE_WAITING || state >= _PAPPL_METRICS_HTTP)
+    return;
+
+  pthread_mutex_lock(&system->metrics_mutex);
+  add_histogram(system->http_timers + state, secs);
+  pthread_mutex_unlock(&system->metrics_mutex);
+}
+
+
+//
+// '_papplSystemAddMetricIPP()' - Add the time for an IPP request.
+//
+// Standard operations (0x0001 to 0x007F) and CUPS operations (0x4000 to
+// 0x403F) are tracked individually, all others are counted as operation 0.
+//
+
+void
+_papplSystemAddMetricIPP(
+    pappl_system_t *system,		// I - System
+    ipp_op_t       op,			// I - IPP operation
+    double         secs)		// I - Elapsed time in seconds
+{
+  int	i;				// Timer index
+
+
+  if (!system)
+    return;
+
+  if (op > 0 && op < 0x80)
+    i = (int)op;
+  else if (op >= 0x4000 && op < 0x4040)
+    i = 0x80 + (int)op - 0x4000;
+  else
+    i = 0;
+
+  pthread_mutex_lock(&system->metrics_mutex);
+  add_histogram(system->ipp_timers + i, secs);
+  pthread_mutex_unlock(&system->metrics_mutex);
+}
+
+
+//
+// '_papplSystemAddMetricTime()' - Add the time for a metrics timer.
+//
+
+void
+_papplSystemAddMetricTime(
+    pappl_system_t *system,		// I - System
+    _pappl_timer_t timer,		// I - Timer
+    double         secs)		// I - Elapsed time in seconds
+{
+  if (!system || timer >= _PAPPL_TIMER_MAX)
+    return;
+
+  pthread_mutex_lock(&system->metrics_mutex);
+  add_histogram(system->timers + timer, secs);
+  pthread_mutex_unlock(&system->metrics_mutex);
+}
+
+
+//
+// '_papplSystemCopyMetrics()' - Copy the metrics to an IPP message.
+//
+// The metrics are added as the "smi2699-system-metrics-col" system attribute.
+// Byte counts are reported in kilobytes and times in milliseconds since IPP
+// integers are limited to 32 bits.
+//
+
+void
+_papplSystemCopyMetrics(
+    pappl_system_t *system,		// I - System
+    ipp_t          *ipp)		// I - IPP message
+{
+  _pappl_metrics_t	*m;		// Metrics snapshot
+  _pappl_histogram_t	all;		// Merged histogram
+  ipp_t			*col;		// Collection value
+  size_t		i,		// Looping var
+			value;		// Counter value
+
+
+  if ((m = (_pappl_metrics_t *)calloc(1, sizeof(_pappl_metrics_t))) == NULL)
+    return;
+
+  copy_metrics(system, m);
+
+  col = ippNew();
+
+  for (i = 0; i < _PAPPL_COUNTER_MAX; i ++)
+  {
+    if ((value = m->counters[i] / pappl_counters[i].divisor) > INT_MAX)
+      value = INT_MAX;
+
+    ippAddInteger(col, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, pappl_counters[i].keyword, (int)value);
+  }
+
+  memset(&all, 0, sizeof(all));
+  for (i = 0; i < _PAPPL_METRICS_HTTP; i ++)
+    merge_histogram(&all, m->http_timers + i);
+  copy_histogram(col, "http-requests", &all);
+
+  memset(&all, 0, sizeof(all));
+  for (i = 0; i < _PAPPL_METRICS_IPP; i ++)
+    merge_histogram(&all, m->ipp_timers + i);
+  copy_histogram(col, "ipp-requests", &all);
+
+  for (i = 0; i < _PAPPL_TIMER_MAX; i ++)
+    copy_histogram(col, pappl_timers[i].keyword, m->timers + i);
+
+  ippAddInteger(col, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, "state-saves", m->save_count > INT_MAX ? INT_MAX : (int)m->save_count);
+  ippAddInteger(col, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, "state-save-kbytes", m->save_bytes / 1024 > INT_MAX ? INT_MAX : (int)(m->save_bytes / 1024));
+  ippAddInteger(col, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, "state-save-msecs", m->save_msecs > INT_MAX ? INT_MAX : (int)m->save_msecs);
+  ippAddInteger(col, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, "state-save-last-msecs", m->save_last_msecs > INT_MAX ? INT_MAX : (int)m->save_last_msecs);
+
+  ippAddCollection(ipp, IPP_TAG_SYSTEM, "smi2699-system-metrics-col", col);
+  ippDelete(col);
+
+  free(m);
+}
+
+
+//
+// '_papplSystemWebMetrics()' - Show the system metrics in the Prometheus text format.
+//
+
+void
+_papplSystemWebMetrics(
+    pappl_client_t *client,		// I - Client
+    pappl_system_t *system)		// I - System
+{
+  _pappl_metrics_t	*m;		// Metrics snapshot
+  size_t		i;		// Looping var
+  char			value[256];	// Label value
+
+
+  if (client->operation != HTTP_STATE_GET)
+  {
+    papplClientRespond(client, HTTP_STATUS_BAD_REQUEST, NULL, NULL, 0, 0);
+    return;
+  }
+
+  if ((m = (_pappl_metrics_t *)calloc(1, sizeof(_pappl_metrics_t))) == NULL)
+  {
+    papplClientRespond(client, HTTP_STATUS_SERVER_ERROR, NULL, NULL, 0, 0);
+    return;
+  }
+
+  copy_metrics(system, m);
+
+  if (!papplClientRespond(client, HTTP_STATUS_OK, NULL, "text/plain; version=0.0.4", 0, 0))
+  {
+    free(m);
+    return;
+  }
+
+  // Gauges...
+  httpPrintf(client->http, "# HELP pappl_printers Number of printers.\n# TYPE pappl_printers gauge\npappl_printers %d\n", m->num_printers);
+  httpPrintf(client->http, "# HELP pappl_uptime_seconds Time since the system was created.\n# TYPE pappl_uptime_seconds gauge\npappl_uptime_seconds %ld\n", (long)(time(NULL) - m->start_time));
+
+  // Counters...
+  for (i = 0; i < _PAPPL_COUNTER_MAX; i ++)
+    httpPrintf(client->http, "# HELP %s %s\n# TYPE %s counter\n%s %.15g\n", pappl_counters[i].name, pappl_counters[i].help, pappl_counters[i].name, pappl_counters[i].name, pappl_counters[i].scale * m->counters[i]);
+
+  httpPrintf(client->http, "# HELP pappl_state_saves_total State file saves.\n# TYPE pappl_state_saves_total counter\npappl_state_saves_total %lu\n", (unsigned long)m->save_count);
+  httpPrintf(client->http, "# HELP pappl_state_save_bytes_total Bytes written to state files.\n# TYPE pappl_state_save_bytes_total counter\npappl_state_save_bytes_total %lu\n", (unsigned long)m->save_bytes);
+  httpPrintf(client->http, "# HELP pappl_state_save_seconds_total Time spent saving state.\n# TYPE pappl_state_save_seconds_total counter\npappl_state_save_seconds_total %.3f\n", 0.001 * m->save_msecs);
+  httpPrintf(client->http, "# HELP pappl_state_save_last_seconds Time spent in the last state save.\n# TYPE pappl_state_save_last_seconds gauge\npappl_state_save_last_seconds %.3f\n", 0.001 * m->save_last_msecs);
+
+  // Histograms...
+  httpPrintf(client->http, "# HELP pappl_http_request_duration_seconds Time to process HTTP requests.\n# TYPE pappl_http_request_duration_seconds histogram\n");
+  for (i = 0; i < _PAPPL_METRICS_HTTP; i ++)
+  {
+    if (m->http_timers[i].count)
+      write_histogram(client->http, "pappl_http_request_duration_seconds", "method", pappl_http_methods[i], m->http_timers + i);
+  }
+
+  httpPrintf(client->http, "# HELP pappl_ipp_request_duration_seconds Time to process IPP requests.\n# TYPE pappl_ipp_request_duration_seconds histogram\n");
+  for (i = 0; i < _PAPPL_METRICS_IPP; i ++)
+  {
+    if (!m->ipp_timers[i].count)
+      continue;
+
+    if (i == 0)
+      strlcpy(value, "unknown", sizeof(value));
+    else if (i < 0x80)
+      strlcpy(value, ippOpString((ipp_op_t)i), sizeof(value));
+    else
+      strlcpy(value, ippOpString((ipp_op_t)(0x4000 + i - 0x80)), sizeof(value));
+
+    write_histogram(client->http, "pappl_ipp_request_duration_seconds", "operation", value, m->ipp_timers + i);
+  }
+
+  for (i = 0; i < _PAPPL_TIMER_MAX; i ++)
+  {
+    httpPrintf(client->http, "# HELP %s %s\n# TYPE %s histogram\n", pappl_timers[i].name, pappl_timers[i].help, pappl_timers[i].name);
+    write_histogram(client->http, pappl_timers[i].name, NULL, NULL, m->timers + i);
+  }
+
+  httpWrite2(client->http, "", 0);
+
+  free(m);
+}
+
+
+//
+// 'add_histogram()' - Add a sample to a histogram.
+//
+
+static void
+add_histogram(_pappl_histogram_t *h,	// I - Histogram
+              double             secs)	// I - Sample in seconds
+{
+  int		i;			// Looping var
+  double	bound;			// Upper bound of bucket
+
+
+  if (secs < 0.0)
+    secs = 0.0;
+
+  for (i = 0, bound = _PAPPL_METRICS_MIN; i < _PAPPL_METRICS_BUCKETS && secs > bound; i ++, bound *= 2.0);
+
+  if (i < _PAPPL_METRICS_BUCKETS)
+    h->buckets[i] ++;
+
+  h->count ++;
+  h->sum += secs;
+}
+
+
+//
+// 'copy_histogram()' - Copy histogram counts and percentiles to a collection.
+//
+
+static void
+copy_histogram(ipp_t              *col,	// I - Collection
+               const char         *keyword,
+					// I - Member attribute prefix
+               _pappl_histogram_t *h)	// I - Histogram
+{
+  char	name[256];			// Member attribute name
+
+
+  snprintf(name, sizeof(name), "%s-count", keyword);
+  ippAddInteger(col, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, name, h->count > INT_MAX ? INT_MAX : (int)h->count);
+
+  snprintf(name, sizeof(name), "%s-msecs-p50", keyword);
+  ippAddInteger(col, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, name, get_msecs(h, 0.5));
+
+  snprintf(name, sizeof(name), "%s-msecs-p95", keyword);
+  ippAddInteger(col, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, name, get_msecs(h, 0.95));
+
+  snprintf(name, sizeof(name), "%s-msecs-p99", keyword);
+  ippAddInteger(col, IPP_TAG_SYSTEM, IPP_TAG_INTEGER, name, get_msecs(h, 0.99));
+}
+
+
+//
+// 'copy_metrics()' - Copy the current metrics.
+//
+
+static void
+copy_metrics(pappl_system_t   *system,	// I - System
+             _pappl_metrics_t *m)	// I - Metrics snapshot
+{
+  pthread_mutex_lock(&system->metrics_mutex);
+
+  memcpy(m->counters, system->counters, sizeof(m->counters));
+  memcpy(m->timers, system->timers, sizeof(m->timers));
+  memcpy(m->http_timers, system->http_timers, sizeof(m->http_timers));
+  memcpy(m->ipp_timers, system->ipp_timers, sizeof(m->ipp_timers));
+
+  pthread_mutex_unlock(&system->metrics_mutex);
+
+  pthread_rwlock_rdlock(&system->rwlock);
+
+  m->save_count      = system->save_count;
+  m->save_msecs      = system->save_msecs;
+  m->save_last_msecs = system->save_last_msecs;
+  m->save_bytes      = system->save_bytes;
+  m->num_printers    = cupsArrayCount(system->printers);
+  m->start_time      = system->start_time;
+
+  pthread_rwlock_unlock(&system->rwlock);
+}
+
+
+//
+// 'get_msecs()' - Get an approximate percentile from a histogram.
+//
+// The upper bound of the bucket containing the percentile is returned.
+//
+
+static int				// O - Time in milliseconds
+get_msecs(_pappl_histogram_t *h,	// I - Histogram
+          double             q)		// I - Quantile (0.0 to 1.0)
+{
+  int		i;			// Looping var
+  size_t	count = 0,		// Cumulative count
+		target;			// Target count
+  double	bound;			// Upper bound of bucket
+
+
+  if (!h->count)
+    return (0);
+
+  if ((target = (size_t)(q * h->count + 0.5)) < 1)
+    target = 1;
+
+  for (i = 0, bound = _PAPPL_METRICS_MIN; i < _PAPPL_METRICS_BUCKETS; i ++, bound *= 2.0)
+  {
+    if ((count += h->buckets[i]) >= target)
+      break;
+  }
+
+  if (bound * 1000.0 > INT_MAX)
+    return (INT_MAX);
+  else
+    return ((int)(bound * 1000.0 + 0.5));
+}
+
+
+//
+// 'merge_histogram()' - Add the samples from one histogram to another.
+//
+
+static void
+merge_histogram(
+    _pappl_histogram_t *dst,		// I - Destination histogram
+    _pappl_histogram_t *src)		// I - Source histogram
+{
+  int	i;				// Looping var
+
+
+  for (i = 0; i < _PAPPL_METRICS_BUCKETS; i ++)
+    dst->buckets[i] += src->buckets[i];
+
+  dst->count += src->count;
+  dst->sum   += src->sum;
+}
+
+
+//
+// 'write_histogram()' - Write a histogram in the Prometheus text format.
+//
+
+static void
+write_histogram(
+    http_t             *http,		// I - HTTP connection
+    const char         *name,		// I - Metric name
+    const char         *label,		// I - Label name or `NULL` for none
+    const char         *value,		// I - Label value or `NULL` for none
+    _pappl_histogram_t *h)		// I - Histogram
+{
+  int		i;			// Looping var
+  size_t	count = 0;		// Cumulative count
+  double	bound;			// Upper bound of bucket
+  char		labels[256],		// Labels for buckets
+		suffix[256];		// Labels for sum and count
+
+
+  if (label && value)
+  {
+    snprintf(labels, sizeof(labels), "%s=\"%s\",", label, value);
+    snprintf(suffix, sizeof(suffix), "{%s=\"%s\"}", label, value);
+  }
+  else
+  {
+    labels[0] = '\0';
+    suffix[0] = '\0';
+  }
+
+  for (i = 0, bound = _PAPPL_METRICS_MIN; i < _PAPPL_METRICS_BUCKETS; i ++, bound *= 2.0)
+  {
+    count += h->buckets[i];
+    httpPrintf(http, "%s_bucket{%sle=\"%g\"} %lu\n", name, labels, bound, (unsigned long)count);
+  }
+
+  httpPrintf(http, "%s_bucket{%sle=\"+Inf\"} %lu\n", name, labels, (unsigned long)h->count);
+  httpPrintf(http, "%s_sum%s %.6f\n", name, suffix, h->sum);
+  httpPrintf(http, "%s_count%s %lu\n", name, suffix, (unsigned long)h->count);
+}
@@ -24,19 +24,69 @@
 // Constants...
 //
 
+#  define _PAPPL_MAX_AUTH_CACHE	64	// Maximum number of cached authentications
+#  define _PAPPL_MAX_FILTER_HASH	64	// Number of MIME filter hash buckets
 #  define _PAPPL_MAX_LISTENERS	32	// Maximum number of listener sockets
+#  define _PAPPL_LOG_INDEX_BYTES	65536	// Minimum bytes between log line index entries
+#  define _PAPPL_METRICS_BUCKETS	24	// Number of latency histogram buckets (100us * 2^n)
+#  define _PAPPL_METRICS_HTTP	16	// Number of HTTP methods tracked
+#  define _PAPPL_METRICS_IPP	192	// Number of IPP operations tracked (0x00-0x7F, 0x4000-0x403F)
 
 
 //
 // Types and structures...
 //
 
+typedef enum _pappl_counter_e		// Metrics counters
+{
+  _PAPPL_COUNTER_AUTH_CACHE_HITS,		// Cached authentications used
+  _PAPPL_COUNTER_AUTH_CACHE_MISSES,		// Authentications not in cache
+  _PAPPL_COUNTER_DEVICE_READ_BYTES,		// Bytes read from devices
+  _PAPPL_COUNTER_DEVICE_READ_MSECS,		// Milliseconds reading from devices
+  _PAPPL_COUNTER_DEVICE_READ_REQUESTS,		// Read requests to devices
+  _PAPPL_COUNTER_DEVICE_WRITE_BYTES,		// Bytes written to devices
+  _PAPPL_COUNTER_DEVICE_WRITE_MSECS,		// Milliseconds writing to devices
+  _PAPPL_COUNTER_DEVICE_WRITE_REQUESTS,		// Write requests to devices
+  _PAPPL_COUNTER_DNSSD_REGISTRATIONS,		// DNS-SD registrations
+  _PAPPL_COUNTER_DNSSD_UNCHANGED,		// DNS-SD registrations skipped as unchanged
+  _PAPPL_COUNTER_JOBS_ABORTED,			// Jobs aborted
+  _PAPPL_COUNTER_JOBS_CANCELED,			// Jobs canceled
+  _PAPPL_COUNTER_JOBS_COMPLETED,		// Jobs completed
+  _PAPPL_COUNTER_LOG_DROPS,			// Log messages not written
+  _PAPPL_COUNTER_SPOOL_BYTES,			// Bytes written to spool files
+  _PAPPL_COUNTER_MAX				// Number of counters
+} _pappl_counter_t;
+
+typedef enum _pappl_timer_e		// Metrics timers
+{
+  _PAPPL_TIMER_JOB_DEVICE,			// Job device open time
+  _PAPPL_TIMER_JOB_FINISH,			// Job finish time
+  _PAPPL_TIMER_JOB_PROCESS,			// Job filter/raster processing time
+  _PAPPL_TIMER_JOB_WAIT,			// Job queue wait time
+  _PAPPL_TIMER_MAX				// Number of timers
+} _pappl_timer_t;
+
+typedef struct _pappl_auth_cache_s	// Cached authentication result
+{
+  char			username[256];		// Username
+  unsigned char		hash[32];		// Hash of credentials and client
+  http_status_t		status;			// Authorization status
+  time_t		expires;		// Expiration time
+} _pappl_auth_cache_t;
+
+typedef struct _pappl_logline_s		// Log line index entry
+{
+  off_t			offset;			// Offset of line in log file
+  size_t		line;			// Line number (0-based)
+} _pappl_logline_t;
+
 typedef struct _pappl_mime_filter_s	// MIME filter
 {
   const char		*src,			// Source MIME media type
 			*dst;			// Destination MIME media type
   pappl_mime_filter_cb_t cb;			// Filter callback function
   void			*cbdata;		// Filter callback data
+  struct _pappl_mime_filter_s *hash_next;	// Next filter in hash bucket
 } _pappl_mime_filter_t;
 
 typedef struct _pappl_resource_s	// Resource
@@ -50,8 +100,27 @@ typedef struct _pappl_resource_s	// Resource
   size_t		length;			// Length of file/data
   pappl_resource_cb_t	cb;			// Dynamic callback
   void			*cbdata;		// Callback data
+  pthread_mutex_t	cache_mutex;		// Mutex for cached file data
+  bool			cache_loaded;		// Have we tried to cache the file?
+  void			*cache;			// Cached file data, if any
+  unsigned		hash;			// Hash of path
+  struct _pappl_resource_s *hash_next;		// Next resource in hash bucket
 } _pappl_resource_t;
 
+typedef struct _pappl_histogram_s	// Latency histogram
+{
+  size_t		count;			// Number of samples
+  double		sum;			// Sum of samples in seconds
+  size_t		buckets[_PAPPL_METRICS_BUCKETS];
+						// Samples per bucket
+} _pappl_histogram_t;
+
+typedef struct _pappl_journal_s		// State journal entry
+{
+  pappl_job_t		*job;			// Changed job (retained)
+  int			printer_id;		// ID of job's printer
+} _pappl_journal_t;
+
 struct _pappl_system_s			// System data
 {
   pthread_rwlock_t	rwlock;			// Reader/writer lock
@@ -62,7 +131,14 @@ struct _pappl_system_s			// System data
 			clean_time,		// Next clean time
 			shutdown_time;		// Shutdown requested?
   size_t		config_changes,		// Number of configuration changes
-			save_changes;		// Number of saved changes
+			save_changes,		// Number of saved changes
+			journal_changes,	// Number of journaled changes
+			state_changes;		// Non-journaled changes at last full save
+  char			*state_file;		// Last fully written state file
+  size_t		num_journal,		// Number of journal entries
+			alloc_journal,		// Allocated journal entries
+			journal_records;	// Journal records appended to state file
+  _pappl_journal_t	*journal;		// Jobs changed since last save
   char			*uuid,			// "system-uuid" value
 			*name,			// "system-name" value
 			*dns_sd_name,		// "system-dns-sd-name" value
@@ -82,21 +158,39 @@ struct _pappl_system_s			// System data
   int			logfd;			// Log file descriptor, if any
   pappl_loglevel_t	loglevel;		// Log level
   size_t		logmaxsize;		// Maximum log file size or `0` for none
+  pthread_mutex_t	logindex_mutex;		// Mutex for log line index
+  ino_t			logindex_ino;		// Inode of indexed log file
+  off_t			logindex_size;		// Number of bytes indexed
+  size_t		logindex_lines,		// Number of lines indexed
+			num_logindex,		// Number of line index entries
+			alloc_logindex;		// Allocated line index entries
+  _pappl_logline_t	*logindex;		// Line index entries
   char			*subtypes;		// DNS-SD sub-types, if any
   bool			tls_only;		// Only support TLS?
   char			*auth_service;		// PAM authorization service, if any
   char			*admin_group;		// PAM administrative group, if any
   gid_t			admin_gid;		// PAM administrative group ID
+  pthread_mutex_t	auth_mutex;		// Mutex for authentication cache
+  int			auth_cache_time;	// Seconds to cache authentications
+  size_t		num_auth_cache;		// Number of cached authentications
+  _pappl_auth_cache_t	auth_cache[_PAPPL_MAX_AUTH_CACHE];
+						// Cached authentications
   char			*default_print_group;	// Default PAM printing group, if any
   char			session_key[65];	// Session key
   pthread_rwlock_t	session_rwlock;		// Reader/writer lock for the session key
   time_t		session_time;		// Session key time
+  size_t		session_epoch;		// Session key generation
+  char			session_auth[65];	// Authorization cookie for session key, if computed
   int			num_listeners;		// Number of listener sockets
   struct pollfd		listeners[_PAPPL_MAX_LISTENERS];
 						// Listener sockets
   cups_array_t		*links;			// Web navigation links
   cups_array_t		*resources;		// Array of resources
+  _pappl_resource_t	**resource_hash;	// Hash table of resources by path
+  size_t		resource_hash_size;	// Size of resource hash table
   cups_array_t		*filters;		// Array of filters
+  _pappl_mime_filter_t	*filter_hash[_PAPPL_MAX_FILTER_HASH];
+						// Hash table of filters by type
   int			next_client;		// Next client number
   cups_array_t		*printers;		// Array of printers
   int			default_printer_id,	// Default printer-id
@@ -109,12 +203,19 @@ struct _pappl_system_s			// System data
   pappl_pr_driver_cb_t	driver_cb;		// Printer driver initialization callback
   void			*driver_cbdata;		// Printer driver callback data
   ipp_t			*attrs;			// Static attributes for system
+  _pappl_blob_t		*attrs_blob;		// Pre-encoded static attributes
   pappl_mime_cb_t	mime_cb;		// MIME typing callback
   void			*mime_cbdata;		// MIME typing callback data
   pappl_ipp_op_cb_t	op_cb;			// IPP operation callback
   void			*op_cbdata;		// IPP operation callback data
   pappl_save_cb_t	save_cb;		// Save callback
   void			*save_cbdata;		// Save callback data
+  int			save_delay,		// Seconds without changes before saving
+			save_max_delay;		// Maximum seconds to delay a save
+  size_t		save_count,		// Number of saves
+			save_msecs,		// Total time spent saving in milliseconds
+			save_last_msecs,	// Time spent in last save in milliseconds
+			save_bytes;		// Number of bytes written to state files
 #  ifdef HAVE_DNSSD
   _pappl_srv_t		dns_sd_ipps_ref,	// DNS-SD IPPS service
 			dns_sd_http_ref;	// DNS-SD HTTP service
@@ -127,6 +228,21 @@ struct _pappl_system_s			// System data
   bool			dns_sd_collision;	// Was there a name collision for this system?
   int			dns_sd_serial;		// DNS-SD serial number (for collisions)
   int			dns_sd_host_changes;	// Last count of DNS-SD host name changes
+  pthread_mutex_t	dns_sd_mutex;		// Mutex for DNS-SD worker
+  pthread_cond_t	dns_sd_cond;		// Condition for DNS-SD worker
+  pthread_t		dns_sd_thread;		// DNS-SD worker thread
+  bool			dns_sd_worker,		// Is the DNS-SD worker running?
+			dns_sd_stop;		// Stop the DNS-SD worker?
+  size_t		dns_sd_changes;		// Number of queued DNS-SD changes
+  pthread_mutex_t	metrics_mutex;		// Mutex for metrics
+  size_t		counters[_PAPPL_COUNTER_MAX];
+						// Metrics counters
+  _pappl_histogram_t	timers[_PAPPL_TIMER_MAX],
+						// Metrics timers
+			http_timers[_PAPPL_METRICS_HTTP],
+						// HTTP request timers by method
+			ipp_timers[_PAPPL_METRICS_IPP];
+						// IPP request timers by operation
 };
 
 
@@ -134,16 +250,28 @@ struct _pappl_system_s			// System data
 // Functions...
 //
 
+extern bool		_papplSystemAddListenerFd(pappl_system_t *system, int fd, const char *name) _PAPPL_PRIVATE;
+extern void		_papplSystemAddMetricCount(pappl_system_t *system, _pappl_counter_t counter, size_t value) _PAPPL_PRIVATE;
+extern void		_papplSystemAddMetricHTTP(pappl_system_t *system, http_state_t state, double secs) _PAPPL_PRIVATE;
+extern void		_papplSystemAddMetricIPP(pappl_system_t *system, ipp_op_t op, double secs) _PAPPL_PRIVATE;
+extern void		_papplSystemAddMetricTime(pappl_system_t *system, _pappl_timer_t timer, double secs) _PAPPL_PRIVATE;
 extern void		_papplSystemAddPrinter(pappl_system_t *system, pappl_printer_t *printer, int printer_id) _PAPPL_PRIVATE;
 extern void		_papplSystemAddPrinterIcons(pappl_system_t *system, pappl_printer_t *printer) _PAPPL_PRIVATE;
+extern const void	*_papplSystemCacheResource(pappl_system_t *system, _pappl_resource_t *r, size_t *length) _PAPPL_PRIVATE;
 extern void		_papplSystemCleanJobs(pappl_system_t *system) _PAPPL_PRIVATE;
+extern void		_papplSystemClearJournal(pappl_system_t *system) _PAPPL_PRIVATE;
 extern void		_papplSystemConfigChanged(pappl_system_t *system) _PAPPL_PRIVATE;
-extern void		_papplSystemExportVersions(pappl_system_t *system, ipp_t *ipp, ipp_tag_t group_tag, cups_array_t *ra);
+extern void		_papplSystemCopyMetrics(pappl_system_t *system, ipp_t *ipp) _PAPPL_PRIVATE;
+extern void		_papplSystemExportVersions(pappl_system_t *system, ipp_t *ipp, ipp_tag_t group_tag, _pappl_ra_t *ra);
 extern _pappl_mime_filter_t *_papplSystemFindMIMEFilter(pappl_system_t *system, const char *srctype, const char *dsttype) _PAPPL_PRIVATE;
 extern _pappl_resource_t *_papplSystemFindResource(pappl_system_t *system, const char *path) _PAPPL_PRIVATE;
+extern char		*_papplSystemGetAuthCookie(pappl_system_t *system, char *buffer, size_t bufsize) _PAPPL_PRIVATE;
+extern size_t		_papplSystemGetSessionEpoch(pappl_system_t *system) _PAPPL_PRIVATE;
 extern char		*_papplSystemMakeUUID(pappl_system_t *system, const char *printer_name, int job_id, char *buffer, size_t bufsize) _PAPPL_PRIVATE;
 extern void		_papplSystemProcessIPP(pappl_client_t *client) _PAPPL_PRIVATE;
+extern void		_papplSystemJournalJob(pappl_system_t *system, pappl_job_t *job) _PAPPL_PRIVATE;
 extern bool		_papplSystemRegisterDNSSDNoLock(pappl_system_t *system) _PAPPL_PRIVATE;
+extern void		*_papplSystemRunDNSSD(pappl_system_t *system) _PAPPL_PRIVATE;
 extern void		_papplSystemUnregisterDNSSDNoLock(pappl_system_t *system) _PAPPL_PRIVATE;
 
 extern void		_papplSystemWebAddPrinter(pappl_client_t *client, pappl_system_t *system) _PAPPL_PRIVATE;
@@ -152,6 +280,7 @@ extern void		_papplSystemWebConfigFinalize(pappl_system_t *system, int num_form,
 extern void		_papplSystemWebHome(pappl_client_t *client, pappl_system_t *system) _PAPPL_PRIVATE;
 extern void		_papplSystemWebLogFile(pappl_client_t *client, pappl_system_t *system) _PAPPL_PRIVATE;
 extern void		_papplSystemWebLogs(pappl_client_t *client, pappl_system_t *system) _PAPPL_PRIVATE;
+extern void		_papplSystemWebMetrics(pappl_client_t *client, pappl_system_t *system) _PAPPL_PRIVATE;
 extern void		_papplSystemWebNetwork(pappl_client_t *client, pappl_system_t *system) _PAPPL_PRIVATE;
 extern void		_papplSystemWebSecurity(pappl_client_t *client, pappl_system_t *system) _PAPPL_PRIVATE;
 extern void		_papplSystemWebSettings(pappl_client_t *client) _PAPPL_PRIVATE;
@@ -678,7 +678,131 @@ _papplSystemWebLogFile(
   if (!papplClientHTMLAuthorize(client))
     return;
 
-  if (client->operation == HTTP_STATE_GET)
+  if (client->operation == HTTP_STATE_GET && client->options)
+  {
+    // Return filtered lines using the log tail query options...
+    int			num_form;	// Number of form variables
+    cups_option_t	*form = NULL;	// Form variables
+    const char		*value;		// Form value
+    _pappl_logfilter_t	filter;		// Log filter
+    char		*text,		// Log text
+			range[256],	// Content-Range value
+			link[1024],	// Link value
+			*linkptr;	// Pointer into Link value
+    const char		*query,		// Pointer into query string
+			*qend;		// End of query parameter
+    http_status_t	code;		// HTTP status of response
+    off_t		start,		// Start of log data
+			next,		// Next log offset
+			size;		// Size of log file
+    size_t		length;		// Length of log text
+
+    num_form = papplClientGetForm(client, &form);
+
+    memset(&filter, 0, sizeof(filter));
+
+    filter.offset   = (value = cupsGetOption("offset", num_form, form)) != NULL ? (off_t)strtoll(value, NULL, 10) : -1;
+    filter.lines    = (value = cupsGetOption("lines", num_form, form)) != NULL ? (size_t)strtoul(value, NULL, 10) : 1000;
+    filter.maxbytes = (value = cupsGetOption("max", num_form, form)) != NULL ? (size_t)strtoul(value, NULL, 10) : 65536;
+    filter.level    = PAPPL_LOGLEVEL_UNSPEC;
+    filter.printer  = cupsGetOption("printer", num_form, form);
+    filter.job_id   = (value = cupsGetOption("job", num_form, form)) != NULL ? atoi(value) : 0;
+
+    if (filter.maxbytes < 1024)
+      filter.maxbytes = 1024;
+    else if (filter.maxbytes > 1048576)
+      filter.maxbytes = 1048576;
+
+    if ((value = cupsGetOption("level", num_form, form)) != NULL && *value)
+    {
+      // Level is the first letter of "debug", "info", "warn", "error", or "fatal"...
+      const char *levels = "diwef", *level = strchr(levels, tolower(*value & 255));
+
+      if (level)
+        filter.level = (pappl_loglevel_t)(level - levels);
+    }
+
+    if (filter.job_id > 0 && !filter.printer)
+    {
+      // Job IDs are only unique for a printer...
+      cupsFreeOptions(num_form, form);
+      papplClientRespond(client, HTTP_STATUS_BAD_REQUEST, NULL, NULL, 0, 0);
+      return;
+    }
+
+    text = _papplLogCopyTail(system, &filter, &start, &next, &size);
+
+    cupsFreeOptions(num_form, form);
+
+    if (!text)
+    {
+      papplLogClient(client, PAPPL_LOGLEVEL_ERROR, "Unable to read log file '%s': %s", system->logfile, strerror(errno));
+      papplClientRespond(client, HTTP_STATUS_SERVER_ERROR, NULL, NULL, 0, 0);
+      return;
+    }
+
+    if (next == start)
+    {
+      // Nothing new...
+      papplClientRespond(client, HTTP_STATUS_NO_CONTENT, NULL, NULL, 0, 0);
+      free(text);
+      return;
+    }
+
+    // The Link header provides the request for the following lines, which
+    // repeats the filter parameters with the next offset...
+    snprintf(link, sizeof(link), "</logfile.txt?offset=%ld", (long)next);
+    linkptr = link + strlen(link);
+
+    for (query = client->options; *query; query = *qend ? qend + 1 : qend)
+    {
+      if ((qend = strchr(query, '&')) == NULL)
+        qend = query + strlen(query);
+
+      if (!strncmp(query, "offset=", 7) || !strncmp(query, "lines=", 6) || (size_t)(qend - query) >= (sizeof(link) - 16 - (size_t)(linkptr - link)) || strspn(query, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789%+-._~=") < (size_t)(qend - query))
+        continue;
+
+      *linkptr++ = '&';
+      memcpy(linkptr, query, (size_t)(qend - query));
+      linkptr += qend - query;
+    }
+
+    strlcpy(linkptr, ">; rel=\"next\"", sizeof(link) - (size_t)(linkptr - link));
+
+    length = strlen(text);
+
+    httpSetLength(client->http, length);
+    httpSetField(client->http, HTTP_FIELD_SERVER, papplSystemGetServerHeader(system));
+    httpSetField(client->http, HTTP_FIELD_CONTENT_TYPE, "text/plain");
+    httpSetField(client->http, HTTP_FIELD_LINK, link);
+
+    if (length == (size_t)(next - start))
+    {
+      // Unfiltered lines are an exact slice of the log file...
+      snprintf(range, sizeof(range), "bytes %ld-%ld/%ld", (long)start, (long)next - 1, (long)size);
+      httpSetField(client->http, HTTP_FIELD_CONTENT_RANGE, range);
+
+      code = HTTP_STATUS_PARTIAL_CONTENT;
+    }
+    else
+    {
+      // Filtered lines are not, so only the Link header tells where to
+      // continue...
+      code = HTTP_STATUS_OK;
+    }
+
+    if (httpWriteResponse(client->http, code) >= 0)
+    {
+      papplLogClient(client, PAPPL_LOGLEVEL_DEBUG, "%s text/plain %d (%s)", httpStatus(code), (int)length, link);
+
+      if (length > 0)
+        httpWrite2(client->http, text, length);
+      httpWrite2(client->http, "", 0);
+    }
+
+    free(text);
+  }
+  else if (client->operation == HTTP_STATE_GET)
   {
     http_status_t	code;		// HTTP status of response
     struct stat		loginfo;	// Log information
@@ -867,26 +991,29 @@ _papplSystemWebLogs(
 		      "        </form>\n"
 		      "        <div class=\"log\" id=\"logdiv\"><pre id=\"log\"></pre></div>\n"
 		      "        <script>\n"
-		      "var content_length = 0;\n"
+		      "var log_offset = -1;\n"
 		      "function update_log() {\n"
 		      "  let xhr = new XMLHttpRequest();\n"
-		      "  xhr.open('GET', '/logfile.txt');\n"
-		      "  xhr.setRequestHeader('Range', 'bytes=' + content_length + '-');\n"
+		      "  xhr.open('GET', '/logfile.txt?' + (log_offset < 0 ? 'lines=1000' : 'offset=' + log_offset));\n"
 		      "  xhr.send();\n"
 		      "  xhr.onreadystatechange = function() {\n"
 		      "    var log = document.getElementById('log');\n"
 		      "    var logdiv = document.getElementById('logdiv');\n"
+		      "    var delay = 5000;\n"
 		      "    if (xhr.readyState != 4) return;\n"
-		      "    if (xhr.status == 200) {\n"
-		      "      log.innerText = xhr.response;\n"
-		      "      content_length = xhr.getResponseHeader('Content-Length');\n"
-		      "    }\n"
-		      "    else if (xhr.status == 206) {\n"
-		      "       log.innerText += xhr.response;\n"
-		      "       content_length += xhr.getResponseHeader('Content-Length');\n"
+		      "    if (xhr.status == 206) {\n"
+		      "      var range = /bytes (\\d+)-(\\d+)\\/(\\d+)/.exec(xhr.getResponseHeader('Content-Range'));\n"
+		      "      if (range) {\n"
+		      "        if (Number(range[1]) != log_offset)\n"
+		      "          log.innerText = xhr.response;\n"
+		      "        else\n"
+		      "          log.innerText += xhr.response;\n"
+		      "        log_offset = Number(range[2]) + 1;\n"
+		      "        if (log_offset < Number(range[3])) delay = 100;\n"
+		      "      }\n"
+		      "      logdiv.scrollTop = logdiv.scrollHeight - logdiv.clientHeight;\n"
 		      "    }\n"
-		      "    window.setTimeout('update_log()', 5000);\n"
-		      "    logdiv.scrollTop = logdiv.scrollHeight - logdiv.clientHeight;\n"
+		      "    window.setTimeout('update_log()', delay);\n"
 		      "  }\n"
 		      "}\n"
 		      "update_log();</script>\n");
@@ -30,6 +30,7 @@ static bool	restart_logging = false;// Restart logging?
 //
 
 static void	make_attributes(pappl_system_t *system);
+static void	save_system(pappl_system_t *system);
 static void	sighup_handler(int sig);
 static void	sigterm_handler(int sig);
 
@@ -106,6 +107,8 @@ _papplSystemConfigChanged(
 // - `PAPPL_SOPTIONS_DNSSD_HOST`: When resolving DNS-SD service name collisions,
 //   use the DNS-SD hostname instead of a serial number or UUID.
 // - `PAPPL_SOPTIONS_WEB_LOG`: Include the log file web page.
+// - `PAPPL_SOPTIONS_WEB_METRICS`: Include the "/metrics" resource with
+//   counters and latency histograms in the Prometheus text format.
 // - `PAPPL_SOPTIONS_MULTI_QUEUE`: Support multiple printers.
 // - `PAPPL_SOPTIONS_WEB_NETWORK`: Include the network settings web page.
 // - `PAPPL_SOPTIONS_RAW_SOCKET`: Accept jobs via raw sockets starting on port
@@ -170,6 +173,11 @@ papplSystemCreate(
   // Initialize values...
   pthread_rwlock_init(&system->rwlock, NULL);
   pthread_rwlock_init(&system->session_rwlock, NULL);
+  pthread_mutex_init(&system->dns_sd_mutex, NULL);
+  pthread_cond_init(&system->dns_sd_cond, NULL);
+  pthread_mutex_init(&system->auth_mutex, NULL);
+  pthread_mutex_init(&system->metrics_mutex, NULL);
+  pthread_mutex_init(&system->logindex_mutex, NULL);
 
   system->options         = options;
   system->start_time      = time(NULL);
@@ -181,11 +189,14 @@ papplSystemCreate(
   system->logfile         = logfile ? strdup(logfile) : NULL;
   system->loglevel        = loglevel;
   system->logmaxsize      = 1024 * 1024;
+  system->save_delay      = 1;
+  system->save_max_delay  = 10;
   system->next_client     = 1;
   system->next_printer_id = 1;
   system->subtypes        = subtypes ? strdup(subtypes) : NULL;
   system->tls_only        = tls_only;
   system->admin_gid       = (gid_t)-1;
+  system->auth_cache_time = 60;
   system->auth_service    = auth_service ? strdup(auth_service) : NULL;
 
   if (!system->name || !system->dns_sd_name || (spooldir && !system->directory) || (logfile && !system->logfile) || (subtypes && !system->subtypes) || (auth_service && !system->auth_service))
@@ -282,6 +293,8 @@ papplSystemDelete(
 
   _papplSystemUnregisterDNSSDNoLock(system);
 
+  _papplSystemClearJournal(system);
+
   cupsArrayDelete(system->printers);
 
   free(system->uuid);
@@ -305,9 +318,18 @@ papplSystemDelete(
   cupsArrayDelete(system->filters);
   cupsArrayDelete(system->links);
   cupsArrayDelete(system->resources);
+  free(system->resource_hash);
+
+  free(system->state_file);
+  free(system->logindex);
 
   pthread_rwlock_destroy(&system->rwlock);
   pthread_rwlock_destroy(&system->session_rwlock);
+  pthread_mutex_destroy(&system->dns_sd_mutex);
+  pthread_cond_destroy(&system->dns_sd_cond);
+  pthread_mutex_destroy(&system->auth_mutex);
+  pthread_mutex_destroy(&system->metrics_mutex);
+  pthread_mutex_destroy(&system->logindex_mutex);
 
   free(system);
 }
@@ -371,6 +393,12 @@ papplSystemRun(pappl_system_t *system)	// I - System
   int			dns_sd_host_changes;
 					// Current number of host name changes
   pappl_printer_t	*printer;	// Current printer
+  size_t		pending_changes = 0;
+					// Configuration changes seen so far
+  time_t		curtime,	// Current time
+			change_time = 0,// Time of last configuration change
+			dirty_time = 0,	// Time of first unsaved change
+			flush_time;	// Time to free idle printer attributes
 
 
   // Range check...
@@ -390,6 +418,7 @@ papplSystemRun(pappl_system_t *system)	// I - System
   }
 
   system->is_running = true;
+  flush_time         = time(NULL) + 60;
 
   // Add fallback resources...
   papplSystemAddResourceData(system, "/favicon.png", "image/png", icon_md_png, sizeof(icon_md_png));
@@ -403,6 +432,9 @@ papplSystemRun(pappl_system_t *system)	// I - System
     papplSystemAddLink(system, "View Logs", "/logs", PAPPL_LOPTIONS_LOGGING | PAPPL_LOPTIONS_HTTPS_REQUIRED);
   }
 
+  if (system->options & PAPPL_SOPTIONS_WEB_METRICS)
+    papplSystemAddResourceCallback(system, "/metrics", "text/plain", (pappl_resource_cb_t)_papplSystemWebMetrics, system);
+
   if (system->options & PAPPL_SOPTIONS_WEB_INTERFACE)
   {
     if (system->options & PAPPL_SOPTIONS_MULTI_QUEUE)
@@ -483,12 +515,20 @@ papplSystemRun(pappl_system_t *system)	// I - System
   if (system->dns_sd_name)
     _papplSystemRegisterDNSSDNoLock(system);
 
+  // Start the DNS-SD worker thread...
+  system->dns_sd_stop    = false;
+  system->dns_sd_changes = 0;
+  system->dns_sd_worker  = !pthread_create(&system->dns_sd_thread, NULL, (void *(*)(void *))_papplSystemRunDNSSD, system);
+
+  if (!system->dns_sd_worker)
+    papplLog(system, PAPPL_LOGLEVEL_ERROR, "Unable to create DNS-SD thread: %s", strerror(errno));
+
   // Start up printers...
   for (printer = (pappl_printer_t *)cupsArrayFirst(system->printers); printer; printer = (pappl_printer_t *)cupsArrayNext(system->printers))
   {
     // Advertise via DNS-SD as needed...
     if (printer->dns_sd_name)
-      _papplPrinterRegisterDNSSDNoLock(printer);
+      _papplPrinterQueueDNSSDNoLock(printer);
 
     // Start the raw socket listeners as needed...
     if ((system->options & PAPPL_SOPTIONS_RAW_SOCKET) && printer->num_listeners > 0)
@@ -588,7 +628,14 @@ papplSystemRun(pappl_system_t *system)	// I - System
       for (printer = (pappl_printer_t *)cupsArrayFirst(system->printers); printer; printer = (pappl_printer_t *)cupsArrayNext(system->printers))
       {
         if (printer->dns_sd_collision || force_dns_sd)
-          _papplPrinterRegisterDNSSDNoLock(printer);
+        {
+          // Queue the printer for the DNS-SD worker, forcing a new
+          // registration when the host has changed...
+          if (force_dns_sd)
+            printer->dns_sd_hash = 0;
+
+          _papplPrinterQueueDNSSDNoLock(printer);
+        }
       }
 
       system->dns_sd_any_collision = false;
@@ -599,12 +646,25 @@ papplSystemRun(pappl_system_t *system)	// I - System
 
     if (system->config_changes > system->save_changes)
     {
-      system->save_changes = system->config_changes;
+      // Wait for a burst of changes to finish before saving, but not longer
+      // than the maximum save delay...
+      curtime = time(NULL);
+
+      if (!dirty_time)
+        dirty_time = curtime;
 
-      if (system->save_cb)
+      if (system->config_changes != pending_changes)
       {
-        // Save the configuration...
-	(system->save_cb)(system, system->save_cbdata);
+        pending_changes = system->config_changes;
+        change_time     = curtime;
+      }
+
+      if ((curtime - change_time) >= system->save_delay || (curtime - dirty_time) >= system->save_max_delay || system->shutdown_time)
+      {
+	system->save_changes = system->config_changes;
+	dirty_time           = 0;
+
+	save_system(system);
       }
     }
 
@@ -622,7 +682,7 @@ papplSystemRun(pappl_system_t *system)	// I - System
       for (printer = (pappl_printer_t *)cupsArrayFirst(system->printers); printer; printer = (pappl_printer_t *)cupsArrayNext(system->printers))
       {
         pthread_rwlock_rdlock(&printer->rwlock);
-        jcount += cupsArrayCount(printer->active_jobs);
+        jcount += printer->active_jobs.count;
         pthread_rwlock_unlock(&printer->rwlock);
       }
       pthread_rwlock_unlock(&system->rwlock);
@@ -634,6 +694,24 @@ papplSystemRun(pappl_system_t *system)	// I - System
     // Clean out old jobs...
     if (system->clean_time && time(NULL) >= system->clean_time)
       papplSystemCleanJobs(system);
+
+    // Free the driver and pre-encoded attributes of idle printers, skipping
+    // printers that are in use...
+    if ((curtime = time(NULL)) >= flush_time)
+    {
+      pthread_rwlock_rdlock(&system->rwlock);
+      for (printer = (pappl_printer_t *)cupsArrayFirst(system->printers); printer; printer = (pappl_printer_t *)cupsArrayNext(system->printers))
+      {
+        if (pthread_rwlock_trywrlock(&printer->rwlock))
+          continue;
+
+        _papplPrinterFlushAttributes(printer, curtime - _PAPPL_PRINTER_IDLE_TIME);
+        pthread_rwlock_unlock(&printer->rwlock);
+      }
+      pthread_rwlock_unlock(&system->rwlock);
+
+      flush_time = curtime + 60;
+    }
   }
 
   papplLog(system, PAPPL_LOGLEVEL_INFO, "Shutting down system.");
@@ -641,6 +719,22 @@ papplSystemRun(pappl_system_t *system)	// I - System
   ippDelete(system->attrs);
   system->attrs = NULL;
 
+  _papplBlobRelease(system->attrs_blob);
+  system->attrs_blob = NULL;
+
+  // Stop the DNS-SD worker thread...
+  if (system->dns_sd_worker)
+  {
+    pthread_mutex_lock(&system->dns_sd_mutex);
+    system->dns_sd_stop = true;
+    pthread_cond_signal(&system->dns_sd_cond);
+    pthread_mutex_unlock(&system->dns_sd_mutex);
+
+    pthread_join(system->dns_sd_thread, NULL);
+
+    system->dns_sd_worker = false;
+  }
+
   if (system->dns_sd_name)
     _papplSystemUnregisterDNSSDNoLock(system);
 
@@ -651,11 +745,8 @@ papplSystemRun(pappl_system_t *system)	// I - System
       _papplPrinterUnregisterDNSSDNoLock(printer);
   }
 
-  if (system->save_changes < system->config_changes && system->save_cb)
-  {
-    // Save the configuration...
-    (system->save_cb)(system, system->save_cbdata);
-  }
+  if (system->save_changes < system->config_changes)
+    save_system(system);
 
   system->is_running = false;
 
@@ -759,6 +850,39 @@ make_attributes(pappl_system_t *system)	// I - System
 
   // system-settable-attributes-supported
   ippAddStrings(system->attrs, IPP_TAG_SYSTEM, IPP_CONST_TAG(IPP_TAG_KEYWORD), "system-settable-attributes-supported", (int)(sizeof(system_settable_attributes_supported) / sizeof(system_settable_attributes_supported[0])), NULL, system_settable_attributes_supported);
+
+  // Pre-encode the static attributes for Get-System-Attributes...
+  system->attrs_blob = _papplBlobCreate(system->attrs);
+}
+
+
+//
+// 'save_system()' - Save the system state using the save callback.
+//
+
+static void
+save_system(pappl_system_t *system)	// I - System
+{
+  struct timeval	starttime,	// Start of save
+			endtime;	// End of save
+
+
+  if (system->save_cb)
+  {
+    // Save the configuration and collect timing metrics...
+    gettimeofday(&starttime, NULL);
+
+    (system->save_cb)(system, system->save_cbdata);
+
+    gettimeofday(&endtime, NULL);
+
+    system->save_count ++;
+    system->save_last_msecs = (size_t)(1000 * (endtime.tv_sec - starttime.tv_sec) + (endtime.tv_usec - starttime.tv_usec) / 1000);
+    system->save_msecs      += system->save_last_msecs;
+  }
+
+  // Discard any job changes that the save callback did not use...
+  _papplSystemClearJournal(system);
 }
 
 
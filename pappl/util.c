@@ -116,6 +116,45 @@ _papplGetRand(void)
 }
 
 
+//
+// '_papplGetTime()' - Return the current monotonic time in seconds.
+//
+// The returned value is only useful for measuring elapsed time.
+//
+
+double					// O - Time in seconds
+_papplGetTime(void)
+{
+  struct timespec	curtime;	// Current time
+
+
+  clock_gettime(CLOCK_MONOTONIC, &curtime);
+
+  return ((double)curtime.tv_sec + 0.000000001 * curtime.tv_nsec);
+}
+
+
+//
+// '_papplHashString()' - Add a string to a FNV-1a hash value.
+//
+// Pass `_PAPPL_HASH_INIT` for the initial "hash" value.  Multiple strings can
+// be hashed by passing the previous result as the "hash" value.
+//
+
+unsigned				// O - New hash value
+_papplHashString(const char *s,		// I - String
+                 unsigned   hash)	// I - Initial hash value
+{
+  while (*s)
+  {
+    hash ^= (unsigned char)*s++;
+    hash *= 16777619U;
+  }
+
+  return (hash);
+}
+
+
 //
 // 'filter_cb()' - Filter printer attributes based on the requested array.
 //
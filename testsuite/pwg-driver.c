@@ -150,7 +150,7 @@ pwg_callback(
     return (false);
   }
 
-  if (!data || (strcmp((const char *)data, "testpappl") && strcmp((const char *)data, "testmainloop")))
+  if (!data || (strcmp((const char *)data, "testpappl") && strcmp((const char *)data, "testmainloop") && strcmp((const char *)data, "testraster")))
   {
     papplLog(system, PAPPL_LOGLEVEL_ERROR, "Driver callback called with bad data pointer.");
     return (false);
@@ -31,10 +31,25 @@
 // Tests:
 //
 //   all                  All of the following tests
+//   clean                Completed job cleanup tests
 //   client               Simulated client tests
 //   jpeg                 JPEG image tests
 //   png                  PNG image tests
 //   pwg-raster           PWG Raster tests
+//   log                  Log file filter tests
+//   ready                Server readiness notification tests
+//   save                 State file save and load tests
+//
+// Benchmarks:
+//
+//   load[:CLIENTS[:REQUESTS[:MIX]]]
+//                        Multi-client IPP load benchmark; MIX is a comma-
+//                        separated list of Get-Printer-Attributes, Get-Jobs,
+//                        Print-Job, and Cancel-Job weights (default 4,4,1,1)
+//   state[:PRINTERS[:JOBS]]
+//                        papplSystemLoadState benchmark with a generated state
+//                        file (default 300 printers and 10000 completed jobs),
+//                        also reports the memory used by driver attributes
 //
 
 //
@@ -42,10 +57,16 @@
 //
 
 #include <pappl/base-private.h>
+#include <pappl/log-private.h>
+#include <pappl/printer-private.h>
 #include <cups/dir.h>
 #include "testpappl.h"
 #include <stdlib.h>
 #include <limits.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/time.h>
+#include <sys/un.h>
 
 
 //
@@ -59,21 +80,57 @@ typedef struct _pappl_testdata_s	// Test data
   const char		*outdirname;	// Output directory
 } _pappl_testdata_t;
 
+typedef enum _pappl_loadop_e		// Load benchmark operations
+{
+  _PAPPL_LOADOP_GET_PRINTER_ATTRIBUTES,	// Get-Printer-Attributes
+  _PAPPL_LOADOP_GET_JOBS,		// Get-Jobs
+  _PAPPL_LOADOP_PRINT_JOB_RASTER,	// Print-Job (PWG raster)
+  _PAPPL_LOADOP_PRINT_JOB_JPEG,		// Print-Job (JPEG)
+  _PAPPL_LOADOP_CANCEL_JOB,		// Cancel-Job
+  _PAPPL_LOADOP_MAX			// Number of operations
+} _pappl_loadop_t;
+
+typedef struct _pappl_testload_s	// Load benchmark client data
+{
+  pappl_system_t	*system;	// System
+  const char		*rasterfile,	// PWG raster file to print
+			*jpegfile;	// JPEG file to print, if any
+  int			num_requests;	// Number of requests to send
+  const int		*mix;		// Operation weights
+  int			num_times[_PAPPL_LOADOP_MAX];
+					// Number of latencies per operation
+  double		*times[_PAPPL_LOADOP_MAX];
+					// Latencies per operation in seconds
+  int			num_errors;	// Number of failed requests
+} _pappl_testload_t;
+
 
 //
 // Local functions...
 //
 
+static int	compare_times(const double *a, const double *b);
 static http_t	*connect_to_printer(pappl_system_t *system, char *uri, size_t urisize);
 static void	device_error_cb(const char *message, void *err_data);
 static bool	device_list_cb(const char *device_info, const char *device_uri, const char *device_id, void *data);
+static http_status_t get_resource(http_t *http, const char *resource, char *buffer, size_t bufsize);
+static long	get_rss(void);
+static double	get_time(void);
 static const char *make_raster_file(ipp_t *response, bool grayscale, char *tempname, size_t tempsize);
 static void	*run_tests(_pappl_testdata_t *testdata);
+static bool	test_clean(const char *outdirname);
 static bool	test_client(pappl_system_t *system);
 #if defined(HAVE_LIBJPEG) || defined(HAVE_LIBPNG)
 static bool	test_image_files(pappl_system_t *system, const char *prompt, const char *format, int num_files, const char * const *files);
 #endif // HAVE_LIBJPEG || HAVE_LIBPNG
+static bool	test_load(pappl_system_t *system, const char *name);
+static void	*test_load_client(_pappl_testload_t *load);
+static bool	test_log(pappl_system_t *system);
 static bool	test_pwg_raster(pappl_system_t *system);
+static bool	test_ready(const char *outdirname);
+static bool	test_save(const char *outdirname);
+static bool	test_state(const char *name);
+static void	test_state_attrs(pappl_printer_t *printer, bool *flush);
 static int	usage(int status);
 
 
@@ -104,7 +161,7 @@ main(int  argc,				// I - Number of command-line arguments
 					// Output directory name
 			device_uri[1024];
 					// Device URI for printers
-  pappl_soptions_t	soptions = PAPPL_SOPTIONS_MULTI_QUEUE | PAPPL_SOPTIONS_WEB_INTERFACE | PAPPL_SOPTIONS_WEB_LOG | PAPPL_SOPTIONS_WEB_NETWORK | PAPPL_SOPTIONS_WEB_SECURITY | PAPPL_SOPTIONS_WEB_TLS | PAPPL_SOPTIONS_RAW_SOCKET;
+  pappl_soptions_t	soptions = PAPPL_SOPTIONS_MULTI_QUEUE | PAPPL_SOPTIONS_WEB_INTERFACE | PAPPL_SOPTIONS_WEB_LOG | PAPPL_SOPTIONS_WEB_NETWORK | PAPPL_SOPTIONS_WEB_SECURITY | PAPPL_SOPTIONS_WEB_TLS | PAPPL_SOPTIONS_WEB_METRICS | PAPPL_SOPTIONS_RAW_SOCKET;
 					// System options
   pappl_system_t	*system;	// System
   pappl_printer_t	*printer;	// Printer
@@ -281,10 +338,14 @@ main(int  argc,				// I - Number of command-line arguments
 
 	      if (!strcmp(argv[i], "all"))
 	      {
+		cupsArrayAdd(testdata.names, "clean");
 		cupsArrayAdd(testdata.names, "client");
 		cupsArrayAdd(testdata.names, "jpeg");
 		cupsArrayAdd(testdata.names, "png");
 		cupsArrayAdd(testdata.names, "pwg-raster");
+		cupsArrayAdd(testdata.names, "log");
+		cupsArrayAdd(testdata.names, "ready");
+		cupsArrayAdd(testdata.names, "save");
 	      }
 	      else
 	      {
@@ -411,6 +472,23 @@ main(int  argc,				// I - Number of command-line arguments
 }
 
 
+//
+// 'compare_times()' - Compare two latencies for sorting.
+//
+
+static int				// O - Result of comparison
+compare_times(const double *a,		// I - First latency
+              const double *b)		// I - Second latency
+{
+  if (*a < *b)
+    return (-1);
+  else if (*a > *b)
+    return (1);
+  else
+    return (0);
+}
+
+
 //
 // 'connect_to_printer()' - Connect to the system and return the printer URI.
 //
@@ -459,6 +537,97 @@ device_list_cb(const char *device_info,	// I - Device description
 }
 
 
+//
+// 'get_resource()' - Get a resource using HTTP GET.
+//
+// The response fields can be read with `httpGetField` afterwards.
+//
+
+static http_status_t			// O - HTTP status
+get_resource(http_t     *http,		// I - HTTP connection
+             const char *resource,	// I - Resource path
+             char       *buffer,	// I - Response body buffer
+             size_t     bufsize)	// I - Size of buffer
+{
+  http_status_t	status;			// HTTP status
+  char		*bufptr,		// Pointer into buffer
+		*bufend;		// End of buffer
+  ssize_t	bytes;			// Bytes read
+
+
+  httpClearFields(http);
+  httpSetField(http, HTTP_FIELD_HOST, "localhost");
+
+  if (httpGet(http, resource))
+  {
+    if (httpReconnect2(http, 30000, NULL))
+      return (HTTP_STATUS_ERROR);
+
+    httpSetField(http, HTTP_FIELD_HOST, "localhost");
+
+    if (httpGet(http, resource))
+      return (HTTP_STATUS_ERROR);
+  }
+
+  while ((status = httpUpdate(http)) == HTTP_STATUS_CONTINUE);
+
+  for (bufptr = buffer, bufend = buffer + bufsize - 1; bufptr < bufend; bufptr += bytes)
+  {
+    if ((bytes = httpRead2(http, bufptr, (size_t)(bufend - bufptr))) <= 0)
+      break;
+  }
+
+  *bufptr = '\0';
+
+  httpFlush(http);
+
+  return (status);
+}
+
+
+//
+// 'get_rss()' - Get the resident set size of the process.
+//
+
+static long				// O - Resident set size in kilobytes or `0` if unknown
+get_rss(void)
+{
+  long		rss = 0;		// Resident set size
+  cups_file_t	*fp;			// "statm" file
+  char		line[256];		// Line from file
+  long		size,			// Total pages
+		resident;		// Resident pages
+
+
+  // This is only available on Linux...
+  if ((fp = cupsFileOpen("/proc/self/statm", "r")) != NULL)
+  {
+    if (cupsFileGets(fp, line, sizeof(line)) && sscanf(line, "%ld%ld", &size, &resident) == 2)
+      rss = resident * (sysconf(_SC_PAGESIZE) / 1024);
+
+    cupsFileClose(fp);
+  }
+
+  return (rss);
+}
+
+
+//
+// 'get_time()' - Get the current time in seconds.
+//
+
+static double				// O - Time in seconds
+get_time(void)
+{
+  struct timeval	curtime;	// Current time
+
+
+  gettimeofday(&curtime, NULL);
+
+  return (curtime.tv_sec + 0.000001 * curtime.tv_usec);
+}
+
+
 //
 // 'make_raster_file()' - Create a temporary PWG raster file.
 //
@@ -748,7 +917,14 @@ run_tests(_pappl_testdata_t *testdata)	// I - Testing data
     printf("%s: ", name);
     fflush(stdout);
 
-    if (!strcmp(name, "client"))
+    if (!strcmp(name, "clean"))
+    {
+      if (!test_clean(testdata->outdirname))
+        ret = (void *)1;
+      else
+        puts("PASS");
+    }
+    else if (!strcmp(name, "client"))
     {
       if (!test_client(testdata->system))
         ret = (void *)1;
@@ -784,6 +960,41 @@ run_tests(_pappl_testdata_t *testdata)	// I - Testing data
       else
         puts("PASS");
     }
+    else if (!strcmp(name, "log"))
+    {
+      if (!test_log(testdata->system))
+        ret = (void *)1;
+      else
+        puts("PASS");
+    }
+    else if (!strcmp(name, "ready"))
+    {
+      if (!test_ready(testdata->outdirname))
+        ret = (void *)1;
+      else
+        puts("PASS");
+    }
+    else if (!strcmp(name, "save"))
+    {
+      if (!test_save(testdata->outdirname))
+        ret = (void *)1;
+      else
+        puts("PASS");
+    }
+    else if (!strcmp(name, "load") || !strncmp(name, "load:", 5))
+    {
+      if (!test_load(testdata->system, name))
+        ret = (void *)1;
+      else
+        puts("PASS");
+    }
+    else if (!strcmp(name, "state") || !strncmp(name, "state:", 6))
+    {
+      if (!test_state(name))
+        ret = (void *)1;
+      else
+        puts("PASS");
+    }
     else
     {
       puts("UNKNOWN TEST");
@@ -817,6 +1028,117 @@ run_tests(_pappl_testdata_t *testdata)	// I - Testing data
 }
 
 
+//
+// 'test_clean()' - Test that old completed jobs and their files are removed.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_clean(const char *outdirname)	// I - Output directory
+{
+  bool			ret = false;	// Return value
+  int			i,		// Looping var
+			fd,		// Document file
+			job_ids[5];	// Job IDs
+  char			spooldir[1024],	// Spool directory
+			filenames[5][1024];
+					// Document filenames
+  pappl_system_t	*system;	// Scratch system
+  pappl_printer_t	*printer;	// Printer
+  pappl_job_t		*job;		// Job
+  time_t		curtime;	// Current time
+  struct stat		fileinfo;	// File information
+
+
+  // Use a scratch system with its own spool directory so that the job files
+  // cannot collide with those of the test system...
+  snprintf(spooldir, sizeof(spooldir), "%s/clean.d", outdirname);
+
+  if ((system = papplSystemCreate(PAPPL_SOPTIONS_NONE, "Clean System", 0, NULL, spooldir, "-", PAPPL_LOGLEVEL_ERROR, NULL, false)) == NULL)
+  {
+    puts("FAIL (Unable to create system)");
+    return (false);
+  }
+
+  papplSystemSetPrinterDrivers(system, (int)(sizeof(pwg_drivers) / sizeof(pwg_drivers[0])), pwg_drivers, pwg_autoadd, /* create_cb */NULL, pwg_callback, "testpappl");
+
+  if ((printer = papplPrinterCreate(system, /* printer_id */0, "Clean Printer", "pwg_common-300dpi-600dpi-srgb_8", "MFG:PWG;MDL:Clean Printer;", "file:///dev/null")) == NULL)
+  {
+    puts("FAIL (Unable to create printer)");
+    goto done;
+  }
+
+  // Create completed jobs with document files, oldest first...
+  curtime = time(NULL);
+
+  for (i = 0; i < 5; i ++)
+  {
+    if ((job = _papplJobCreate(printer, 0, "clean", "image/pwg-raster", "Clean Job", NULL)) == NULL)
+    {
+      puts("FAIL (Unable to create job)");
+      goto done;
+    }
+
+    job_ids[i] = job->job_id;
+
+    if ((fd = papplJobOpenFile(job, filenames[i], sizeof(filenames[i]), NULL, NULL, "w")) < 0)
+    {
+      printf("FAIL (Unable to create '%s': %s)\n", filenames[i], strerror(errno));
+      goto done;
+    }
+
+    close(fd);
+
+    pthread_rwlock_wrlock(&printer->rwlock);
+
+    job->filename  = strdup(filenames[i]);
+    job->state     = IPP_JSTATE_COMPLETED;
+    job->completed = curtime - 120 + i;
+
+    _papplPrinterCompleteJob(printer, job);
+
+    pthread_rwlock_unlock(&printer->rwlock);
+  }
+
+  // Keep only the newest job...
+  papplPrinterSetMaxCompletedJobs(printer, 1);
+  papplSystemCleanJobs(system);
+
+  for (i = 0; i < 4; i ++)
+  {
+    if (papplPrinterFindJob(printer, job_ids[i]))
+    {
+      printf("FAIL (Job %d not removed)\n", job_ids[i]);
+      goto done;
+    }
+    else if (!stat(filenames[i], &fileinfo))
+    {
+      printf("FAIL (Job %d file '%s' not removed)\n", job_ids[i], filenames[i]);
+      goto done;
+    }
+  }
+
+  if (!papplPrinterFindJob(printer, job_ids[4]))
+  {
+    printf("FAIL (Job %d removed)\n", job_ids[4]);
+    goto done;
+  }
+  else if (stat(filenames[4], &fileinfo))
+  {
+    printf("FAIL (Job %d file '%s' removed)\n", job_ids[4], filenames[4]);
+    goto done;
+  }
+
+  ret = true;
+
+  done:
+
+  papplSystemDelete(system);
+  rmdir(spooldir);
+
+  return (ret);
+}
+
+
 //
 // 'test_client()' - Run simulated client tests.
 //
@@ -829,6 +1151,8 @@ test_client(pappl_system_t *system)	// I - System
   ipp_t		*request,		// Request
 		*response;		// Response
   int		i;			// Looping var
+  pappl_printer_t *printer;		// Printer
+  bool		has_blob;		// Pre-encoded driver attributes?
   static const char * const pattrs[] =	// Printer attributes
   {
     "printer-contact-col",
@@ -841,6 +1165,23 @@ test_client(pappl_system_t *system)	// I - System
     "printer-uuid",
     "printer-uri-supported"
   };
+  http_status_t	status;			// HTTP status
+  char		*buffer;		// Response body
+  static const char * const metrics[] =	// Metrics
+  {
+    "\n# TYPE pappl_printers gauge\npappl_printers ",
+    "\n# TYPE pappl_jobs_completed_total counter\n",
+    "\npappl_http_request_duration_seconds_count{method=\"POST\"} ",
+    "\npappl_ipp_request_duration_seconds_count{operation=\"Get-Printer-Attributes\"} ",
+    "\n# TYPE pappl_job_wait_seconds histogram\n"
+  };
+  static const char * const rattrs[] =	// Requested printer attributes
+  {
+    "charset-supported",		// Static
+    "media-col-database",		// Driver, only when requested
+    "printer-state",			// Dynamic
+    "sides-supported"			// Driver
+  };
   static const char * const sattrs[] =	// System attributes
   {
     "system-contact-col",
@@ -987,80 +1328,273 @@ test_client(pappl_system_t *system)	// I - System
       }
     }
 
+    if (!ippFindAttribute(response, "sides-supported", IPP_TAG_ZERO))
+    {
+      puts("FAIL (Missing driver 'sides-supported' attribute in response)");
+      httpClose(http);
+      ippDelete(response);
+      return (false);
+    }
+    else if (ippFindAttribute(response, "media-col-database", IPP_TAG_ZERO))
+    {
+      puts("FAIL (Unexpected 'media-col-database' attribute in response)");
+      httpClose(http);
+      ippDelete(response);
+      return (false);
+    }
+
     ippDelete(response);
   }
 
-  httpClose(http);
-
-  return (true);
-}
+  // Test Get-Printer-Attributes with requested-attributes, which copies the
+  // selected static and driver attributes from their pre-encoded form...
+  fputs("\nclient: Get-Printer-Attributes(requested-attributes) ", stdout);
 
+  request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, "ipp://localhost/ipp/print");
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+  ippAddStrings(request, IPP_TAG_OPERATION, IPP_CONST_TAG(IPP_TAG_KEYWORD), "requested-attributes", (int)(sizeof(rattrs) / sizeof(rattrs[0])), NULL, rattrs);
 
-#if defined(HAVE_LIBJPEG) || defined(HAVE_LIBPNG)
-//
-// 'test_image_files()' - Run image file tests.
-//
+  response = cupsDoRequest(http, request, "/ipp/print");
 
-static bool				// O - `true` on success, `false` on failure
-test_image_files(
-    pappl_system_t       *system,	// I - System
-    const char           *prompt,	// I - Prompt for files
-    const char           *format,	// I - MIME media type of files
-    int                  num_files,	// I - Number of files to print
-    const char * const * files)		// I - Files to print
-{
-  int		i, j, k, m;		// Looping vars
-  http_t	*http;			// HTTP connection
-  char		uri[1024],		// "printer-uri" value
-		filename[1024],		// Print file
-		job_name[1024];		// "job_name" value
-  ipp_t		*request,		// Request
-		*response;		// Response
-  int		job_id;			// "job-id" value
-  ipp_jstate_t	job_state;		// "job-state" value
-  static const int orients[] =		// "orientation-requested" values
-  {
-    IPP_ORIENT_NONE,
-    IPP_ORIENT_PORTRAIT,
-    IPP_ORIENT_LANDSCAPE,
-    IPP_ORIENT_REVERSE_PORTRAIT,
-    IPP_ORIENT_REVERSE_LANDSCAPE
-  };
-  static const char * const modes[] =	// "print-color-mode" values
+  if (cupsLastError() != IPP_STATUS_OK)
   {
-    "auto",
-    "color",
-    "monochrome"
-  };
-  static const char * const scalings[] =// "print-scaling" values
+    printf("FAIL (%s)\n", cupsLastErrorString());
+    httpClose(http);
+    ippDelete(response);
+    return (false);
+  }
+  else
   {
-    "auto",
-    "auto-fit",
-    "fill",
-    "fit",
-    "none"
-  };
+    for (i = 0; i < (int)(sizeof(rattrs) / sizeof(rattrs[0])); i ++)
+    {
+      if (!ippFindAttribute(response, rattrs[i], IPP_TAG_ZERO))
+      {
+	printf("FAIL (Missing requested '%s' attribute in response)\n", rattrs[i]);
+	httpClose(http);
+	ippDelete(response);
+	return (false);
+      }
+    }
+
+    if (!ippContainsString(ippFindAttribute(response, "charset-supported", IPP_TAG_CHARSET), "utf-8"))
+    {
+      puts("FAIL (Bad 'charset-supported' value in response)");
+      httpClose(http);
+      ippDelete(response);
+      return (false);
+    }
+    else if (ippFindAttribute(response, "printer-name", IPP_TAG_ZERO))
+    {
+      puts("FAIL (Unexpected 'printer-name' attribute in response)");
+      httpClose(http);
+      ippDelete(response);
+      return (false);
+    }
+
+    ippDelete(response);
+  }
 
+  // Test that the pre-encoded driver attributes are created again after the
+  // application gets (and changes) them...
+  fputs("\nclient: papplPrinterGetDriverAttributes ", stdout);
 
-  // Connect to system...
-  if ((http = connect_to_printer(system, uri, sizeof(uri))) == NULL)
+  if ((printer = papplSystemFindPrinter(system, "/ipp/print", 0, NULL)) == NULL)
   {
-    printf("FAIL (Unable to connect: %s)\n", cupsLastErrorString());
+    puts("FAIL (Unable to find printer)");
+    httpClose(http);
     return (false);
   }
 
-  // Print files...
-  for (i = 0; i < num_files; i ++)
+  ippAddString(papplPrinterGetDriverAttributes(printer), IPP_TAG_PRINTER, IPP_TAG_KEYWORD, "testpappl-driver-attribute", NULL, "changed");
+
+  pthread_mutex_lock(&printer->blob_mutex);
+  has_blob = printer->driver_blob != NULL;
+  pthread_mutex_unlock(&printer->blob_mutex);
+
+  if (has_blob)
   {
-    if (access(files[i], R_OK))
-      snprintf(filename, sizeof(filename), "testsuite/%s", files[i]);
-    else
-      strlcpy(filename, files[i], sizeof(filename));
+    puts("FAIL (Pre-encoded driver attributes not discarded)");
+    httpClose(http);
+    return (false);
+  }
 
-    for (j = 0; j < (int)(sizeof(orients) / sizeof(orients[0])); j ++)
-    {
-      for (k = 0; k < (int)(sizeof(modes) / sizeof(modes[0])); k ++)
-      {
+  request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, "ipp://localhost/ipp/print");
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+
+  response = cupsDoRequest(http, request, "/ipp/print");
+
+  pthread_mutex_lock(&printer->blob_mutex);
+  has_blob = printer->driver_blob != NULL;
+  pthread_mutex_unlock(&printer->blob_mutex);
+
+  if (cupsLastError() != IPP_STATUS_OK)
+  {
+    printf("FAIL (%s)\n", cupsLastErrorString());
+    httpClose(http);
+    ippDelete(response);
+    return (false);
+  }
+  else if (!ippFindAttribute(response, "testpappl-driver-attribute", IPP_TAG_KEYWORD))
+  {
+    puts("FAIL (Changed driver attributes not in response)");
+    httpClose(http);
+    ippDelete(response);
+    return (false);
+  }
+  else if (!has_blob)
+  {
+    puts("FAIL (Pre-encoded driver attributes not created again)");
+    httpClose(http);
+    ippDelete(response);
+    return (false);
+  }
+
+  ippDelete(response);
+
+  // Test Get-Jobs without requested-attributes, which only returns the
+  // "job-id" and "job-uri" attributes...
+  fputs("\nclient: Get-Jobs ", stdout);
+
+  request = ippNewRequest(IPP_OP_GET_JOBS);
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, "ipp://localhost/ipp/print");
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_KEYWORD, "which-jobs", NULL, "all");
+
+  response = cupsDoRequest(http, request, "/ipp/print");
+
+  if (cupsLastError() != IPP_STATUS_OK)
+  {
+    printf("FAIL (%s)\n", cupsLastErrorString());
+    httpClose(http);
+    ippDelete(response);
+    return (false);
+  }
+  else
+  {
+    ipp_attribute_t	*attr;		// Current attribute
+    const char		*name;		// Attribute name
+
+    for (attr = ippFirstAttribute(response); attr; attr = ippNextAttribute(response))
+    {
+      if (ippGetGroupTag(attr) != IPP_TAG_JOB || (name = ippGetName(attr)) == NULL)
+        continue;
+
+      if (strcmp(name, "job-id") && strcmp(name, "job-uri"))
+      {
+	printf("FAIL (Unexpected '%s' attribute in response)\n", name);
+	httpClose(http);
+	ippDelete(response);
+	return (false);
+      }
+    }
+
+    ippDelete(response);
+  }
+
+  // Test the "/metrics" resource, which must include the IPP requests sent
+  // above...
+  fputs("\nclient: /metrics ", stdout);
+
+  if ((buffer = malloc(1048576)) == NULL)
+  {
+    puts("FAIL (Unable to allocate memory)");
+    httpClose(http);
+    return (false);
+  }
+
+  if ((status = get_resource(http, "/metrics", buffer, 1048576)) != HTTP_STATUS_OK)
+  {
+    printf("FAIL (Got %d %s, expected 200)\n", status, httpStatus(status));
+    free(buffer);
+    httpClose(http);
+    return (false);
+  }
+
+  for (i = 0; i < (int)(sizeof(metrics) / sizeof(metrics[0])); i ++)
+  {
+    if (!strstr(buffer, metrics[i]))
+    {
+      printf("FAIL (Missing '%s' in response)\n", metrics[i]);
+      free(buffer);
+      httpClose(http);
+      return (false);
+    }
+  }
+
+  free(buffer);
+  httpClose(http);
+
+  return (true);
+}
+
+
+#if defined(HAVE_LIBJPEG) || defined(HAVE_LIBPNG)
+//
+// 'test_image_files()' - Run image file tests.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_image_files(
+    pappl_system_t       *system,	// I - System
+    const char           *prompt,	// I - Prompt for files
+    const char           *format,	// I - MIME media type of files
+    int                  num_files,	// I - Number of files to print
+    const char * const * files)		// I - Files to print
+{
+  int		i, j, k, m;		// Looping vars
+  http_t	*http;			// HTTP connection
+  char		uri[1024],		// "printer-uri" value
+		filename[1024],		// Print file
+		job_name[1024];		// "job_name" value
+  ipp_t		*request,		// Request
+		*response;		// Response
+  int		job_id;			// "job-id" value
+  ipp_jstate_t	job_state;		// "job-state" value
+  static const int orients[] =		// "orientation-requested" values
+  {
+    IPP_ORIENT_NONE,
+    IPP_ORIENT_PORTRAIT,
+    IPP_ORIENT_LANDSCAPE,
+    IPP_ORIENT_REVERSE_PORTRAIT,
+    IPP_ORIENT_REVERSE_LANDSCAPE
+  };
+  static const char * const modes[] =	// "print-color-mode" values
+  {
+    "auto",
+    "color",
+    "monochrome"
+  };
+  static const char * const scalings[] =// "print-scaling" values
+  {
+    "auto",
+    "auto-fit",
+    "fill",
+    "fit",
+    "none"
+  };
+
+
+  // Connect to system...
+  if ((http = connect_to_printer(system, uri, sizeof(uri))) == NULL)
+  {
+    printf("FAIL (Unable to connect: %s)\n", cupsLastErrorString());
+    return (false);
+  }
+
+  // Print files...
+  for (i = 0; i < num_files; i ++)
+  {
+    if (access(files[i], R_OK))
+      snprintf(filename, sizeof(filename), "testsuite/%s", files[i]);
+    else
+      strlcpy(filename, files[i], sizeof(filename));
+
+    for (j = 0; j < (int)(sizeof(orients) / sizeof(orients[0])); j ++)
+    {
+      for (k = 0; k < (int)(sizeof(modes) / sizeof(modes[0])); k ++)
+      {
 	for (m = 0; m < (int)(sizeof(scalings) / sizeof(scalings[0])); m ++)
 	{
 	  // Stop the test if the system is shutdown (e.g. CTRL+C)
@@ -1135,33 +1669,80 @@ test_image_files(
 
 
 //
-// 'test_pwg_raster()' - Run PWG Raster tests.
+// 'test_load()' - Run a multi-client IPP load benchmark.
+//
+// The test name is "load[:CLIENTS[:REQUESTS[:MIX]]]" where MIX is a comma-
+// delimited list of Get-Printer-Attributes, Get-Jobs, Print-Job, and
+// Cancel-Job weights.  Results are reported as one JSON object per operation
+// with latencies in milliseconds.
 //
 
 static bool				// O - `true` on success, `false` on failure
-test_pwg_raster(pappl_system_t *system)	// I - System
+test_load(pappl_system_t *system,	// I - System
+          const char     *name)		// I - Test name with options
 {
   bool		ret = false;		// Return value
+  int		i, j, k;		// Looping vars
+  int		num_clients = 8,	// Number of client threads
+		num_requests = 100,	// Number of requests per client
+		mix[4] = { 4, 4, 1, 1 },// Operation weights
+		num_times,		// Number of latencies for operation
+		num_requests_total = 0,	// Total number of requests
+		num_errors = 0;		// Total number of errors
+  const char	*ptr;			// Pointer into test name
+  char		*end;			// End of number
   http_t	*http = NULL;		// HTTP connection
   char		uri[1024],		// "printer-uri" value
-		filename[1024] = "",	// Print file
-		job_name[1024];		// "job_name" value
+		rasterfile[1024] = "",	// PWG raster file
+		jpegfile[1024] = "";	// JPEG file
   ipp_t		*request,		// IPP request
-		*response,		// IPP response
 		*supported = NULL;	// Supported attributes
-  ipp_attribute_t *mode_supported;	// "print-color-mode-supported" attribute
-  int		i;			// Looping var
-  int		job_id;			// "job-id" value
-  ipp_jstate_t	job_state;		// "job-state" value
-  static const char * const modes[] =	// "print-color-mode" values
+  _pappl_testload_t *loads = NULL;	// Client data
+  pthread_t	*threads = NULL;	// Client threads
+  double	start,			// Start time
+		elapsed,		// Elapsed time
+		*times = NULL;		// Merged latencies
+  static const char * const ops[] =	// Operation names
   {
-    "auto",
-    "auto-monochrome",
-    "color",
-    "monochrome"
+    "Get-Printer-Attributes",
+    "Get-Jobs",
+    "Print-Job/image/pwg-raster",
+    "Print-Job/image/jpeg",
+    "Cancel-Job"
   };
 
 
+  // Parse options from the test name...
+  if ((ptr = strchr(name, ':')) != NULL)
+  {
+    num_clients = (int)strtol(ptr + 1, &end, 10);
+
+    if (*end == ':')
+    {
+      num_requests = (int)strtol(end + 1, &end, 10);
+
+      if (*end == ':')
+      {
+        // Weights that are not specified default to 0...
+        memset(mix, 0, sizeof(mix));
+
+        for (i = 0, ptr = end + 1; i < 4; i ++, ptr = end + 1)
+        {
+          mix[i] = (int)strtol(ptr, &end, 10);
+
+          if (*end != ',')
+            break;
+        }
+      }
+    }
+
+    if (*end || num_clients < 1 || num_clients > 256 || num_requests < 1 || mix[0] < 0 || mix[1] < 0 || mix[2] < 0 || mix[3] < 0 || (mix[0] + mix[1] + mix[2] + mix[3]) < 1)
+    {
+      printf("FAIL (Bad load test '%s')\n", name);
+      return (false);
+    }
+  }
+
   // Connect to system...
   if ((http = connect_to_printer(system, uri, sizeof(uri))) == NULL)
   {
@@ -1169,11 +1750,9 @@ test_pwg_raster(pappl_system_t *system)	// I - System
     return (false);
   }
 
-  // Get printer capabilities
-  fputs("Get-Printer-Attributes: ", stdout);
-
+  // Get printer capabilities and make the print files...
   request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
-  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, "ipp://localhost/ipp/print");
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, uri);
   ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
 
   supported = cupsDoRequest(http, request, "/ipp/print");
@@ -1184,86 +1763,116 @@ test_pwg_raster(pappl_system_t *system)	// I - System
     goto done;
   }
 
-  if ((mode_supported = ippFindAttribute(supported, "print-color-mode-supported", IPP_TAG_KEYWORD)) == NULL)
+  if (!make_raster_file(supported, true, rasterfile, sizeof(rasterfile)))
+    goto done;
+
+#ifdef HAVE_LIBJPEG
+  if (ippContainsString(ippFindAttribute(supported, "document-format-supported", IPP_TAG_MIMETYPE), "image/jpeg"))
   {
-    puts("FAIL (Missing required 'print-color-mode-supported' attribute in response)");
+    if (!access("portrait-gray.jpg", R_OK))
+      strlcpy(jpegfile, "portrait-gray.jpg", sizeof(jpegfile));
+    else if (!access("testsuite/portrait-gray.jpg", R_OK))
+      strlcpy(jpegfile, "testsuite/portrait-gray.jpg", sizeof(jpegfile));
+  }
+#endif // HAVE_LIBJPEG
+
+  printf("%d clients, %d requests/client, mix %d,%d,%d,%d: ", num_clients, num_requests, mix[0], mix[1], mix[2], mix[3]);
+  fflush(stdout);
+
+  // Allocate client data...
+  if ((loads = calloc((size_t)num_clients, sizeof(_pappl_testload_t))) == NULL || (threads = calloc((size_t)num_clients, sizeof(pthread_t))) == NULL || (times = calloc((size_t)(num_clients * num_requests), sizeof(double))) == NULL)
+  {
+    printf("FAIL (Unable to allocate memory: %s)\n", strerror(errno));
     goto done;
   }
 
-  // Loop through the supported print-color-mode values...
-  for (i = 0; i < (int)(sizeof(modes) / sizeof(modes[0])); i ++)
+  for (i = 0; i < num_clients; i ++)
   {
-    // Make raster data for this mode...
-    printf("\npwg-raster: %s: ", modes[i]);
-    fflush(stdout);
+    loads[i].system       = system;
+    loads[i].rasterfile   = rasterfile;
+    loads[i].jpegfile     = jpegfile[0] ? jpegfile : NULL;
+    loads[i].num_requests = num_requests;
+    loads[i].mix          = mix;
 
-    if (!ippContainsString(mode_supported, modes[i]))
-      continue;				// Not supported, skip
+    for (j = 0; j < _PAPPL_LOADOP_MAX; j ++)
+    {
+      if ((loads[i].times[j] = calloc((size_t)num_requests, sizeof(double))) == NULL)
+      {
+	printf("FAIL (Unable to allocate memory: %s)\n", strerror(errno));
+	goto done;
+      }
+    }
+  }
 
-    if (!make_raster_file(supported, strstr(modes[i], "monochrome") != NULL, filename, sizeof(filename)))
-      break;				// Error
+  // Start the clients and wait for them to finish...
+  start = get_time();
 
-    // Print the file...
-    snprintf(job_name, sizeof(job_name), "pwg-raster-%s", modes[i]);
+  for (i = 0; i < num_clients; i ++)
+  {
+    if (pthread_create(threads + i, NULL, (void *(*)(void *))test_load_client, loads + i))
+    {
+      printf("FAIL (Unable to create client thread: %s)\n", strerror(errno));
 
-    request = ippNewRequest(IPP_OP_PRINT_JOB);
-    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, uri);
-    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
-    ippAddString(request, IPP_TAG_OPERATION, IPP_CONST_TAG(IPP_TAG_MIMETYPE), "document-format", NULL, "image/pwg-raster");
-    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "job-name", NULL, job_name);
+      while (i > 0)
+        pthread_join(threads[-- i], NULL);
 
-    ippAddString(request, IPP_TAG_JOB, IPP_TAG_KEYWORD, "print-color-mode", NULL, modes[i]);
+      goto done;
+    }
+  }
 
-    response = cupsDoFileRequest(http, request, "/ipp/print", filename);
+  for (i = 0; i < num_clients; i ++)
+    pthread_join(threads[i], NULL);
 
-    if (cupsLastError() >= IPP_STATUS_ERROR_BAD_REQUEST)
+  if ((elapsed = get_time() - start) <= 0.0)
+    elapsed = 0.000001;
+
+  // Report throughput and latency percentiles for each operation...
+  for (j = 0; j < _PAPPL_LOADOP_MAX; j ++)
+  {
+    for (i = 0, num_times = 0; i < num_clients; i ++)
     {
-      printf("FAIL (Unable to print %s: %s)\n", job_name, cupsLastErrorString());
-      goto done;
+      for (k = 0; k < loads[i].num_times[j]; k ++)
+        times[num_times ++] = loads[i].times[j][k];
     }
 
-    job_id = ippGetInteger(ippFindAttribute(response, "job-id", IPP_TAG_INTEGER), 0);
+    if (num_times == 0)
+      continue;
 
-    ippDelete(response);
+    qsort(times, (size_t)num_times, sizeof(double), (int (*)(const void *, const void *))compare_times);
 
-    printf("job-id=%d ", job_id);
-    fflush(stdout);
+    printf("\n{\"operation\":\"%s\",\"requests\":%d,\"rps\":%.1f,\"p50\":%.3f,\"p95\":%.3f,\"p99\":%.3f,\"max\":%.3f}", ops[j], num_times, num_times / elapsed, 1000.0 * times[(num_times - 1) * 50 / 100], 1000.0 * times[(num_times - 1) * 95 / 100], 1000.0 * times[(num_times - 1) * 99 / 100], 1000.0 * times[num_times - 1]);
 
-    // Poll job status until completed...
-    do
-    {
-      sleep(1);
+    num_requests_total += num_times;
+  }
 
-      request = ippNewRequest(IPP_OP_GET_JOB_ATTRIBUTES);
-      ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, uri);
-      ippAddInteger(request, IPP_TAG_OPERATION, IPP_TAG_INTEGER, "job-id", job_id);
-      ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+  for (i = 0; i < num_clients; i ++)
+    num_errors += loads[i].num_errors;
 
-      response = cupsDoRequest(http, request, "/ipp/print");
+  printf("\n{\"operation\":\"total\",\"clients\":%d,\"requests\":%d,\"errors\":%d,\"seconds\":%.3f,\"rps\":%.1f}\nload: ", num_clients, num_requests_total, num_errors, elapsed, num_requests_total / elapsed);
 
-      if (cupsLastError() >= IPP_STATUS_ERROR_BAD_REQUEST)
-      {
-	printf("FAIL (Unable to get job state for '%s': %s)\n", job_name, cupsLastErrorString());
-        goto done;
-      }
+  if (num_errors)
+    printf("FAIL (%d of %d requests failed)\n", num_errors, num_requests_total);
+  else
+    ret = true;
 
-      job_state = (ipp_jstate_t)ippGetInteger(ippFindAttribute(response, "job-state", IPP_TAG_ENUM), 0);
+  done:
 
-      ippDelete(response);
+  if (loads)
+  {
+    for (i = 0; i < num_clients; i ++)
+    {
+      for (j = 0; j < _PAPPL_LOADOP_MAX; j ++)
+        free(loads[i].times[j]);
     }
-    while (job_state < IPP_JSTATE_CANCELED);
 
-    // Cleanup...
-    unlink(filename);
+    free(loads);
   }
 
-  // If we complete the loop without errors, it is a successful run...
-  ret = true;
-
-  done:
+  free(threads);
+  free(times);
 
-  if (filename[0])
-    unlink(filename);
+  if (rasterfile[0])
+    unlink(rasterfile);
 
   httpClose(http);
   ippDelete(supported);
@@ -1273,11 +1882,998 @@ test_pwg_raster(pappl_system_t *system)	// I - System
 
 
 //
-// 'usage()' - Show usage.
+// 'test_load_client()' - Send a mix of requests from a single client.
 //
 
-static int				// O - Exit status
-usage(int status)			// I - Exit status
+static void *				// O - Thread exit status
+test_load_client(
+    _pappl_testload_t *load)		// I - Client data
+{
+  int		i;			// Looping var
+  http_t	*http;			// HTTP connection
+  char		uri[1024];		// "printer-uri" value
+  ipp_t		*request,		// IPP request
+		*response;		// IPP response
+  ipp_status_t	status;			// IPP status
+  _pappl_loadop_t op;			// Current operation
+  int		slot,			// Slot in the weighted mix
+		total,			// Total of weights
+		num_prints = 0,		// Number of Print-Job requests
+		job_id = 0;		// Last "job-id" value
+  double	start;			// Start time of request
+
+
+  if ((http = connect_to_printer(load->system, uri, sizeof(uri))) == NULL)
+  {
+    load->num_errors = load->num_requests;
+    return (NULL);
+  }
+
+  total = load->mix[0] + load->mix[1] + load->mix[2] + load->mix[3];
+
+  for (i = 0; i < load->num_requests && !papplSystemIsShutdown(load->system); i ++)
+  {
+    // Pick the next operation from the weighted mix...
+    slot = i % total;
+
+    if (slot < load->mix[0])
+      op = _PAPPL_LOADOP_GET_PRINTER_ATTRIBUTES;
+    else if ((slot -= load->mix[0]) < load->mix[1])
+      op = _PAPPL_LOADOP_GET_JOBS;
+    else if ((slot -= load->mix[1]) < load->mix[2] || !job_id)
+      op = _PAPPL_LOADOP_PRINT_JOB_RASTER;
+    else
+      op = _PAPPL_LOADOP_CANCEL_JOB;
+
+    if (op == _PAPPL_LOADOP_PRINT_JOB_RASTER && load->jpegfile && (num_prints ++) & 1)
+      op = _PAPPL_LOADOP_PRINT_JOB_JPEG;
+
+    // Build the request...
+    switch (op)
+    {
+      case _PAPPL_LOADOP_GET_PRINTER_ATTRIBUTES :
+          request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
+          break;
+      case _PAPPL_LOADOP_GET_JOBS :
+          request = ippNewRequest(IPP_OP_GET_JOBS);
+          break;
+      case _PAPPL_LOADOP_CANCEL_JOB :
+          request = ippNewRequest(IPP_OP_CANCEL_JOB);
+          break;
+      default :
+          request = ippNewRequest(IPP_OP_PRINT_JOB);
+          break;
+    }
+
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, uri);
+
+    if (op == _PAPPL_LOADOP_CANCEL_JOB)
+      ippAddInteger(request, IPP_TAG_OPERATION, IPP_TAG_INTEGER, "job-id", job_id);
+
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+
+    if (op == _PAPPL_LOADOP_PRINT_JOB_RASTER)
+    {
+      ippAddString(request, IPP_TAG_OPERATION, IPP_CONST_TAG(IPP_TAG_MIMETYPE), "document-format", NULL, "image/pwg-raster");
+      ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "job-name", NULL, "load-pwg-raster");
+    }
+    else if (op == _PAPPL_LOADOP_PRINT_JOB_JPEG)
+    {
+      ippAddString(request, IPP_TAG_OPERATION, IPP_CONST_TAG(IPP_TAG_MIMETYPE), "document-format", NULL, "image/jpeg");
+      ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "job-name", NULL, "load-jpeg");
+    }
+
+    // Send it and record the latency...
+    start = get_time();
+
+    if (op == _PAPPL_LOADOP_PRINT_JOB_RASTER)
+      response = cupsDoFileRequest(http, request, "/ipp/print", load->rasterfile);
+    else if (op == _PAPPL_LOADOP_PRINT_JOB_JPEG)
+      response = cupsDoFileRequest(http, request, "/ipp/print", load->jpegfile);
+    else
+      response = cupsDoRequest(http, request, "/ipp/print");
+
+    load->times[op][load->num_times[op] ++] = get_time() - start;
+
+    status = cupsLastError();
+
+    if (op == _PAPPL_LOADOP_PRINT_JOB_RASTER || op == _PAPPL_LOADOP_PRINT_JOB_JPEG)
+      job_id = ippGetInteger(ippFindAttribute(response, "job-id", IPP_TAG_INTEGER), 0);
+    else if (op == _PAPPL_LOADOP_CANCEL_JOB)
+      job_id = 0;
+
+    ippDelete(response);
+
+    // A job that has already completed cannot be canceled, which is fine...
+    if (status >= IPP_STATUS_ERROR_BAD_REQUEST && (op != _PAPPL_LOADOP_CANCEL_JOB || status != IPP_STATUS_ERROR_NOT_POSSIBLE))
+      load->num_errors ++;
+  }
+
+  httpClose(http);
+
+  return (NULL);
+}
+
+
+//
+// 'test_log()' - Test filtering of the log file.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_log(pappl_system_t *system)	// I - System
+{
+  pappl_printer_t	*printer;	// Default printer
+  _pappl_logfilter_t	filter;		// Log filter
+  char			prefix[256],	// Expected prefix after timestamp
+			*text,		// Log text
+			*line,		// Current line
+			*next;		// Next line
+  off_t			start,		// Start of log data
+			end,		// Next log offset
+			size;		// Size of log file
+  int			i,		// Looping var
+			count,		// Number of matching lines
+			job_id;		// Job ID
+  size_t		prefixlen;	// Length of prefix
+  http_t		*http;		// HTTP connection
+  http_status_t		status;		// HTTP status
+  char			uri[1024],	// Printer URI (unused)
+			buffer[65536];	// Response body
+  long			first,		// First byte in Content-Range
+			last,		// Last byte in Content-Range
+			total;		// Total bytes in Content-Range
+  static const char * const titles[] =	// Test titles
+  {
+    "all",
+    "level=warn",
+    "printer",
+    "printer+job"
+  };
+
+
+  if ((printer = papplSystemFindPrinter(system, "/ipp/print", 0, NULL)) == NULL)
+  {
+    puts("FAIL (no default printer)");
+    return (false);
+  }
+
+  job_id = papplPrinterGetNextJobID(printer) - 1;
+
+  for (i = 0; i < (int)(sizeof(titles) / sizeof(titles[0])); i ++)
+  {
+    printf("\nlog: %s ", titles[i]);
+
+    memset(&filter, 0, sizeof(filter));
+
+    filter.offset   = -1;
+    filter.lines    = 100000;
+    filter.maxbytes = 1048576;
+    filter.level    = i == 1 ? PAPPL_LOGLEVEL_WARN : PAPPL_LOGLEVEL_UNSPEC;
+
+    if (i == 2)
+    {
+      filter.printer = papplPrinterGetName(printer);
+      snprintf(prefix, sizeof(prefix), "[Printer %s] ", filter.printer);
+    }
+    else if (i == 3)
+    {
+      if (job_id < 1)
+      {
+        fputs("SKIP (no jobs)", stdout);
+        continue;
+      }
+
+      filter.printer = papplPrinterGetName(printer);
+      filter.job_id  = job_id;
+      snprintf(prefix, sizeof(prefix), "[Printer %s] [Job %d] ", filter.printer, job_id);
+    }
+    else
+      prefix[0] = '\0';
+
+    prefixlen = strlen(prefix);
+
+    if ((text = _papplLogCopyTail(system, &filter, &start, &end, &size)) == NULL)
+    {
+      if (i == 0)
+      {
+        // Not logging to a file...
+        fputs("SKIP (no log file)", stdout);
+        return (true);
+      }
+
+      printf("FAIL (%s)\n", strerror(errno));
+      return (false);
+    }
+
+    for (line = text, count = 0; *line; line = next, count ++)
+    {
+      if ((next = strchr(line, '\n')) != NULL)
+        *next++ = '\0';
+      else
+        next = line + strlen(line);
+
+      // Lines start with "L [YYYY-MM-DDTHH:MM:SS.SSSZ] "...
+      if (!strchr(i == 1 ? "WEF" : "DIWEF", *line) || line[1] != ' ' || line[2] != '[')
+      {
+        printf("FAIL (bad level in '%s')\n", line);
+        free(text);
+        return (false);
+      }
+
+      if (prefixlen > 0 && (strlen(line) < (29 + prefixlen) || strncmp(line + 29, prefix, prefixlen)))
+      {
+        printf("FAIL (expected '%s' in '%s')\n", prefix, line);
+        free(text);
+        return (false);
+      }
+    }
+
+    free(text);
+
+    if (count == 0 && i != 1)
+    {
+      puts("FAIL (no lines)");
+      return (false);
+    }
+
+    printf("PASS (%d lines)", count);
+  }
+
+  // Job IDs are only unique for a printer, so the job filter needs a printer
+  // and job lines must appear in the printer's log...
+  if (job_id > 0)
+  {
+    fputs("\nlog: printer includes jobs ", stdout);
+
+    memset(&filter, 0, sizeof(filter));
+
+    filter.offset   = -1;
+    filter.lines    = 100000;
+    filter.maxbytes = 1048576;
+    filter.level    = PAPPL_LOGLEVEL_UNSPEC;
+    filter.printer  = papplPrinterGetName(printer);
+
+    snprintf(prefix, sizeof(prefix), "] [Job %d] ", job_id);
+
+    if ((text = _papplLogCopyTail(system, &filter, &start, &end, &size)) == NULL || !strstr(text, prefix))
+    {
+      puts("FAIL (no job lines)");
+      free(text);
+      return (false);
+    }
+
+    free(text);
+
+    fputs("PASS", stdout);
+  }
+
+  // Unfiltered lines are a byte range of the log file, filtered lines are not
+  // so they must not have a Content-Range header...
+  fputs("\nlog: /logfile.txt ", stdout);
+
+  if ((http = connect_to_printer(system, uri, sizeof(uri))) == NULL)
+  {
+    printf("FAIL (Unable to connect: %s)\n", cupsLastErrorString());
+    return (false);
+  }
+
+  if ((status = get_resource(http, "/logfile.txt?lines=10", buffer, sizeof(buffer))) == HTTP_STATUS_UNAUTHORIZED)
+  {
+    fputs("SKIP (authentication required)", stdout);
+    httpClose(http);
+    return (true);
+  }
+  else if (status != HTTP_STATUS_PARTIAL_CONTENT)
+  {
+    printf("FAIL (Got %d %s, expected 206)\n", status, httpStatus(status));
+    httpClose(http);
+    return (false);
+  }
+  else if (sscanf(httpGetField(http, HTTP_FIELD_CONTENT_RANGE), "bytes %ld-%ld/%ld", &first, &last, &total) != 3 || (size_t)(last - first + 1) != strlen(buffer))
+  {
+    printf("FAIL (Bad Content-Range '%s' for %u bytes)\n", httpGetField(http, HTTP_FIELD_CONTENT_RANGE), (unsigned)strlen(buffer));
+    httpClose(http);
+    return (false);
+  }
+  else if (!strstr(httpGetField(http, HTTP_FIELD_LINK), "offset="))
+  {
+    printf("FAIL (Bad Link '%s')\n", httpGetField(http, HTTP_FIELD_LINK));
+    httpClose(http);
+    return (false);
+  }
+
+  fputs("PASS", stdout);
+
+  fputs("\nlog: /logfile.txt?level=warn ", stdout);
+
+  if ((status = get_resource(http, "/logfile.txt?lines=1000&level=warn", buffer, sizeof(buffer))) != HTTP_STATUS_OK && status != HTTP_STATUS_NO_CONTENT)
+  {
+    printf("FAIL (Got %d %s, expected 200)\n", status, httpStatus(status));
+    httpClose(http);
+    return (false);
+  }
+  else if (httpGetField(http, HTTP_FIELD_CONTENT_RANGE)[0])
+  {
+    printf("FAIL (Unexpected Content-Range '%s')\n", httpGetField(http, HTTP_FIELD_CONTENT_RANGE));
+    httpClose(http);
+    return (false);
+  }
+  else if (status == HTTP_STATUS_OK && !strstr(httpGetField(http, HTTP_FIELD_LINK), "&level=warn>"))
+  {
+    printf("FAIL (Bad Link '%s')\n", httpGetField(http, HTTP_FIELD_LINK));
+    httpClose(http);
+    return (false);
+  }
+
+  httpClose(http);
+
+  fputs("PASS", stdout);
+
+  return (true);
+}
+
+
+//
+// 'test_pwg_raster()' - Run PWG Raster tests.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_pwg_raster(pappl_system_t *system)	// I - System
+{
+  bool		ret = false;		// Return value
+  http_t	*http = NULL;		// HTTP connection
+  char		uri[1024],		// "printer-uri" value
+		filename[1024] = "",	// Print file
+		job_name[1024];		// "job_name" value
+  ipp_t		*request,		// IPP request
+		*response,		// IPP response
+		*supported = NULL;	// Supported attributes
+  ipp_attribute_t *mode_supported;	// "print-color-mode-supported" attribute
+  int		i;			// Looping var
+  int		job_id;			// "job-id" value
+  ipp_jstate_t	job_state;		// "job-state" value
+  pappl_printer_t *printer;		// Printer
+  http_status_t	status;			// HTTP status
+  char		resource[256],		// "jobs.json" resource
+		buffer[8192],		// Response body
+		*ptr;			// Pointer into response
+  int		total,			// Total number of jobs
+		cursor;			// Job ID cursor
+  static const char * const modes[] =	// "print-color-mode" values
+  {
+    "auto",
+    "auto-monochrome",
+    "color",
+    "monochrome"
+  };
+
+
+  // Connect to system...
+  if ((http = connect_to_printer(system, uri, sizeof(uri))) == NULL)
+  {
+    printf("FAIL (Unable to connect: %s)\n", cupsLastErrorString());
+    return (false);
+  }
+
+  // Get printer capabilities
+  fputs("Get-Printer-Attributes: ", stdout);
+
+  request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, "ipp://localhost/ipp/print");
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+
+  supported = cupsDoRequest(http, request, "/ipp/print");
+
+  if (cupsLastError() != IPP_STATUS_OK)
+  {
+    printf("FAIL (%s)\n", cupsLastErrorString());
+    goto done;
+  }
+
+  if ((mode_supported = ippFindAttribute(supported, "print-color-mode-supported", IPP_TAG_KEYWORD)) == NULL)
+  {
+    puts("FAIL (Missing required 'print-color-mode-supported' attribute in response)");
+    goto done;
+  }
+
+  // Loop through the supported print-color-mode values...
+  for (i = 0; i < (int)(sizeof(modes) / sizeof(modes[0])); i ++)
+  {
+    // Make raster data for this mode...
+    printf("\npwg-raster: %s: ", modes[i]);
+    fflush(stdout);
+
+    if (!ippContainsString(mode_supported, modes[i]))
+      continue;				// Not supported, skip
+
+    if (!make_raster_file(supported, strstr(modes[i], "monochrome") != NULL, filename, sizeof(filename)))
+      break;				// Error
+
+    // Print the file...
+    snprintf(job_name, sizeof(job_name), "pwg-raster-%s", modes[i]);
+
+    request = ippNewRequest(IPP_OP_PRINT_JOB);
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, uri);
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+    ippAddString(request, IPP_TAG_OPERATION, IPP_CONST_TAG(IPP_TAG_MIMETYPE), "document-format", NULL, "image/pwg-raster");
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "job-name", NULL, job_name);
+
+    ippAddString(request, IPP_TAG_JOB, IPP_TAG_KEYWORD, "print-color-mode", NULL, modes[i]);
+
+    response = cupsDoFileRequest(http, request, "/ipp/print", filename);
+
+    if (cupsLastError() >= IPP_STATUS_ERROR_BAD_REQUEST)
+    {
+      printf("FAIL (Unable to print %s: %s)\n", job_name, cupsLastErrorString());
+      goto done;
+    }
+
+    job_id = ippGetInteger(ippFindAttribute(response, "job-id", IPP_TAG_INTEGER), 0);
+
+    ippDelete(response);
+
+    printf("job-id=%d ", job_id);
+    fflush(stdout);
+
+    // Poll job status until completed...
+    do
+    {
+      sleep(1);
+
+      request = ippNewRequest(IPP_OP_GET_JOB_ATTRIBUTES);
+      ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, uri);
+      ippAddInteger(request, IPP_TAG_OPERATION, IPP_TAG_INTEGER, "job-id", job_id);
+      ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+
+      response = cupsDoRequest(http, request, "/ipp/print");
+
+      if (cupsLastError() >= IPP_STATUS_ERROR_BAD_REQUEST)
+      {
+	printf("FAIL (Unable to get job state for '%s': %s)\n", job_name, cupsLastErrorString());
+        goto done;
+      }
+
+      job_state = (ipp_jstate_t)ippGetInteger(ippFindAttribute(response, "job-state", IPP_TAG_ENUM), 0);
+
+      ippDelete(response);
+    }
+    while (job_state < IPP_JSTATE_CANCELED);
+
+    // Cleanup...
+    unlink(filename);
+  }
+
+  // Page through the job history, which now includes the jobs printed above,
+  // one job at a time...
+  fputs("\npwg-raster: jobs.json ", stdout);
+
+  if ((printer = papplSystemFindPrinter(system, "/ipp/print", 0, NULL)) == NULL)
+  {
+    puts("FAIL (Unable to find printer)");
+    goto done;
+  }
+
+  papplPrinterGetPath(printer, "jobs.json?limit=1", resource, sizeof(resource));
+
+  if ((status = get_resource(http, resource, buffer, sizeof(buffer))) == HTTP_STATUS_UNAUTHORIZED)
+  {
+    fputs("SKIP (authentication required)", stdout);
+    ret = true;
+    goto done;
+  }
+  else if (status != HTTP_STATUS_OK)
+  {
+    printf("FAIL (Got %d %s, expected 200)\n", status, httpStatus(status));
+    goto done;
+  }
+  else if ((ptr = strstr(buffer, "\"total\":")) == NULL || (total = atoi(ptr + 8)) < 2)
+  {
+    printf("FAIL (Bad total in '%s')\n", buffer);
+    goto done;
+  }
+  else if ((ptr = strstr(buffer, "\"job-id\":")) == NULL || (job_id = atoi(ptr + 9)) < 1 || (ptr = strstr(buffer, "\"next-cursor\":")) == NULL || (cursor = atoi(ptr + 14)) != job_id)
+  {
+    printf("FAIL (Bad first page '%s')\n", buffer);
+    goto done;
+  }
+
+  ptr = resource + strlen(resource);
+  snprintf(ptr, sizeof(resource) - (size_t)(ptr - resource), "&cursor=%d", cursor);
+
+  if ((status = get_resource(http, resource, buffer, sizeof(buffer))) != HTTP_STATUS_OK)
+  {
+    printf("FAIL (Got %d %s, expected 200)\n", status, httpStatus(status));
+    goto done;
+  }
+  else if ((ptr = strstr(buffer, "\"job-id\":")) == NULL || (job_id = atoi(ptr + 9)) < 1 || job_id >= cursor || (ptr = strstr(buffer, "\"next-cursor\":")) == NULL || atoi(ptr + 14) != job_id)
+  {
+    printf("FAIL (Bad next page '%s' for cursor %d)\n", buffer, cursor);
+    goto done;
+  }
+
+  // If we complete the loop without errors, it is a successful run...
+  ret = true;
+
+  done:
+
+  if (filename[0])
+    unlink(filename);
+
+  httpClose(http);
+  ippDelete(supported);
+
+  return (ret);
+}
+
+
+//
+// 'test_ready()' - Test the readiness notification of the "server" sub-command.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_ready(const char *outdirname)	// I - Output directory
+{
+  bool			ret = false;	// Return value
+  int			i,		// Looping var
+			num_env,	// Number of environment variables
+			fds[2];		// Readiness pipe
+  pid_t			pid;		// Server process ID
+  int			status;		// Exit status
+  struct pollfd		pfd;		// Poll data
+  char			ready = '\0',	// Readiness byte
+			fdenv[64],	// PAPPL_READY_FD=N
+			tmpenv[1024],	// TMPDIR=outdirname
+			logopt[1100],	// Server options
+			sockname[1024],	// Server socket
+			statename[1024];// Server state file
+  char			**envp;		// Server environment
+  char			*argv[5];	// Server arguments
+  http_t		*http;		// Connection to server
+  ipp_t			*request,	// IPP request
+			*response;	// IPP response
+
+
+  fputs("\nready: testmainloop server ", stdout);
+
+  if (access("./testmainloop", X_OK))
+  {
+    fputs("SKIP (testmainloop not built)", stdout);
+    return (true);
+  }
+
+  // Run the server with its socket and state file in the output directory...
+  snprintf(sockname, sizeof(sockname), "%s/testmainloop%d.sock", outdirname, (int)getuid());
+  snprintf(statename, sizeof(statename), "%s/testmainloop%d.state", outdirname, (int)getuid());
+
+  if (strlen(sockname) >= sizeof(((struct sockaddr_un *)NULL)->sun_path))
+  {
+    fputs("SKIP (output directory name too long)", stdout);
+    return (true);
+  }
+
+  if (pipe(fds))
+  {
+    printf("FAIL (Unable to create pipe: %s)\n", strerror(errno));
+    return (false);
+  }
+
+  fcntl(fds[0], F_SETFD, fcntl(fds[0], F_GETFD) | FD_CLOEXEC);
+
+  // Pass the write end of the pipe and the temporary directory in an explicit
+  // environment since setenv is not safe with other threads running...
+  for (num_env = 0; environ[num_env]; num_env ++);
+
+  if ((envp = calloc((size_t)num_env + 3, sizeof(char *))) == NULL)
+  {
+    printf("FAIL (%s)\n", strerror(errno));
+    close(fds[0]);
+    close(fds[1]);
+    return (false);
+  }
+
+  snprintf(fdenv, sizeof(fdenv), "PAPPL_READY_FD=%d", fds[1]);
+  snprintf(tmpenv, sizeof(tmpenv), "TMPDIR=%s", outdirname);
+
+  envp[0] = fdenv;
+  envp[1] = tmpenv;
+
+  for (i = 0, num_env = 2; environ[i]; i ++)
+  {
+    if (strncmp(environ[i], "PAPPL_READY_FD=", 15) && strncmp(environ[i], "PAPPL_LISTEN_FD=", 16) && strncmp(environ[i], "TMPDIR=", 7))
+      envp[num_env ++] = environ[i];
+  }
+
+  snprintf(logopt, sizeof(logopt), "log-file=\"%s/ready.log\" log-level=debug", outdirname);
+
+  argv[0] = "testmainloop";
+  argv[1] = "server";
+  argv[2] = "-o";
+  argv[3] = logopt;
+  argv[4] = NULL;
+
+  status = posix_spawn(&pid, "./testmainloop", NULL, NULL, argv, envp);
+
+  free(envp);
+  close(fds[1]);
+
+  if (status)
+  {
+    printf("FAIL (Unable to start testmainloop: %s)\n", strerror(status));
+    close(fds[0]);
+    return (false);
+  }
+
+  fputs("PASS", stdout);
+
+  // The server writes "R" once it is listening on its socket...
+  fputs("\nready: PAPPL_READY_FD ", stdout);
+
+  pfd.fd     = fds[0];
+  pfd.events = POLLIN;
+
+  if (poll(&pfd, 1, 30000) <= 0)
+  {
+    puts("FAIL (No readiness notification after 30 seconds)");
+    goto done;
+  }
+  else if (read(fds[0], &ready, 1) != 1 || ready != 'R')
+  {
+    puts("FAIL (Server exited without sending a readiness notification)");
+    goto done;
+  }
+
+  fputs("PASS", stdout);
+
+  // A single connection attempt must now succeed...
+  fputs("\nready: Get-System-Attributes ", stdout);
+
+  if ((http = httpConnect2(sockname, 0, NULL, AF_UNSPEC, HTTP_ENCRYPTION_IF_REQUESTED, 1, 30000, NULL)) == NULL)
+  {
+    printf("FAIL (Unable to connect to '%s': %s)\n", sockname, cupsLastErrorString());
+    goto done;
+  }
+
+  request = ippNewRequest(IPP_OP_GET_SYSTEM_ATTRIBUTES);
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "system-uri", NULL, "ipp://localhost/ipp/system");
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsUser());
+
+  response = cupsDoRequest(http, request, "/ipp/system");
+
+  httpClose(http);
+  ippDelete(response);
+
+  if (cupsLastError() != IPP_STATUS_OK)
+  {
+    printf("FAIL (%s)\n", cupsLastErrorString());
+    goto done;
+  }
+
+  ret = true;
+
+  done:
+
+  close(fds[0]);
+
+  // Shut the server down, waiting up to 30 seconds before forcing it...
+  kill(pid, SIGTERM);
+
+  for (i = 0; i < 300 && waitpid(pid, &status, WNOHANG) == 0; i ++)
+    usleep(100000);
+
+  if (i >= 300)
+  {
+    kill(pid, SIGKILL);
+    waitpid(pid, &status, 0);
+  }
+
+  unlink(sockname);
+  unlink(statename);
+
+  return (ret);
+}
+
+
+//
+// 'test_save()' - Test saving and loading the system state.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_save(const char *outdirname)	// I - Output directory
+{
+  bool			ret = false;	// Return value
+  int			i,		// Looping var
+			job_ids[3];	// Job IDs
+  char			spooldir[1024],	// Spool directory
+			filename[1024],	// State filename
+			value[256];	// Printer value
+  pappl_system_t	*system,	// Saved system
+			*loaded = NULL;	// Loaded system
+  pappl_printer_t	*printer,	// Saved printer
+			*lprinter;	// Loaded printer
+  pappl_job_t		*job,		// Saved job
+			*ljob;		// Loaded job
+  time_t		curtime;	// Current time
+  static const ipp_jstate_t states[] =	// Job states
+  {
+    IPP_JSTATE_CANCELED,
+    IPP_JSTATE_ABORTED,
+    IPP_JSTATE_COMPLETED
+  };
+
+
+  // Use scratch systems with their own spool directory so that the job files
+  // cannot collide with those of the test system...
+  snprintf(spooldir, sizeof(spooldir), "%s/save.d", outdirname);
+  snprintf(filename, sizeof(filename), "%s/save.state", outdirname);
+
+  if ((system = papplSystemCreate(PAPPL_SOPTIONS_NONE, "Save System", 0, NULL, spooldir, "-", PAPPL_LOGLEVEL_ERROR, NULL, false)) == NULL)
+  {
+    puts("FAIL (Unable to create system)");
+    return (false);
+  }
+
+  papplSystemSetPrinterDrivers(system, (int)(sizeof(pwg_drivers) / sizeof(pwg_drivers[0])), pwg_drivers, pwg_autoadd, /* create_cb */NULL, pwg_callback, "testpappl");
+
+  if ((printer = papplPrinterCreate(system, /* printer_id */0, "Save Printer", "pwg_common-300dpi-600dpi-srgb_8", "MFG:PWG;MDL:Save Printer;", "file:///dev/null")) == NULL)
+  {
+    puts("FAIL (Unable to create printer)");
+    goto done;
+  }
+
+  papplPrinterSetLocation(printer, "Test Lab 42");
+  papplPrinterSetOrganization(printer, "Lakeside Robotics");
+  papplPrinterSetMaxActiveJobs(printer, 5);
+  papplPrinterSetMaxCompletedJobs(printer, 7);
+
+  // Create jobs that have stopped in different ways...
+  curtime = time(NULL);
+
+  for (i = 0; i < 3; i ++)
+  {
+    if ((job = _papplJobCreate(printer, 0, "save", "image/pwg-raster", "Save Job", NULL)) == NULL)
+    {
+      puts("FAIL (Unable to create job)");
+      goto done;
+    }
+
+    job_ids[i] = job->job_id;
+
+    pthread_rwlock_wrlock(&printer->rwlock);
+
+    job->state     = states[i];
+    job->completed = curtime - 60 + i;
+
+    _papplPrinterCompleteJob(printer, job);
+
+    pthread_rwlock_unlock(&printer->rwlock);
+  }
+
+  // Save and load the state...
+  if (!papplSystemSaveState(system, filename))
+  {
+    puts("FAIL (Unable to save state)");
+    goto done;
+  }
+
+  if ((loaded = papplSystemCreate(PAPPL_SOPTIONS_NONE, "Save System", 0, NULL, spooldir, "-", PAPPL_LOGLEVEL_ERROR, NULL, false)) == NULL)
+  {
+    puts("FAIL (Unable to create system)");
+    goto done;
+  }
+
+  papplSystemSetPrinterDrivers(loaded, (int)(sizeof(pwg_drivers) / sizeof(pwg_drivers[0])), pwg_drivers, pwg_autoadd, /* create_cb */NULL, pwg_callback, "testpappl");
+
+  if (!papplSystemLoadState(loaded, filename))
+  {
+    puts("FAIL (Unable to load state)");
+    goto done;
+  }
+
+  // Compare the printer and jobs...
+  if ((lprinter = papplSystemFindPrinter(loaded, NULL, papplPrinterGetID(printer), NULL)) == NULL)
+  {
+    puts("FAIL (Printer not loaded)");
+    goto done;
+  }
+  else if (strcmp(papplPrinterGetName(lprinter), papplPrinterGetName(printer)))
+  {
+    printf("FAIL (Printer name '%s', expected '%s')\n", papplPrinterGetName(lprinter), papplPrinterGetName(printer));
+    goto done;
+  }
+  else if (!papplPrinterGetLocation(lprinter, value, sizeof(value)) || strcmp(value, "Test Lab 42"))
+  {
+    puts("FAIL (Printer location not loaded)");
+    goto done;
+  }
+  else if (!papplPrinterGetOrganization(lprinter, value, sizeof(value)) || strcmp(value, "Lakeside Robotics"))
+  {
+    puts("FAIL (Printer organization not loaded)");
+    goto done;
+  }
+  else if (papplPrinterGetMaxActiveJobs(lprinter) != 5 || papplPrinterGetMaxCompletedJobs(lprinter) != 7)
+  {
+    printf("FAIL (Printer job limits %d/%d, expected 5/7)\n", papplPrinterGetMaxActiveJobs(lprinter), papplPrinterGetMaxCompletedJobs(lprinter));
+    goto done;
+  }
+  else if (papplPrinterGetNextJobID(lprinter) != papplPrinterGetNextJobID(printer))
+  {
+    printf("FAIL (Next job ID %d, expected %d)\n", papplPrinterGetNextJobID(lprinter), papplPrinterGetNextJobID(printer));
+    goto done;
+  }
+
+  for (i = 0; i < 3; i ++)
+  {
+    job = papplPrinterFindJob(printer, job_ids[i]);
+
+    if ((ljob = papplPrinterFindJob(lprinter, job_ids[i])) == NULL)
+    {
+      printf("FAIL (Job %d not loaded)\n", job_ids[i]);
+      goto done;
+    }
+    else if (papplJobGetState(ljob) != papplJobGetState(job) || papplJobGetTimeCompleted(ljob) != papplJobGetTimeCompleted(job) || strcmp(papplJobGetName(ljob), papplJobGetName(job)) || strcmp(papplJobGetUsername(ljob), papplJobGetUsername(job)))
+    {
+      printf("FAIL (Job %d changed)\n", job_ids[i]);
+      goto done;
+    }
+  }
+
+  ret = true;
+
+  done:
+
+  papplSystemDelete(loaded);
+  papplSystemDelete(system);
+  unlink(filename);
+  rmdir(spooldir);
+
+  return (ret);
+}
+
+
+//
+// 'test_state()' - Time loading of a generated state file.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_state(const char *name)		// I - Test name with options
+{
+  bool			ret = false;	// Return value
+  int			i, j,		// Looping vars
+			num_printers = 300,
+					// Number of printers
+			num_jobs = 10000,
+					// Number of jobs
+			job_id = 0,	// Current job ID
+			printer_jobs;	// Number of jobs for this printer
+  const char		*ptr;		// Pointer into test name
+  char			*end;		// End of number
+  cups_file_t		*fp;		// State file
+  char			filename[1024];	// State filename
+  pappl_system_t	*system;	// Scratch system
+  time_t		curtime;	// Current time
+  double		start,		// Start time
+			elapsed;	// Elapsed time
+  long			rss,		// Resident set size after loading
+			rss_attrs;	// ... and after creating driver attributes
+  bool			flush = false;	// Free driver attributes?
+
+
+  // Parse options from the test name...
+  if ((ptr = strchr(name, ':')) != NULL)
+  {
+    num_printers = (int)strtol(ptr + 1, &end, 10);
+
+    if (*end == ':')
+      num_jobs = (int)strtol(end + 1, NULL, 10);
+  }
+
+  if (num_printers < 1 || num_printers > 10000 || num_jobs < 0 || num_jobs > 10000000)
+  {
+    puts("FAIL (bad number of printers or jobs)");
+    return (false);
+  }
+
+  // Write a state file with completed jobs spread over the printers...
+  if ((fp = cupsTempFile2(filename, sizeof(filename))) == NULL)
+  {
+    printf("FAIL (Unable to create state file: %s)\n", cupsLastErrorString());
+    return (false);
+  }
+
+  curtime = time(NULL);
+
+  for (i = 0; i < num_printers; i ++)
+  {
+    cupsFilePrintf(fp, "<Printer name=\"Bench Printer %d\" id=%d did=\"MFG:PWG;MDL:Bench;\" uri=\"file:///dev/null\" driver=\"pwg_common-300dpi-600dpi-srgb_8\">\n", i + 1, i + 1);
+
+    printer_jobs = num_jobs / num_printers + (i < (num_jobs % num_printers));
+
+    cupsFilePrintf(fp, "MaxCompletedJobs %d\n", printer_jobs);
+    cupsFilePrintf(fp, "NextJobId %d\n", job_id + printer_jobs + 1);
+
+    for (j = 0; j < printer_jobs; j ++)
+    {
+      job_id ++;
+      cupsFilePrintf(fp, "Job id=%d name=\"Bench Job %d\" username=bench format=image/pwg-raster state=9 created=%ld processing=%ld completed=%ld impressions=1 imcompleted=1\n", job_id, job_id, (long)(curtime - 60), (long)(curtime - 59), (long)(curtime - 58));
+    }
+
+    cupsFilePuts(fp, "</Printer>\n");
+  }
+
+  cupsFileClose(fp);
+
+  // Load it into a scratch system...
+  if ((system = papplSystemCreate(PAPPL_SOPTIONS_NONE, "Bench System", 0, NULL, NULL, "-", PAPPL_LOGLEVEL_ERROR, NULL, false)) == NULL)
+  {
+    puts("FAIL (Unable to create system)");
+    unlink(filename);
+    return (false);
+  }
+
+  papplSystemSetPrinterDrivers(system, (int)(sizeof(pwg_drivers) / sizeof(pwg_drivers[0])), pwg_drivers, pwg_autoadd, /* create_cb */NULL, pwg_callback, "testpappl");
+
+  start = get_time();
+
+  if (!papplSystemLoadState(system, filename))
+  {
+    puts("FAIL (Unable to load state file)");
+    goto done;
+  }
+
+  elapsed = get_time() - start;
+
+  // Measure the memory used by the driver attributes, which are only created
+  // when a printer is used...
+  rss = get_rss();
+  papplSystemIteratePrinters(system, (pappl_printer_cb_t)test_state_attrs, &flush);
+  rss_attrs = get_rss();
+
+  flush = true;
+  papplSystemIteratePrinters(system, (pappl_printer_cb_t)test_state_attrs, &flush);
+
+  printf("\n{\"printers\":%d,\"jobs\":%d,\"seconds\":%.3f,\"jobs_per_second\":%.0f,\"rss_kb\":%ld,\"rss_driver_attrs_kb\":%ld}\nstate: ", num_printers, num_jobs, elapsed, num_jobs / elapsed, rss, rss_attrs);
+
+  ret = true;
+
+  done:
+
+  papplSystemDelete(system);
+  unlink(filename);
+
+  return (ret);
+}
+
+
+//
+// 'test_state_attrs()' - Create or free the driver attributes of a printer.
+//
+
+static void
+test_state_attrs(
+    pappl_printer_t *printer,		// I - Printer
+    bool            *flush)		// I - `true` to free, `false` to create
+{
+  if (*flush)
+  {
+    pthread_rwlock_wrlock(&printer->rwlock);
+    _papplPrinterFlushAttributes(printer, 0);
+  }
+  else
+  {
+    pthread_rwlock_rdlock(&printer->rwlock);
+    _papplPrinterGetDriverAttrsNoLock(printer);
+  }
+
+  pthread_rwlock_unlock(&printer->rwlock);
+}
+
+
+//
+// 'usage()' - Show usage.
+//
+
+static int				// O - Exit status
+usage(int status)			// I - Exit status
 {
   puts("Usage: testpappl [OPTIONS] [\"SERVER NAME\"]");
   puts("Options:");
@@ -1301,10 +2897,24 @@ usage(int status)			// I - Exit status
   puts("");
   puts("Tests:");
   puts("  all                  All of the following tests");
+  puts("  clean                Completed job cleanup tests");
   puts("  client               Simulated client tests");
   puts("  jpeg                 JPEG image tests");
   puts("  png                  PNG image tests");
   puts("  pwg-raster           PWG Raster tests");
+  puts("  log                  Log file filter tests");
+  puts("  ready                Server readiness notification tests");
+  puts("  save                 State file save and load tests");
+  puts("");
+  puts("Benchmarks:");
+  puts("  load[:CLIENTS[:REQUESTS[:MIX]]]");
+  puts("                       Multi-client IPP load benchmark; MIX is a comma-");
+  puts("                       separated list of Get-Printer-Attributes, Get-Jobs,");
+  puts("                       Print-Job, and Cancel-Job weights (default 4,4,1,1)");
+  puts("  state[:PRINTERS[:JOBS]]");
+  puts("                       papplSystemLoadState benchmark with a generated state");
+  puts("                       file (default 300 printers and 10000 completed jobs),");
+  puts("                       also reports the memory used by driver attributes");
 
   return (status);
 }
@@ -0,0 +1,649 @@
+//
+// Raster pipeline benchmark for the Printer Application Framework
+//
+// Copyright © 2020-2021 by Michael R Sweet.
+//
+// Licensed under Apache License v2.0.  See the file "LICENSE" for more
+// information.
+//
+// Usage:
+//
+//   testraster [OPTIONS] [FILENAME(S)]
+//
+// Options:
+//
+//   --help               Show help
+//   -l LOG-FILE          Set the log file (default none)
+//   -L LOG-LEVEL         Set the log level (fatal, error, warn, info, debug)
+//   -n COUNT             Number of pages per driver and file (default 3)
+//
+// Each file (the bundled JPEG and PNG test images by default) plus a generated
+// page is printed through the job pipeline to each of the PWG test drivers
+// using a null ("file:///dev/null") device.  One JSON object is written per
+// driver and file with the throughput, per-stage times in milliseconds, and
+// peak resident set size.
+//
+
+//
+// Include necessary headers...
+//
+
+#include <pappl/job-private.h>
+#include "testpappl.h"
+#include <sys/resource.h>
+#include <sys/time.h>
+
+
+//
+// Local types...
+//
+
+typedef struct _pappl_rbench_s		// Benchmark data for the current job
+{
+  const char		*filename;	// Input file or `NULL` for generated
+  const char		*format;	// MIME media type of input file
+  double		filter_start,	// Start of filter
+			filter_end,	// End of filter
+			raster_start,	// Start of raster output
+			driver;		// Time spent in driver callbacks
+  size_t		bytes;		// Raster bytes written
+  unsigned		pages;		// Pages written
+} _pappl_rbench_t;
+
+
+//
+// Local globals...
+//
+
+static _pappl_rbench_t		bench;	// Benchmark data for the current job
+static pappl_pr_rendjob_cb_t	pwg_rendjob;
+					// PWG driver end job callback
+static pappl_pr_rendpage_cb_t	pwg_rendpage;
+					// PWG driver end page callback
+static pappl_pr_rstartjob_cb_t	pwg_rstartjob;
+					// PWG driver start job callback
+static pappl_pr_rstartpage_cb_t	pwg_rstartpage;
+					// PWG driver start page callback
+static pappl_pr_rwriteline_cb_t	pwg_rwriteline;
+					// PWG driver write line callback
+
+
+//
+// Local functions...
+//
+
+static bool	bench_driver_cb(pappl_system_t *system, const char *driver_name, const char *device_uri, const char *device_id, pappl_pr_driver_data_t *driver_data, ipp_t **driver_attrs, void *data);
+static bool	bench_filter_cb(pappl_job_t *job, pappl_device_t *device, void *data);
+static bool	bench_rendjob(pappl_job_t *job, pappl_pr_options_t *options, pappl_device_t *device);
+static bool	bench_rendpage(pappl_job_t *job, pappl_pr_options_t *options, pappl_device_t *device, unsigned page);
+static bool	bench_rstartjob(pappl_job_t *job, pappl_pr_options_t *options, pappl_device_t *device);
+static bool	bench_rstartpage(pappl_job_t *job, pappl_pr_options_t *options, pappl_device_t *device, unsigned page);
+static bool	bench_rwriteline(pappl_job_t *job, pappl_pr_options_t *options, pappl_device_t *device, unsigned y, const unsigned char *line);
+static bool	generate_page(pappl_job_t *job, pappl_device_t *device);
+static double	get_time(void);
+static int	usage(int status);
+
+
+//
+// 'main()' - Main entry for benchmark.
+//
+
+int					// O - Exit status
+main(int  argc,				// I - Number of command-line arguments
+     char *argv[])			// I - Command-line arguments
+{
+  int			i, j, k;	// Looping vars
+  const char		*opt,		// Current option
+			*log = NULL;	// Log file, if any
+  pappl_loglevel_t	level = PAPPL_LOGLEVEL_WARN;
+					// Log level
+  int			count = 3;	// Pages per driver and file
+  int			num_files = 0;	// Number of files
+  const char		*files[100];	// Files
+  char			filenames[100][1024];
+					// Resolved filenames
+  pappl_system_t	*system;	// System
+  pappl_printer_t	*printer;	// Printer
+  pappl_job_t		*job;		// Job
+  ipp_t			*attrs;		// Job attributes
+  double		decode,		// Decode/generate time
+			scale_dither,	// Scale/dither time
+			driver,		// Driver time
+			total;		// Total filter time
+  size_t		bytes;		// Raster bytes
+  unsigned		pages;		// Pages
+  struct rusage		usage_info;	// Resource usage
+  int			status = 0;	// Exit status
+  static const char * const def_files[] =
+  {					// Default files
+#ifdef HAVE_LIBJPEG
+    "portrait-gray.jpg",
+    "portrait-color.jpg",
+#endif // HAVE_LIBJPEG
+#ifdef HAVE_LIBPNG
+    "portrait-gray.png",
+    "portrait-color.png",
+#endif // HAVE_LIBPNG
+    NULL
+  };
+  static const struct
+  {
+    const char	*driver;		// Driver name
+    int		resolution;		// Resolution
+    const char	*mode;			// "print-color-mode" value
+  }			configs[] =	// Benchmark configurations
+  {
+    { "pwg_4inch-203dpi-black_1",		203, "monochrome" },
+    { "pwg_common-300dpi-black_1",		300, "monochrome" },
+    { "pwg_common-300dpi-sgray_8",		300, "monochrome" },
+    { "pwg_common-300dpi-srgb_8",		300, "color" },
+    { "pwg_common-300dpi-600dpi-black_1",	600, "monochrome" },
+    { "pwg_common-300dpi-600dpi-sgray_8",	600, "monochrome" },
+    { "pwg_common-300dpi-600dpi-srgb_8",	600, "color" }
+  };
+
+
+  // Parse command-line options...
+  for (i = 1; i < argc; i ++)
+  {
+    if (!strcmp(argv[i], "--help"))
+    {
+      return (usage(0));
+    }
+    else if (!strncmp(argv[i], "--", 2))
+    {
+      printf("testraster: Unknown option '%s'.\n", argv[i]);
+      return (usage(1));
+    }
+    else if (argv[i][0] == '-')
+    {
+      for (opt = argv[i] + 1; *opt; opt ++)
+      {
+        switch (*opt)
+        {
+	  case 'l' : // -l LOG-FILE
+	      i ++;
+	      if (i >= argc)
+	      {
+	        puts("testraster: Expected log file after '-l'.");
+	        return (usage(1));
+	      }
+	      log = argv[i];
+	      break;
+	  case 'L' : // -L LOG-LEVEL
+	      i ++;
+	      if (i >= argc)
+	      {
+	        puts("testraster: Expected log level after '-L'.");
+	        return (usage(1));
+	      }
+
+	      if (!strcmp(argv[i], "fatal"))
+	      {
+		level = PAPPL_LOGLEVEL_FATAL;
+	      }
+	      else if (!strcmp(argv[i], "error"))
+	      {
+		level = PAPPL_LOGLEVEL_ERROR;
+	      }
+	      else if (!strcmp(argv[i], "warn"))
+	      {
+		level = PAPPL_LOGLEVEL_WARN;
+	      }
+	      else if (!strcmp(argv[i], "info"))
+	      {
+		level = PAPPL_LOGLEVEL_INFO;
+	      }
+	      else if (!strcmp(argv[i], "debug"))
+	      {
+		level = PAPPL_LOGLEVEL_DEBUG;
+	      }
+	      else
+	      {
+	        printf("testraster: Unknown log level '%s'.\n", argv[i]);
+	        return (usage(1));
+	      }
+	      break;
+	  case 'n' : // -n COUNT
+	      i ++;
+	      if (i >= argc || (count = atoi(argv[i])) < 1)
+	      {
+	        puts("testraster: Expected page count after '-n'.");
+	        return (usage(1));
+	      }
+	      break;
+	  default :
+	      printf("testraster: Unknown option '-%c'.\n", *opt);
+	      return (usage(1));
+	}
+      }
+    }
+    else if (num_files < (int)(sizeof(files) / sizeof(files[0])))
+    {
+      files[num_files ++] = argv[i];
+    }
+    else
+    {
+      puts("testraster: Too many files.");
+      return (1);
+    }
+  }
+
+  if (num_files == 0)
+  {
+    for (i = 0; def_files[i]; i ++)
+      files[num_files ++] = def_files[i];
+  }
+
+  // Resolve and check the files...
+  for (i = 0; i < num_files; i ++)
+  {
+    const char *ext = strrchr(files[i], '.');
+					// Extension on filename
+
+    if (access(files[i], R_OK))
+      snprintf(filenames[i], sizeof(filenames[i]), "testsuite/%s", files[i]);
+    else
+      strlcpy(filenames[i], files[i], sizeof(filenames[i]));
+
+    if (access(filenames[i], R_OK))
+    {
+      printf("testraster: Unable to access '%s': %s\n", files[i], strerror(errno));
+      return (1);
+    }
+
+    if (!ext || (strcmp(ext, ".jpg") && strcmp(ext, ".jpeg") && strcmp(ext, ".png")))
+    {
+      printf("testraster: Unsupported file '%s'.\n", files[i]);
+      return (1);
+    }
+#ifndef HAVE_LIBJPEG
+    else if (strcmp(ext, ".png"))
+    {
+      printf("testraster: JPEG support not available for '%s'.\n", files[i]);
+      return (1);
+    }
+#endif // !HAVE_LIBJPEG
+#ifndef HAVE_LIBPNG
+    else if (!strcmp(ext, ".png"))
+    {
+      printf("testraster: PNG support not available for '%s'.\n", files[i]);
+      return (1);
+    }
+#endif // !HAVE_LIBPNG
+  }
+
+  // Create a system that is never run and route all jobs through the
+  // benchmark filter...
+  if ((system = papplSystemCreate(PAPPL_SOPTIONS_MULTI_QUEUE, "Raster Benchmark", 0, NULL, NULL, log ? log : "-", log ? level : PAPPL_LOGLEVEL_FATAL, NULL, false)) == NULL)
+  {
+    printf("testraster: Unable to create system: %s\n", strerror(errno));
+    return (1);
+  }
+
+  papplSystemSetPrinterDrivers(system, (int)(sizeof(pwg_drivers) / sizeof(pwg_drivers[0])), pwg_drivers, /*autoadd_cb*/NULL, /*create_cb*/NULL, bench_driver_cb, "testraster");
+  papplSystemAddMIMEFilter(system, "application/vnd.pappl-benchmark", "image/pwg-raster", bench_filter_cb, NULL);
+
+  for (i = 0; i < (int)(sizeof(configs) / sizeof(configs[0])) && !status; i ++)
+  {
+    if ((printer = papplPrinterCreate(system, /* printer_id */0, configs[i].driver, configs[i].driver, "MFG:PWG;MDL:Benchmark Printer;", "file:///dev/null")) == NULL)
+    {
+      printf("testraster: Unable to create printer '%s': %s\n", configs[i].driver, strerror(errno));
+      status = 1;
+      break;
+    }
+
+    for (j = -1; j < num_files && !status; j ++)
+    {
+      bytes        = 0;
+      decode       = 0.0;
+      driver       = 0.0;
+      pages        = 0;
+      scale_dither = 0.0;
+      total        = 0.0;
+
+      for (k = 0; k < count; k ++)
+      {
+        // Reset the benchmark data for this job...
+        memset(&bench, 0, sizeof(bench));
+
+        if (j >= 0)
+        {
+          bench.filename = filenames[j];
+          bench.format   = strstr(filenames[j], ".png") ? "image/png" : "image/jpeg";
+	}
+
+        // Create and run the job...
+        attrs = ippNew();
+        ippAddString(attrs, IPP_TAG_JOB, IPP_TAG_KEYWORD, "print-color-mode", NULL, configs[i].mode);
+        ippAddResolution(attrs, IPP_TAG_JOB, "printer-resolution", IPP_RES_PER_INCH, configs[i].resolution, configs[i].resolution);
+
+        job = _papplJobCreate(printer, 0, "benchmark", "application/vnd.pappl-benchmark", j >= 0 ? files[j] : "generated", attrs);
+
+        ippDelete(attrs);
+
+        if (!job)
+        {
+          printf("testraster: Unable to create job: %s\n", strerror(errno));
+          status = 1;
+          break;
+        }
+
+        _papplJobSubmitFile(job, j >= 0 ? filenames[j] : "/dev/null");
+
+        while (papplJobGetState(job) < IPP_JSTATE_CANCELED)
+          usleep(1000);
+
+        if (papplJobGetState(job) != IPP_JSTATE_COMPLETED)
+        {
+          printf("testraster: Job for '%s' on '%s' did not complete.\n", j >= 0 ? files[j] : "generated", configs[i].driver);
+          status = 1;
+          break;
+        }
+
+        // Accumulate the stage times...
+        bytes        += bench.bytes;
+        decode       += bench.raster_start - bench.filter_start;
+        driver       += bench.driver;
+        pages        += bench.pages;
+        scale_dither += bench.filter_end - bench.raster_start - bench.driver;
+        total        += bench.filter_end - bench.filter_start;
+      }
+
+      if (status || !pages || total <= 0.0)
+        continue;
+
+      getrusage(RUSAGE_SELF, &usage_info);
+
+      printf("{\"driver\":\"%s\",\"resolution\":%d,\"color-mode\":\"%s\",\"input\":\"%s\",\"pages\":%u,\"pages-per-second\":%.2f,\"mb-per-second\":%.2f,\"decode-ms\":%.3f,\"scale-dither-ms\":%.3f,\"driver-ms\":%.3f,\"peak-rss-kb\":%ld}\n", configs[i].driver, configs[i].resolution, configs[i].mode, j >= 0 ? files[j] : "generated", pages, pages / total, bytes / total / 1048576.0, 1000.0 * decode / pages, 1000.0 * scale_dither / pages, 1000.0 * driver / pages, (long)usage_info.ru_maxrss);
+      fflush(stdout);
+    }
+  }
+
+  papplSystemDelete(system);
+
+  return (status);
+}
+
+
+//
+// 'bench_driver_cb()' - Set up a PWG driver with timed raster callbacks.
+//
+
+static bool				// O - `true` on success, `false` on failure
+bench_driver_cb(
+    pappl_system_t         *system,	// I - System
+    const char             *driver_name,// I - Driver name
+    const char             *device_uri,	// I - Device URI
+    const char             *device_id,	// I - IEEE-1284 device ID string
+    pappl_pr_driver_data_t *driver_data,// O - Driver data
+    ipp_t                  **driver_attrs,
+					// O - Driver attributes
+    void                   *data)	// I - Callback data
+{
+  if (!pwg_callback(system, driver_name, device_uri, device_id, driver_data, driver_attrs, data))
+    return (false);
+
+  // The PWG driver uses the same raster callbacks for all models...
+  pwg_rendjob    = driver_data->rendjob_cb;
+  pwg_rendpage   = driver_data->rendpage_cb;
+  pwg_rstartjob  = driver_data->rstartjob_cb;
+  pwg_rstartpage = driver_data->rstartpage_cb;
+  pwg_rwriteline = driver_data->rwriteline_cb;
+
+  driver_data->rendjob_cb    = bench_rendjob;
+  driver_data->rendpage_cb   = bench_rendpage;
+  driver_data->rstartjob_cb  = bench_rstartjob;
+  driver_data->rstartpage_cb = bench_rstartpage;
+  driver_data->rwriteline_cb = bench_rwriteline;
+
+  return (true);
+}
+
+
+//
+// 'bench_filter_cb()' - Time the decoding and rasterization of a job.
+//
+
+static bool				// O - `true` on success, `false` on failure
+bench_filter_cb(
+    pappl_job_t    *job,		// I - Job
+    pappl_device_t *device,		// I - Device
+    void           *data)		// I - Filter data (unused)
+{
+  bool	ret = false;			// Return value
+
+
+  (void)data;
+
+  bench.filter_start = get_time();
+
+  if (!bench.filename)
+    ret = generate_page(job, device);
+#ifdef HAVE_LIBJPEG
+  else if (!strcmp(bench.format, "image/jpeg"))
+    ret = _papplJobFilterJPEG(job, device, NULL);
+#endif // HAVE_LIBJPEG
+#ifdef HAVE_LIBPNG
+  else if (!strcmp(bench.format, "image/png"))
+    ret = _papplJobFilterPNG(job, device, NULL);
+#endif // HAVE_LIBPNG
+
+  bench.filter_end = get_time();
+
+  return (ret);
+}
+
+
+//
+// 'bench_rendjob()' - End a job.
+//
+
+static bool				// O - `true` on success, `false` on failure
+bench_rendjob(
+    pappl_job_t        *job,		// I - Job
+    pappl_pr_options_t *options,	// I - Job options
+    pappl_device_t     *device)		// I - Print device
+{
+  double	start = get_time();	// Start time
+  bool		ret = (pwg_rendjob)(job, options, device);
+					// Return value
+
+
+  bench.driver += get_time() - start;
+
+  return (ret);
+}
+
+
+//
+// 'bench_rendpage()' - End a page.
+//
+
+static bool				// O - `true` on success, `false` on failure
+bench_rendpage(
+    pappl_job_t        *job,		// I - Job
+    pappl_pr_options_t *options,	// I - Job options
+    pappl_device_t     *device,		// I - Print device
+    unsigned           page)		// I - Page number
+{
+  double	start = get_time();	// Start time
+  bool		ret = (pwg_rendpage)(job, options, device, page);
+					// Return value
+
+
+  bench.driver += get_time() - start;
+  bench.pages ++;
+
+  return (ret);
+}
+
+
+//
+// 'bench_rstartjob()' - Start a job.
+//
+
+static bool				// O - `true` on success, `false` on failure
+bench_rstartjob(
+    pappl_job_t        *job,		// I - Job
+    pappl_pr_options_t *options,	// I - Job options
+    pappl_device_t     *device)		// I - Print device
+{
+  double	start = get_time();	// Start time
+  bool		ret = (pwg_rstartjob)(job, options, device);
+					// Return value
+
+
+  bench.raster_start = start;
+  bench.driver       += get_time() - start;
+
+  return (ret);
+}
+
+
+//
+// 'bench_rstartpage()' - Start a page.
+//
+
+static bool				// O - `true` on success, `false` on failure
+bench_rstartpage(
+    pappl_job_t        *job,		// I - Job
+    pappl_pr_options_t *options,	// I - Job options
+    pappl_device_t     *device,		// I - Print device
+    unsigned           page)		// I - Page number
+{
+  double	start = get_time();	// Start time
+  bool		ret = (pwg_rstartpage)(job, options, device, page);
+					// Return value
+
+
+  bench.driver += get_time() - start;
+
+  return (ret);
+}
+
+
+//
+// 'bench_rwriteline()' - Write a raster line.
+//
+
+static bool				// O - `true` on success, `false` on failure
+bench_rwriteline(
+    pappl_job_t         *job,		// I - Job
+    pappl_pr_options_t  *options,	// I - Job options
+    pappl_device_t      *device,	// I - Print device
+    unsigned            y,		// I - Line number
+    const unsigned char *line)		// I - Line
+{
+  double	start = get_time();	// Start time
+  bool		ret = (pwg_rwriteline)(job, options, device, y, line);
+					// Return value
+
+
+  bench.driver += get_time() - start;
+  bench.bytes  += options->header.cupsBytesPerLine;
+
+  return (ret);
+}
+
+
+//
+// 'generate_page()' - Generate a test image and print it.
+//
+// The image is generated at half the printer resolution so that the scaling
+// code is exercised along with dithering.
+//
+
+static bool				// O - `true` on success, `false` on failure
+generate_page(pappl_job_t    *job,	// I - Job
+              pappl_device_t *device)	// I - Device
+{
+  bool			ret;		// Return value
+  pappl_pr_options_t	*options;	// Job options
+  unsigned char		*pixels,	// Image pixels
+			*pixptr;	// Pointer into image
+  int			x, y,		// Current position
+			width,		// Width of image
+			height,		// Height of image
+			depth,		// Bytes per pixel
+			ppi;		// Pixels per inch
+
+
+  options = papplJobCreatePrintOptions(job, 1, true);
+
+  ppi    = options->printer_resolution[0] / 2;
+  width  = (int)options->header.cupsWidth / 2;
+  height = (int)options->header.cupsHeight / 2;
+  depth  = options->header.cupsNumColors == 1 ? 1 : 3;
+
+  if ((pixels = malloc((size_t)(width * height * depth))) == NULL)
+  {
+    papplLogJob(job, PAPPL_LOGLEVEL_ERROR, "Unable to allocate memory for %dx%dx%d image.", width, height, depth);
+    papplJobDeletePrintOptions(options);
+    return (false);
+  }
+
+  // Draw horizontal and vertical gradients with a grid every half inch...
+  for (y = 0, pixptr = pixels; y < height; y ++)
+  {
+    for (x = 0; x < width; x ++)
+    {
+      if (((x * 2) % ppi) < 2 || ((y * 2) % ppi) < 2)
+      {
+        memset(pixptr, 0, (size_t)depth);
+        pixptr += depth;
+      }
+      else if (depth == 1)
+      {
+        *pixptr++ = (unsigned char)(255 * (x + y) / (width + height));
+      }
+      else
+      {
+        *pixptr++ = (unsigned char)(255 * x / width);
+        *pixptr++ = (unsigned char)(255 * y / height);
+        *pixptr++ = (unsigned char)(255 - 255 * (x + y) / (width + height));
+      }
+    }
+  }
+
+  ret = papplJobFilterImage(job, device, options, pixels, width, height, depth, ppi, true);
+
+  free(pixels);
+  papplJobDeletePrintOptions(options);
+
+  return (ret);
+}
+
+
+//
+// 'get_time()' - Get the current time in seconds.
+//
+
+static double				// O - Time in seconds
+get_time(void)
+{
+  struct timeval	curtime;	// Current time
+
+
+  gettimeofday(&curtime, NULL);
+
+  return (curtime.tv_sec + 0.000001 * curtime.tv_usec);
+}
+
+
+//
+// 'usage()' - Show usage.
+//
+
+static int				// O - Exit status
+usage(int status)			// I - Exit status
+{
+  puts("Usage: testraster [OPTIONS] [FILENAME(S)]");
+  puts("Options:");
+  puts("  --help               Show help");
+  puts("  -l LOG-FILE          Set the log file (default none)");
+  puts("  -L LOG-LEVEL         Set the log level (fatal, error, warn, info, debug)");
+  puts("  -n COUNT             Number of pages per driver and file (default 3)");
+
+  return (status);
+}
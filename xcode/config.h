@@ -53,3 +53,8 @@
 #define HAVE_ARC4RANDOM 1
 /* #undef HAVE_GETRANDOM */
 /* #undef HAVE_GNUTLS_RND */
+
+
+// Tracing support
+#define HAVE_TRACING 1
+/* #undef HAVE_SYS_SDT_H */